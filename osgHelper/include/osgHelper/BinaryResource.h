@@ -1,7 +1,11 @@
 #pragma once
 
+#include <osgHelper/ResourceData.h>
+
 #include <osg/Object>
 
+#include <cstddef>
+
 namespace osgHelper
 {
 	class BinaryResource : public osg::Object
@@ -15,10 +19,21 @@ namespace osgHelper
 		const char* libraryName() const override;
 		const char* className() const override;
 
-		char* getBytes() const;
-    void  setBytes(char* bytes);
+		const char* getBytes() const;
+		std::size_t getSize() const;
+
+		/**
+		 * Takes ownership of a buffer that was allocated with new[]
+		 */
+    void setBytes(char* bytes, std::size_t size = 0);
+
+		/**
+		 * Shares the data, e.g. a memory-mapped file, without copying it
+		 */
+		void                       setData(const osg::ref_ptr<ResourceData>& data);
+		osg::ref_ptr<ResourceData> getData() const;
 		
 	private:
-		char* m_bytes;
+		osg::ref_ptr<ResourceData> m_data;
 	};
-}
\ No newline at end of file
+}
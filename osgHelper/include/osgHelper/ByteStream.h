@@ -1,30 +1,211 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#include <osg/ref_ptr>
 
 namespace osgHelper
 {
+	class BinaryResource;
+	class ResourceChunkReader;
+
+	/**
+	 * Sequential reader over a block of bytes. If the size is known, reads past the end throw a GameException in
+	 * debug builds, release builds (NDEBUG) read unchecked.
+	 *
+	 * Over a ResourceChunkReader, the stream pulls chunks as it goes and reads are always checked. Values that span
+	 * chunk boundaries are assembled in a small buffer, arrays are copied chunk by chunk, so memory use stays bounded
+	 * by the chunk size and the largest single value. Views returned by readStringView() are only valid until the
+	 * next read.
+	 *
+	 * Streams can be moved but not copied, the position in a ResourceChunkReader cannot be shared.
+	 */
 	class ByteStream
 	{
 	public:
-		ByteStream(char* data);
+		/**
+		 * Reads without knowing the size, so no bounds checks are possible
+		 */
+		ByteStream(const char* data);
+		ByteStream(const char* data, std::size_t size);
+		ByteStream(const BinaryResource& resource);
+		ByteStream(const osg::ref_ptr<ResourceChunkReader>& chunkReader);
+		~ByteStream();
+
+		ByteStream(const ByteStream&)            = delete;
+		ByteStream& operator=(const ByteStream&) = delete;
+
+		ByteStream(ByteStream&& other) noexcept;
+		ByteStream& operator=(ByteStream&& other) noexcept;
 
 		template <class T>
 		T read()
 		{
+			checkRange(sizeof(T));
+
 			T v;
-			memcpy(&v, &m_data[m_pos], sizeof(T));
+			std::memcpy(&v, &m_data[m_pos], sizeof(T));
 			m_pos += sizeof(T);
 
 			return v;
 		}
 
+		/**
+		 * Reads a value that is stored in the opposite byte order of the host
+		 */
+		template <class T>
+		T readSwapped()
+		{
+			auto v = read<T>();
+			swapBytes(&v, 1, sizeof(typename ScalarType<T>::type));
+
+			return v;
+		}
+
+		/**
+		 * Reads count elements with a single copy
+		 */
+		template <class T>
+		void readArray(T* out, std::size_t count)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+			const auto size = count * sizeof(T);
+			if (m_chunks && (size > m_size - m_pos))
+			{
+				readChunked(out, size);
+				return;
+			}
+
+			checkRange(size);
+
+			if (size > 0)
+			{
+				std::memcpy(out, &m_data[m_pos], size);
+			}
+
+			m_pos += size;
+		}
+
+		/**
+		 * Reads count elements that are stored in the opposite byte order of the host. For compound types, like
+		 * osg::Vec3f, the bytes of each component (T::value_type) are swapped.
+		 */
+		template <class T>
+		void readArraySwapped(T* out, std::size_t count)
+		{
+			readArray(out, count);
+			swapBytes(out, count * sizeof(T) / sizeof(typename ScalarType<T>::type),
+				sizeof(typename ScalarType<T>::type));
+		}
+
+		/**
+		 * Resizes a contiguous container, e.g. std::vector or osg::Vec3Array, to count elements and reads them
+		 */
+		template <class Container>
+		void readInto(Container& container, std::size_t count)
+		{
+			container.resize(count);
+			if (count > 0)
+			{
+				readArray(&container[0], count);
+			}
+		}
+
+		template <class Container>
+		void readIntoSwapped(Container& container, std::size_t count)
+		{
+			container.resize(count);
+			if (count > 0)
+			{
+				readArraySwapped(&container[0], count);
+			}
+		}
+
+		/**
+		 * Reads an unsigned LEB128 variable-length integer
+		 */
+		std::uint64_t readVarUInt();
+
+		/**
+		 * Reads a zigzag-encoded signed variable-length integer
+		 */
+		std::int64_t readVarInt();
+
+		/**
+		 * Swaps the byte order of count consecutive scalars of the given width (1, 2, 4 or 8 bytes) in place
+		 */
+		static void swapBytes(void* data, std::size_t count, std::size_t width);
+
+		/**
+		 * @return A null-terminated copy that has to be deleted with delete[] by the caller,
+		 *         prefer readStringView()
+		 */
 		char* readString(int size);
 
-		int getPos() const;
+		/**
+		 * @return A view of the next size bytes without copying them, only valid as long as the data is
+		 */
+		std::string_view readStringView(std::size_t size);
+
+		void skip(std::size_t size);
+
+		int         getPos() const;
+		std::size_t getSize() const;
+		std::size_t getRemaining() const;
+		bool        isEnd() const;
 
 	private:
-		char* m_data;
-		int   m_pos;
+		template <class T, class Enable = void>
+		struct ScalarType
+		{
+			using type = typename T::value_type;
+		};
+
+		template <class T>
+		struct ScalarType<T, typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type>
+		{
+			using type = T;
+		};
+
+		struct ChunkState;
+
+		static const std::size_t UnknownSize = std::numeric_limits<std::size_t>::max();
+
+		// the window of bytes that can be read directly, the whole data unless reading chunks
+		const char* m_data;
+		std::size_t m_size;
+		std::size_t m_pos;
+
+		std::size_t                 m_windowOffset;
+		std::size_t                 m_totalSize;
+		std::unique_ptr<ChunkState> m_chunks;
+
+		void checkRange(std::size_t size)
+		{
+#ifdef NDEBUG
+			if (!m_chunks)
+			{
+				return;
+			}
+#endif
+			if (size > m_size - m_pos)
+			{
+				fillWindow(size);
+			}
+		}
+
+		void fillWindow(std::size_t size);
+		bool nextChunk();
+		void readChunked(void* out, std::size_t size);
+
+		[[noreturn]] void throwOutOfRange(std::size_t size) const;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <osg/Image>
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include <memory>
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Disk cache of decoded images, so that PNG or JPEG files are only decoded once. Each entry is a raw pixel
+ * dump with the image layout in a small header and the pixels at a page-aligned offset, keyed by the source
+ * path, modification time and size. Cached images are memory-mapped instead of read.
+ *
+ * The pixels of cached images are mapped copy-on-write, so they can be modified on the CPU like those of
+ * decoded images. Modified pages are copied privately, the entry on disk stays unchanged. Thread-safe.
+ */
+class DecodedImageCache : public osg::Referenced
+{
+public:
+  /**
+   * Creates the directory if it does not exist, throws a GameException if that fails
+   */
+  explicit DecodedImageCache(const std::string& directory);
+  ~DecodedImageCache() override;
+
+  const std::string& getDirectory() const;
+
+  /**
+   * @return The cached image of the source file, nullptr if it is not cached or the source file has changed
+   */
+  osg::ref_ptr<osg::Image> read(const std::string& sourceFilename) const;
+
+  /**
+   * Stores the decoded image of a source file, replacing the entry atomically.
+   * Throws a GameException if the entry can not be written.
+   */
+  void write(const std::string& sourceFilename, const osg::Image& image) const;
+
+  /**
+   * Removes all entries
+   */
+  void clear();
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
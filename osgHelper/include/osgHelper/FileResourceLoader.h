@@ -8,6 +8,8 @@ namespace osgHelper
 	{
 	public:
     void getResourceStream(const std::string& resourceKey, std::ifstream& stream, long long& length) override;
+    bool hasResource(const std::string& resourceKey) override;
+    std::string getResourceFilename(const std::string& resourceKey) override;
 
 	};
 }
\ No newline at end of file
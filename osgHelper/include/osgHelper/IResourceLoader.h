@@ -1,5 +1,8 @@
 #pragma once
 
+#include <osgHelper/ResourceChunkReader.h>
+#include <osgHelper/ResourceData.h>
+
 #include <string>
 #include <fstream>
 
@@ -11,5 +14,38 @@ namespace osgHelper
 	{
 	public:
 		virtual void getResourceStream(const std::string& resourceKey, std::ifstream& stream, long long& length) = 0;
+
+		/**
+		 * Returns all bytes of a resource, decompressed if isCompressedResource(). The default implementation
+		 * reads them from getResourceStream() into a heap buffer and decompresses them on the fly, loaders that
+		 * can provide the bytes without copying should override it.
+		 */
+		virtual osg::ref_ptr<ResourceData> getResourceData(const std::string& resourceKey);
+
+		/**
+		 * Returns whether the resource exists. The default implementation tries to open it with
+		 * getResourceStream(), loaders that can tell without opening the resource should override it.
+		 */
+		virtual bool hasResource(const std::string& resourceKey);
+
+		/**
+		 * Returns whether the resource is stored compressed with ResourceCodec. The default implementation
+		 * checks for the key extension ResourceCodec::Extension, the bytes of other resources are never decoded.
+		 */
+		virtual bool isCompressedResource(const std::string& resourceKey);
+
+		/**
+		 * Returns the file a resource is read from, e.g. to watch it for changes, or an empty string if the
+		 * resource is not stored in a file of its own. The default implementation returns an empty string.
+		 */
+		virtual std::string getResourceFilename(const std::string& resourceKey);
+
+		/**
+		 * Opens a resource to read it incrementally in chunks, see ResourceChunkReader. The default
+		 * implementation reads the chunks from getResourceStream().
+		 */
+		virtual osg::ref_ptr<ResourceChunkReader> openResourceChunks(const std::string& resourceKey,
+			std::size_t chunkSize = ResourceChunkReader::DefaultChunkSize,
+			unsigned int numReadAheadChunks = ResourceChunkReader::DefaultNumReadAheadChunks);
 	};
-}
\ No newline at end of file
+}
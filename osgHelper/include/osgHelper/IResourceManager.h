@@ -1,12 +1,15 @@
 #pragma once
 
+#include <osgHelper/BinaryResource.h>
 #include <osgHelper/IResourceLoader.h>
+#include <osgHelper/ResourceKey.h>
 
 #include <osg/Referenced>
 #include <osg/Image>
 #include <osg/Shader>
 #include <osgText/Font>
 
+#include <future>
 #include <string>
 
 namespace osgHelper
@@ -18,15 +21,28 @@ public:
   IResourceManager() = default;
   virtual ~IResourceManager() = default;
 
-  virtual std::string                 loadText(const std::string& resourceKey) = 0;
-  virtual char*                       loadBinary(const std::string& resourceKey) = 0;
-  virtual osg::ref_ptr<osg::Image>    loadImage(const std::string& resourceKey) = 0;
-  virtual osg::ref_ptr<osgText::Font> loadFont(const std::string& resourceKey) = 0;
-  virtual osg::ref_ptr<osg::Shader>   loadShader(const std::string& resourceKey, osg::Shader::Type type) = 0;
+  /**
+   * The load functions throw a GameException if the resource cannot be read. loadImage() and loadFont()
+   * also throw if no reader writer exists for the extension of the resource key.
+   *
+   * Only callers that keep a ResourceKey and pass it on each call save lower-casing, hashing and copying
+   * the name per lookup. Strings are implicitly converted to a temporary ResourceKey.
+   */
+  virtual std::string                  loadText(const ResourceKey& resourceKey) = 0;
+  virtual osg::ref_ptr<BinaryResource> loadBinary(const ResourceKey& resourceKey) = 0;
+  virtual osg::ref_ptr<osg::Image>     loadImage(const ResourceKey& resourceKey) = 0;
+  virtual osg::ref_ptr<osgText::Font>  loadFont(const ResourceKey& resourceKey) = 0;
+  virtual osg::ref_ptr<osg::Shader>    loadShader(const ResourceKey& resourceKey, osg::Shader::Type type) = 0;
+
+  virtual std::future<std::string>                 loadTextAsync(const ResourceKey& resourceKey) = 0;
+  virtual std::future<osg::ref_ptr<osg::Image>>    loadImageAsync(const ResourceKey& resourceKey) = 0;
+  virtual std::future<osg::ref_ptr<osgText::Font>> loadFontAsync(const ResourceKey& resourceKey) = 0;
+  virtual std::future<osg::ref_ptr<osg::Shader>>   loadShaderAsync(const ResourceKey& resourceKey,
+                                                                   osg::Shader::Type type) = 0;
 
   virtual void setResourceLoader(const osg::ref_ptr<IResourceLoader>& loader) = 0;
 
-  virtual void clearCacheResource(const std::string& resourceKey) = 0;
+  virtual void clearCacheResource(const ResourceKey& resourceKey) = 0;
   virtual void clearCache() = 0;
 
 };
@@ -17,6 +17,11 @@ public:
   virtual osg::ref_ptr<IShaderBlueprint> extension(const std::string& extName) = 0;
   virtual osg::ref_ptr<IShaderBlueprint> module(const std::string& module) = 0;
 
+  /**
+   * Injects "#define name value" after the extensions, redefining a name replaces its value
+   */
+  virtual osg::ref_ptr<IShaderBlueprint> define(const std::string& name, const std::string& value = "") = 0;
+
   virtual osg::ref_ptr<osg::Shader> build() = 0;
 
 };
@@ -2,6 +2,7 @@
 
 #include <osgHelper/IShaderBlueprint.h>
 
+#include <osg/Program>
 #include <osg/Referenced>
 #include <osg/Shader>
 
@@ -15,8 +16,18 @@ public:
 	virtual ~IShaderFactory() = default;
 
 	virtual osg::ref_ptr<osg::Shader> fromSourceText(const std::string& key, const std::string& source, osg::Shader::Type type) = 0;
+	/**
+	 * Blueprints of factories that share shaders, e.g. ShaderFactory with a permutation cache, return the same
+	 * osg::Shader from build() for identical permutations. Shared shaders must not be modified.
+	 */
 	virtual osg::ref_ptr<IShaderBlueprint> make() const = 0;
 
+	/**
+	 * Called once all shaders are added to the program, lets the program use a cached binary instead of
+	 * compiling its shaders if program binaries are cached. Does nothing by default.
+	 */
+	virtual void prepareProgram(const osg::ref_ptr<osg::Program>&) {}
+
 };
 
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <osg/Image>
 #include <osg/Texture2D>
 
+#include <osgHelper/TextureProcessor.h>
+
 namespace osgHelper
 {
 
@@ -21,6 +23,8 @@ public:
   virtual osg::ref_ptr<ITextureBlueprint> uniform(const osg::ref_ptr<osg::StateSet>& stateSet, const std::string& uniformName) = 0;
   virtual osg::ref_ptr<ITextureBlueprint> minFilter(osg::Texture::FilterMode filterMode) = 0;
   virtual osg::ref_ptr<ITextureBlueprint> magFilter(osg::Texture::FilterMode filterMode) = 0;
+  virtual osg::ref_ptr<ITextureBlueprint> mipmaps(TextureProcessor::MipmapFilter filter) = 0;
+  virtual osg::ref_ptr<ITextureBlueprint> compression(TextureProcessor::Compression compression) = 0;
 
   virtual osg::ref_ptr<osg::Texture2D> build() const = 0;
 
@@ -4,6 +4,7 @@
 #include <osg/ref_ptr>
 
 #include <osgHelper/ITextureBlueprint.h>
+#include <osgHelper/TextureAtlas.h>
 
 namespace osgHelper
 {
@@ -15,6 +16,14 @@ public:
   virtual ~ITextureFactory() = default;
 
   virtual osg::ref_ptr<ITextureBlueprint> make() const = 0;
+
+  /**
+   * Creates a plain TextureAtlas by default
+   */
+  virtual osg::ref_ptr<TextureAtlas> makeAtlas(int pageSize, int border) const
+  {
+    return new TextureAtlas(pageSize, border);
+  }
 };
 
 }
\ No newline at end of file
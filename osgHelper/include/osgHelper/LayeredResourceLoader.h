@@ -0,0 +1,67 @@
+#pragma once
+
+#include <osgHelper/IResourceLoader.h>
+
+#include <memory>
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Serves resources from an ordered list of loaders, e.g. a mod directory over a patch pack over the
+ * base pack. Each resource is served by the first layer that has it.
+ *
+ * Misses are remembered per layer, so that looking up a resource that is only in a lower layer costs a
+ * hash probe per overlay layer instead of a file system query. Call clearNegativeCache() when resources
+ * are added to a layer at runtime, ResourceManager does so when it applies hot reloads. A layer forgets
+ * its misses when it would remember more than the maximum negative cache size.
+ *
+ * Add all layers before the loader is used, lookups are thread-safe.
+ */
+class LayeredResourceLoader : public IResourceLoader
+{
+public:
+  LayeredResourceLoader();
+  ~LayeredResourceLoader() override;
+
+  /**
+   * Adds a layer below all existing layers
+   * @param searchPath prepended to the resource keys looked up in this layer, e.g. "mods/mymod/"
+   */
+  void         addLayer(const osg::ref_ptr<IResourceLoader>& loader, const std::string& searchPath = "");
+  unsigned int getNumLayers() const;
+
+  void setNegativeCacheEnabled(bool enabled);
+  bool isNegativeCacheEnabled() const;
+  void clearNegativeCache();
+
+  /**
+   * @param size maximum number of misses remembered per layer
+   */
+  void        setMaxNegativeCacheSize(std::size_t size);
+  std::size_t getMaxNegativeCacheSize() const;
+
+  /**
+   * @return The index of the layer serving the resource, -1 if no layer has it
+   */
+  int findLayer(const std::string& resourceKey);
+
+  void                       getResourceStream(const std::string& resourceKey, std::ifstream& stream,
+                                               long long& length) override;
+  osg::ref_ptr<ResourceData> getResourceData(const std::string& resourceKey) override;
+  bool                       hasResource(const std::string& resourceKey) override;
+  bool                       isCompressedResource(const std::string& resourceKey) override;
+  std::string                getResourceFilename(const std::string& resourceKey) override;
+
+  osg::ref_ptr<ResourceChunkReader> openResourceChunks(const std::string& resourceKey,
+    std::size_t chunkSize = ResourceChunkReader::DefaultChunkSize,
+    unsigned int numReadAheadChunks = ResourceChunkReader::DefaultNumReadAheadChunks) override;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
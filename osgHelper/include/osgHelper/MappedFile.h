@@ -0,0 +1,48 @@
+#pragma once
+
+#include <osgHelper/ResourceData.h>
+
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Memory mapping of a whole file. The mapping is released when the last reference is gone.
+ */
+class MappedFile : public ResourceData
+{
+public:
+  enum class Access
+  {
+    ReadOnly,
+    CopyOnWrite //!< writes go to private copies of the touched pages, the file stays unchanged
+  };
+
+  /**
+   * Maps the file, throws a GameException if it can not be opened or mapped
+   */
+  explicit MappedFile(const std::string& filename, Access access = Access::ReadOnly);
+  ~MappedFile() override;
+
+  const char* getData() const override;
+  std::size_t getSize() const override;
+
+  /**
+   * @return The mapped bytes, nullptr if the file is mapped read-only
+   */
+  char* getWritableData();
+
+private:
+  char*       m_data;
+  std::size_t m_size;
+  Access      m_access;
+
+#ifdef WIN32
+  void* m_fileHandle;
+  void* m_mappingHandle;
+#endif
+
+};
+
+}
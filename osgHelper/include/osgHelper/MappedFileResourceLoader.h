@@ -0,0 +1,19 @@
+#pragma once
+
+#include <osgHelper/FileResourceLoader.h>
+
+namespace osgHelper
+{
+
+/**
+ * Serves resource files through read-only memory mappings instead of copying them into heap buffers.
+ * Compressed resources are decompressed from the mapping into a heap buffer.
+ */
+class MappedFileResourceLoader : public FileResourceLoader
+{
+public:
+  osg::ref_ptr<ResourceData> getResourceData(const std::string& resourceKey) override;
+
+};
+
+}
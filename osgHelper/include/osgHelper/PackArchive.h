@@ -0,0 +1,67 @@
+#pragma once
+
+#include <osgHelper/ResourceData.h>
+
+#include <osg/Referenced>
+
+#include <memory>
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Read access to a pack file, which bundles many resources in a single memory-mapped file.
+ *
+ * Layout (all integers little-endian):
+ *   header       magic "OSGHPACK", uint32 version, uint32 number of entries, uint64 size of the string table
+ *   index        per entry: uint64 data offset, uint64 data size, uint32 key offset, uint32 key length,
+ *                uint32 flags, sorted by key
+ *   string table the keys, lower case, '/' as path separator
+ *   data         the resource bytes, each blob aligned to PackArchive::Alignment
+ */
+class PackArchive : public osg::Referenced
+{
+public:
+  static const std::string  Magic;
+  static const unsigned int Version;
+  static const unsigned int Alignment;
+  static const unsigned int HeaderSize;
+  static const unsigned int IndexEntrySize;
+
+  static const unsigned int CompressedFlag; //!< the entry is compressed with ResourceCodec
+
+  /**
+   * Maps and validates the pack file, throws a GameException if it is not a valid pack file
+   */
+  explicit PackArchive(const std::string& filename);
+  ~PackArchive() override;
+
+  /**
+   * @return The bytes of the resource without copying them, nullptr if the pack does not contain it.
+   *         Compressed entries are decompressed into a heap buffer.
+   */
+  osg::ref_ptr<ResourceData> getResourceData(const std::string& resourceKey) const;
+
+  /**
+   * Looks up the position of a resource within the pack file
+   * @return false, if the pack does not contain the resource
+   */
+  bool find(const std::string& resourceKey, std::size_t& offset, std::size_t& size) const;
+  bool find(const std::string& resourceKey, std::size_t& offset, std::size_t& size, unsigned int& flags) const;
+
+  const std::string& getFilename() const;
+  unsigned int       getNumEntries() const;
+
+  /**
+   * Converts a resource key to the form that is stored in the index
+   */
+  static std::string normalizeKey(const std::string& resourceKey);
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
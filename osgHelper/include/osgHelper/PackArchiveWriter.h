@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osgHelper
+{
+
+/**
+ * Builds a pack file that can be read with PackArchive
+ */
+class PackArchiveWriter
+{
+public:
+  PackArchiveWriter();
+  ~PackArchiveWriter();
+
+  void addData(const std::string& resourceKey, const std::vector<char>& data);
+  void addFile(const std::string& resourceKey, const std::string& filename);
+
+  /**
+   * Adds all files of a directory recursively. The keys are the paths relative to the directory,
+   * prepended with the key prefix, e.g. "resources/".
+   */
+  void addDirectory(const std::string& directory, const std::string& keyPrefix = "");
+
+  unsigned int getNumEntries() const;
+
+  /**
+   * Compresses the resources with ResourceCodec when writing, if that makes them smaller. Compressed
+   * entries are flagged in the index, PackArchive decompresses them transparently.
+   */
+  void setCompressionEnabled(bool enabled);
+  bool isCompressionEnabled() const;
+
+  /**
+   * Writes the pack file, throws a GameException on failure
+   */
+  void write(const std::string& filename) const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <osgHelper/IResourceLoader.h>
+#include <osgHelper/PackArchive.h>
+
+namespace osgHelper
+{
+
+/**
+ * Serves resources from a pack file built with PackArchiveWriter. Lookups are binary searches in the
+ * prebuilt index, the resource bytes are handed out as views of the mapped pack file.
+ */
+class PackResourceLoader : public IResourceLoader
+{
+public:
+  explicit PackResourceLoader(const std::string& packFilename);
+  ~PackResourceLoader() override;
+
+  void getResourceStream(const std::string& resourceKey, std::ifstream& stream, long long& length) override;
+  osg::ref_ptr<ResourceData> getResourceData(const std::string& resourceKey) override;
+  bool                       hasResource(const std::string& resourceKey) override;
+  bool                       isCompressedResource(const std::string& resourceKey) override;
+
+  osg::ref_ptr<PackArchive> getArchive() const;
+
+private:
+  osg::ref_ptr<PackArchive> m_archive;
+
+};
+
+}
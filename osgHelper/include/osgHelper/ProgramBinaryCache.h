@@ -0,0 +1,95 @@
+#pragma once
+
+#include <osg/Camera>
+#include <osg/Program>
+#include <osg/Referenced>
+#include <osg/State>
+#include <osg/ref_ptr>
+
+#include <memory>
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Disk cache of linked GL program binaries (GL_ARB_get_program_binary), so that programs are only compiled
+ * from source once per driver. Entries are keyed by the types and sources of the attached shaders and the
+ * driver string (vendor, renderer and version).
+ *
+ * Programs passed to prepare() get their cached binary set. Their state is checked by processPrograms() in the
+ * draw thread, the draw callback of createDrawCallback() does that after each frame: binaries of programs
+ * that were compiled from source are stored, rejected binaries are removed and their programs fall back
+ * to the source compile.
+ *
+ * The driver string is only known with a current context, until then the one of the previous run is used.
+ * Thread-safe.
+ */
+class ProgramBinaryCache : public osg::Referenced
+{
+public:
+  struct Statistics
+  {
+    unsigned long long numLoaded   = 0; //!< binaries set on prepared programs
+    unsigned long long numStored   = 0; //!< binaries of programs compiled from source
+    unsigned long long numRejected = 0; //!< binaries the driver failed to link
+  };
+
+  /**
+   * Creates the directory if it does not exist, throws a GameException if that fails
+   */
+  explicit ProgramBinaryCache(const std::string& directory);
+  ~ProgramBinaryCache() override;
+
+  const std::string& getDirectory() const;
+
+  /**
+   * Sets the driver string binaries are read and written for and remembers it for the next run.
+   * Called by processPrograms() with the string of the current context.
+   */
+  void        setDriverString(const std::string& driverString);
+  std::string getDriverString() const;
+
+  /**
+   * Sets the cached binary on the program if there is one and tracks the program until processPrograms()
+   * has seen it linked. Shaders must not be added or changed afterwards.
+   *
+   * @return true if a cached binary was set
+   */
+  bool prepare(const osg::ref_ptr<osg::Program>& program);
+
+  /**
+   * @return The cached binary of the program's shaders, nullptr if there is none for the current driver string
+   */
+  osg::ref_ptr<osg::Program::ProgramBinary> read(const osg::Program& program) const;
+
+  /**
+   * Stores the binary of the program's shaders, replacing the entry atomically.
+   * Throws a GameException if the entry can not be written.
+   */
+  void write(const osg::Program& program, const osg::Program::ProgramBinary& binary) const;
+
+  /**
+   * Must be called in the draw thread with the context of the state current
+   */
+  void processPrograms(osg::State& state);
+
+  /**
+   * @return A final draw callback of the camera that renders the prepared programs, calls processPrograms()
+   */
+  osg::ref_ptr<osg::Camera::DrawCallback> createDrawCallback();
+
+  Statistics getStatistics() const;
+
+  /**
+   * Removes all entries
+   */
+  void clear();
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <osg/Referenced>
+#include <osg/Texture2D>
+#include <osg/Vec2i>
+#include <osg/ref_ptr>
+
+#include <cstddef>
+#include <memory>
+
+namespace osgHelper
+{
+
+/**
+ * Recycles render target textures, keyed by size, internal format and filter, so that recreating the render
+ * textures of cameras on resize or when slave cameras come and go does not allocate new textures each time.
+ *
+ * Sizes are rounded up to a multiple of the size granularity. With a granularity of 1 (the default) textures
+ * have exactly the requested size. Larger granularities let continuous resizes share the same textures, but
+ * then textures might be larger than the requested size and only the lower left part of them is rendered to.
+ *
+ * A released texture is only handed out again once the pool holds its last reference, i.e. once no state set
+ * or camera uses it anymore. Textures in use are referenced by the pool until they are released. Released textures
+ * are kept up to a maximum per key and a maximum in total, beyond which those of the least recently used key are
+ * dropped first. Thread-safe.
+ */
+class RenderTargetPool : public osg::Referenced
+{
+public:
+  struct Statistics
+  {
+    unsigned long long numAcquires    = 0;
+    unsigned long long numAllocations = 0;
+    unsigned long long numReuses      = 0; //!< Allocations avoided by recycling a released texture
+    std::size_t        numInUse       = 0;
+    std::size_t        numFree        = 0;
+  };
+
+  explicit RenderTargetPool(int sizeGranularity = 1, std::size_t maxFreePerKey = 4, std::size_t maxNumFree = 16);
+  ~RenderTargetPool() override;
+
+  void setSizeGranularity(int granularity);
+  int  getSizeGranularity() const;
+
+  /**
+   * @return The size the textures acquired for the requested size have
+   */
+  osg::Vec2i getBucketSize(const osg::Vec2i& size) const;
+
+  /**
+   * @return A released texture with the key of the arguments, or a new one
+   */
+  osg::ref_ptr<osg::Texture2D> acquire(const osg::Vec2i& size, GLint internalFormat, osg::Texture::FilterMode filter);
+
+  /**
+   * Hands a texture acquired from this pool back. Textures not acquired from this pool are ignored, textures
+   * that were resized in the meantime are dropped.
+   */
+  void release(const osg::ref_ptr<osg::Texture2D>& texture);
+
+  Statistics getStatistics() const;
+  void       resetStatistics();
+
+  /**
+   * Drops the released textures of sizes that no texture in use has, e.g. once a resize settled
+   */
+  void clearUnusedSizes();
+
+  //! Drops all released textures
+  void clear();
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
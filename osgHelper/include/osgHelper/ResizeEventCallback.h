@@ -2,6 +2,8 @@
 
 #include <functional>
 
+#include <osg/Vec2i>
+
 #include <osgGA/GUIEventHandler>
 
 namespace osgHelper
@@ -12,13 +14,54 @@ class ResizeEventHandler : public osgGA::GUIEventHandler
 public:
   using CallbackFunc = std::function<bool(int, int)>;
 
-  explicit ResizeEventHandler(const CallbackFunc& func);
+  //! Determines when the callback is called for RESIZE events
+  enum class Mode
+  {
+    Immediate, //!< on every RESIZE event
+    PerFrame,  //!< at most once per frame, with the latest size
+    Debounced  //!< once the size did not change for the quiet period, checked every frame
+  };
+
+  struct Statistics
+  {
+    unsigned long long numResizeEvents = 0;
+    unsigned long long numCallbacks    = 0;
+  };
+
+  /**
+   * @param quietPeriod Seconds without RESIZE events after which the callback is called in Mode::Debounced
+   */
+  explicit ResizeEventHandler(const CallbackFunc& func, Mode mode = Mode::Immediate, double quietPeriod = 0.2);
   ~ResizeEventHandler() override;
 
+  /**
+   * Called on every RESIZE event whose callback is deferred, e.g. with View::scaleRenderTargets() to stretch the
+   * existing render targets over the new size until the callback rebuilds them
+   */
+  void setPendingResizeCallback(const CallbackFunc& func);
+
+  bool hasPendingResize() const;
+
+  //! Calls the callback right away if a resize is pending
+  bool flush();
+
+  const Statistics& getStatistics() const;
+
   bool handle(const osgGA::GUIEventAdapter& ea, osgGA::GUIActionAdapter& aa) override;
 
 private:
   CallbackFunc m_func;
+  CallbackFunc m_pendingFunc;
+  Mode         m_mode;
+  double       m_quietPeriod;
+
+  bool       m_hasPendingResize;
+  osg::Vec2i m_pendingSize;
+  double     m_lastResizeTime;
+
+  Statistics m_statistics;
+
+  bool callFunc(int width, int height);
 
 };
 
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <osgHelper/ResourceKey.h>
+
+#include <osg/Object>
+#include <osg/ref_ptr>
+
+#include <cstddef>
+#include <memory>
+
+namespace osgHelper
+{
+
+/**
+ * A thread-safe dictionary of cached resources, keys are compared case-insensitively. Keys are distributed
+ * over a fixed number of shards by their hash, each shard is a hash table guarded by its own reader-writer
+ * lock, so that concurrent lookups of different keys rarely block each other.
+ *
+ * Optionally, the cache can be limited to a memory budget. When it is exceeded, resources are evicted
+ * in CLOCK order (an approximation of LRU). Resources that are still referenced outside of the cache
+ * are never evicted.
+ */
+class ResourceCache
+{
+public:
+  struct Statistics
+  {
+    unsigned long long numLookups     = 0;
+    unsigned long long numHits        = 0;
+    unsigned long long numMisses      = 0;
+    unsigned long long numStores      = 0;
+    unsigned long long numEvictions   = 0;
+    unsigned long long numContentions = 0; //!< lock acquisitions that had to wait for another thread
+    std::size_t        numBytes       = 0; //!< estimated payload size of all cached resources
+
+    double getHitRatio() const
+    {
+      return (numLookups > 0) ? static_cast<double>(numHits) / static_cast<double>(numLookups) : 0.0;
+    }
+  };
+
+  explicit ResourceCache(unsigned int numShards = 16);
+  ~ResourceCache();
+
+  osg::ref_ptr<osg::Object> get(const ResourceKey& key) const;
+
+  /**
+   * Stores the object, if the key is not cached yet
+   * @return The object that is cached for the key after the call
+   */
+  osg::ref_ptr<osg::Object> store(const ResourceKey& key, const osg::ref_ptr<osg::Object>& obj);
+
+  /**
+   * Replaces the object that is cached for the key, in one step so that concurrent lookups never miss it
+   * @return false, if the key is not cached
+   */
+  bool replace(const ResourceKey& key, const osg::ref_ptr<osg::Object>& obj);
+
+  bool remove(const ResourceKey& key);
+  void clear();
+
+  /**
+   * Limits the estimated payload size of all cached resources
+   * @param bytes the memory budget, 0 disables the limit
+   */
+  void        setMemoryBudget(std::size_t bytes);
+  std::size_t getMemoryBudget() const;
+
+  unsigned int getNumShards() const;
+  Statistics   getStatistics() const;
+  void         resetStatistics();
+
+  /**
+   * @return The payload size of images, text, binary and shader resources, 0 for other types
+   */
+  static std::size_t estimateSize(const osg::Object* obj);
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <osgHelper/ResourceData.h>
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+
+namespace osgHelper
+{
+
+/**
+ * Pulls a resource in chunks of bounded size, so that very large resources, e.g. terrain or point data,
+ * can be processed incrementally with a memory use that does not depend on the resource size. Open it with
+ * IResourceLoader::openResourceChunks() and wrap it into a ByteStream to read values across chunk boundaries.
+ *
+ * A background thread reads up to numReadAheadChunks chunks ahead of the consumer, so at most
+ * numReadAheadChunks + 2 chunks are held at a time. Compressed resources, see IResourceLoader::isCompressedResource(),
+ * are decompressed block by block, one chunk per block, regardless of the requested chunk size.
+ *
+ * Chunks have to be read from one thread.
+ */
+class ResourceChunkReader : public osg::Referenced
+{
+public:
+  static const std::size_t  DefaultChunkSize;
+  static const unsigned int DefaultNumReadAheadChunks;
+
+  /**
+   * @param stream             positioned at the first byte of the resource
+   * @param size               size of the resource in the stream
+   * @param numReadAheadChunks 0 reads each chunk synchronously in readChunk()
+   * @param isCompressed       whether the resource is compressed with ResourceCodec
+   */
+  ResourceChunkReader(std::unique_ptr<std::istream> stream, std::size_t size,
+                      std::size_t chunkSize = DefaultChunkSize,
+                      unsigned int numReadAheadChunks = DefaultNumReadAheadChunks,
+                      bool isCompressed = false);
+  ~ResourceChunkReader() override;
+
+  /**
+   * Blocks until the next chunk has been read. Throws a GameException if the resource could not be read.
+   * @return The next chunk, nullptr after the last one
+   */
+  osg::ref_ptr<ResourceData> readChunk();
+
+  /**
+   * @return The size of the resource after decompression
+   */
+  std::size_t getSize() const;
+  std::size_t getChunkSize() const;
+  bool        isCompressed() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <osgHelper/ResourceData.h>
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace osgHelper
+{
+
+/**
+ * Built-in LZ77 block codec (LZ4-style sequences) for compressed resources. Resources are only decoded if
+ * they opt in, either by the key extension ResourceCodec::Extension, e.g. "shaders/light.frag.ohz", or by
+ * the compressed flag of a pack entry. The resource loaders then decompress them transparently.
+ *
+ * Layout (all integers little-endian):
+ *   header  magic "OHZ1", uint32 block size, uint64 decompressed size
+ *   blocks  per block: uint32 compressed size (bit 31 set if the block is stored uncompressed), the block bytes
+ *
+ * Blocks are independent of each other, so a stream only has to hold one compressed block at a time.
+ */
+class ResourceCodec
+{
+public:
+  static const std::string Extension;
+  static const std::size_t HeaderSize;
+  static const std::size_t DefaultBlockSize;
+  static const std::size_t MaxExpansionRatio; //!< decompressed bytes per compressed byte a valid resource can have
+
+  static std::vector<char> compress(const char* data, std::size_t size,
+                                    std::size_t blockSize = DefaultBlockSize);
+
+  static bool        isCompressed(const char* data, std::size_t size);
+
+  /**
+   * Reads the decompressed size from the header. Throws a GameException if the data is not compressed or
+   * claims more than MaxExpansionRatio times the compressed size, so that corrupt headers cannot make the
+   * caller allocate arbitrary amounts of memory.
+   * @param compressedSize size of the whole resource, if only its header is passed
+   */
+  static std::size_t getDecompressedSize(const char* data, std::size_t size);
+  static std::size_t getDecompressedSize(const char* header, std::size_t headerSize, std::size_t compressedSize);
+
+  /**
+   * Decompresses into a buffer of getDecompressedSize() bytes, throws a GameException if the data is corrupt
+   */
+  static void decompress(const char* data, std::size_t size, char* out, std::size_t outSize);
+
+  /**
+   * Decompresses block by block from a stream that is positioned right behind the header
+   * @param inSize number of resource bytes left in the stream, reduced by the bytes read. Blocks that claim
+   *               more bytes than are left are corrupt, so that the stream is never read beyond the resource.
+   */
+  static void decompress(std::istream& stream, std::size_t& inSize, std::size_t blockSize, char* out,
+                         std::size_t outSize);
+
+  /**
+   * Decompresses a whole resource into a new buffer
+   */
+  static osg::ref_ptr<ResourceBuffer> decompress(const ResourceData& data);
+
+  static std::size_t getBlockSize(const char* header);
+
+  /**
+   * @return Whether the resource key ends with Extension, which marks the resource as compressed
+   */
+  static bool        hasExtension(const std::string& resourceKey);
+  static std::string stripExtension(const std::string& resourceKey);
+
+};
+
+}
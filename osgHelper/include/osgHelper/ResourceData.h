@@ -0,0 +1,100 @@
+#pragma once
+
+#include <osg/Referenced>
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <streambuf>
+
+namespace osgHelper
+{
+
+/**
+ * A read-only block of resource bytes. Implementations decide who owns the memory,
+ * e.g. a heap buffer or a memory-mapped file.
+ */
+class ResourceData : public osg::Referenced
+{
+public:
+  ResourceData() = default;
+  ~ResourceData() override = default;
+
+  virtual const char* getData() const = 0;
+  virtual std::size_t getSize() const = 0;
+
+};
+
+/**
+ * Resource bytes stored in a heap buffer
+ */
+class ResourceBuffer : public ResourceData
+{
+public:
+  explicit ResourceBuffer(std::size_t size);
+
+  /**
+   * Takes ownership of a buffer that was allocated with new[]
+   */
+  ResourceBuffer(char* bytes, std::size_t size);
+  ~ResourceBuffer() override;
+
+  const char* getData() const override;
+  std::size_t getSize() const override;
+
+  char* getBuffer();
+
+private:
+  std::unique_ptr<char[]> m_bytes;
+  std::size_t             m_size;
+
+};
+
+/**
+ * A range of bytes within other resource data, e.g. a file packed into a memory-mapped archive.
+ * Keeps the parent data alive.
+ */
+class ResourceDataView : public ResourceData
+{
+public:
+  ResourceDataView(const osg::ref_ptr<const ResourceData>& parent, std::size_t offset, std::size_t size);
+  ~ResourceDataView() override;
+
+  const char* getData() const override;
+  std::size_t getSize() const override;
+
+private:
+  osg::ref_ptr<const ResourceData> m_parent;
+  std::size_t                      m_offset;
+  std::size_t                      m_size;
+
+};
+
+/**
+ * A std::istream reading from ResourceData without copying it.
+ * The stream keeps a reference to the data.
+ */
+class ResourceDataStream : public std::istream
+{
+public:
+  explicit ResourceDataStream(const osg::ref_ptr<ResourceData>& data);
+  ~ResourceDataStream() override;
+
+private:
+  class StreamBuffer : public std::streambuf
+  {
+  public:
+    explicit StreamBuffer(const ResourceData& data);
+
+  protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+  };
+
+  osg::ref_ptr<ResourceData> m_data;
+  StreamBuffer               m_buffer;
+
+};
+
+}
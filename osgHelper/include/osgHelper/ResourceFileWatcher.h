@@ -0,0 +1,42 @@
+#pragma once
+
+#include <osg/Referenced>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osgHelper
+{
+
+/**
+ * Detects changes of files, e.g. to reload resources while editing them. Uses inotify on Linux, which
+ * watches the containing directories so that editors replacing files on save are detected as well.
+ * Other platforms compare the modification times whenever changes are polled.
+ */
+class ResourceFileWatcher : public osg::Referenced
+{
+public:
+  ResourceFileWatcher();
+  ~ResourceFileWatcher() override;
+
+  /**
+   * Can be called from any thread. Files that do not exist are ignored.
+   */
+  void watch(const std::string& filename);
+  void unwatch(const std::string& filename);
+  bool isWatching(const std::string& filename) const;
+
+  /**
+   * Does not block
+   * @return The files, as passed to watch(), that have been written since the last call
+   */
+  std::vector<std::string> pollChanges();
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Identifies a resource independent of the case of its name. The case-folded hash is computed once on
+ * construction, so that code looking up the same resource repeatedly, e.g. every frame, can keep a
+ * ResourceKey and pay neither for lower-casing nor for hashing on each lookup.
+ *
+ * Implicitly constructible from strings, so it can be passed wherever a resource name was used. Passing a
+ * string constructs a temporary key, which copies, lower-cases and hashes the name on each call as before.
+ */
+class ResourceKey
+{
+public:
+  struct Hash
+  {
+    std::size_t operator()(const ResourceKey& key) const
+    {
+      return key.getHash();
+    }
+  };
+
+  ResourceKey();
+  ResourceKey(const std::string& name);
+  ResourceKey(std::string&& name);
+  ResourceKey(const char* name);
+
+  /**
+   * @return The name as it was passed in, e.g. to open the file on case-sensitive file systems
+   */
+  const std::string& str() const
+  {
+    return m_name;
+  }
+
+  std::size_t getHash() const
+  {
+    return m_hash;
+  }
+
+  bool operator==(const ResourceKey& rhs) const
+  {
+    return (m_hash == rhs.m_hash) && equalsIgnoreCase(m_name, rhs.m_name);
+  }
+
+  bool operator!=(const ResourceKey& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  static bool equalsIgnoreCase(const std::string& lhs, const std::string& rhs);
+
+private:
+  std::string m_name;
+  std::size_t m_hash;
+
+  static std::size_t computeHash(const std::string& name);
+
+};
+
+}
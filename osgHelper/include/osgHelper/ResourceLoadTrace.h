@@ -0,0 +1,59 @@
+#pragma once
+
+#include <osg/Referenced>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace osgHelper
+{
+
+/**
+ * Timing events of the resources loaded by ResourceManager while tracing is enabled. The events can be
+ * written as Chrome trace JSON, which can be opened with chrome://tracing or https://ui.perfetto.dev
+ * to find the resources that slow down startup. Thread-safe.
+ */
+class ResourceLoadTrace : public osg::Referenced
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Event
+  {
+    std::string              resourceKey;
+    std::string              type;         //!< text, binary, shader or detect
+    std::string              readerWriter; //!< class name of the reader writer that decoded the resource, if any
+    std::size_t              numBytes;     //!< bytes read through the resource loader, after decompression
+    Clock::time_point        beginTime;
+    std::chrono::nanoseconds readDuration;   //!< reading and decompressing the resource data
+    std::chrono::nanoseconds decodeDuration; //!< creating the object from the data
+    std::thread::id          threadId;
+  };
+
+  using EventList = std::vector<Event>;
+
+  ResourceLoadTrace();
+  ~ResourceLoadTrace() override;
+
+  void      add(const Event& event);
+  EventList getEvents() const;
+  void      clear();
+
+  /**
+   * Writes a read and a decode slice per event. Timestamps are relative to the earliest event.
+   */
+  void writeChromeTrace(std::ostream& stream) const;
+  void writeChromeTraceToFile(const std::string& filename) const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
@@ -1,13 +1,30 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <map>
-
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <functional>
+#include <exception>
+#include <vector>
+
+#include <osgHelper/DecodedImageCache.h>
 #include <osgHelper/IResourceManager.h>
+#include <osgHelper/Observable.h>
+#include <osgHelper/ResourceCache.h>
+#include <osgHelper/ResourceFileWatcher.h>
+#include <osgHelper/ResourceLoadTrace.h>
+#include <osgHelper/ThreadPool.h>
 #include <osgHelper/ioc/Injector.h>
 
 namespace osgHelper
 {
 
+class ResourceManifest;
+
 class ResourceManager : public IResourceManager
 {
 public:
@@ -19,42 +36,217 @@ public:
     Shader
   };
 
+  struct LoadStatistics
+  {
+    using ReaderWriterDictionary = std::map<std::string, unsigned long long>;
+
+    unsigned long long        numLoads       = 0; //!< resources read through the resource loader, including reloads
+    unsigned long long        numFailedLoads = 0;
+    unsigned long long        numBytesRead   = 0; //!< after decompression, decoded image cache hits count the image size
+    std::chrono::nanoseconds  readTime       = std::chrono::nanoseconds::zero(); //!< summed over all threads
+    std::chrono::nanoseconds  decodeTime     = std::chrono::nanoseconds::zero(); //!< summed over all threads
+    ReaderWriterDictionary    numLoadsPerReaderWriter; //!< by class name of the reader writer
+    ResourceCache::Statistics cache;
+  };
+
   explicit ResourceManager(ioc::Injector& injector);
   ~ResourceManager() override;
 
-  std::string                 loadText(const std::string& resourceKey) override;
-  char*                       loadBinary(const std::string& resourceKey) override;
-  osg::ref_ptr<osg::Image>    loadImage(const std::string& resourceKey) override;
-  osg::ref_ptr<osgText::Font> loadFont(const std::string& resourceKey) override;
-  osg::ref_ptr<osg::Shader>   loadShader(const std::string& resourceKey, osg::Shader::Type type) override;
+  std::string                  loadText(const ResourceKey& resourceKey) override;
+  osg::ref_ptr<BinaryResource> loadBinary(const ResourceKey& resourceKey) override;
+  osg::ref_ptr<osg::Image>     loadImage(const ResourceKey& resourceKey) override;
+  osg::ref_ptr<osgText::Font>  loadFont(const ResourceKey& resourceKey) override;
+  osg::ref_ptr<osg::Shader>    loadShader(const ResourceKey& resourceKey, osg::Shader::Type type) override;
+
+  std::future<std::string>                 loadTextAsync(const ResourceKey& resourceKey) override;
+  std::future<osg::ref_ptr<osg::Image>>    loadImageAsync(const ResourceKey& resourceKey) override;
+  std::future<osg::ref_ptr<osgText::Font>> loadFontAsync(const ResourceKey& resourceKey) override;
+  std::future<osg::ref_ptr<osg::Shader>>   loadShaderAsync(const ResourceKey& resourceKey,
+                                                           osg::Shader::Type type) override;
 
   void setResourceLoader(const osg::ref_ptr<IResourceLoader>& loader) override;
 
-  void clearCacheResource(const std::string& resourceKey) override;
+  /**
+   * Loads the images in parallel on the loader threads and waits for all of them
+   * @return The images in the order of the keys, nullptr for images that could not be loaded
+   */
+  std::vector<osg::ref_ptr<osg::Image>> loadImages(const std::vector<ResourceKey>& resourceKeys);
+
+  /**
+   * Images read through a FileResourceLoader are looked up in the cache before they are decoded and
+   * stored after decoding, see DecodedImageCache. nullptr disables the cache, which is the default.
+   */
+  void                            setDecodedImageCache(const osg::ref_ptr<DecodedImageCache>& cache);
+  osg::ref_ptr<DecodedImageCache> getDecodedImageCache();
+
+  void clearCacheResource(const ResourceKey& resourceKey) override;
   void clearCache() override;
 
+  /**
+   * Sets the number of worker threads used for asynchronous loading.
+   * Has no effect once the first asynchronous load has been requested.
+   * @param numThreads number of threads, 0 uses the number of hardware threads
+   */
+  void setNumLoaderThreads(unsigned int numThreads);
+
+  /**
+   * Limits the estimated payload size of cached resources. Least recently used resources that are
+   * not referenced anywhere else are evicted when the budget is exceeded.
+   * @param bytes the memory budget, 0 disables the limit
+   */
+  void                      setCacheMemoryBudget(std::size_t bytes);
+  ResourceCache::Statistics getCacheStatistics() const;
+
+  /**
+   * @return Counters of all loads since construction or the last reset, and the current cache statistics
+   */
+  LoadStatistics getLoadStatistics() const;
+  void           resetLoadStatistics();
+
+  /**
+   * Records a trace event for every resource that is read from now on, see ResourceLoadTrace
+   */
+  void                            setLoadTracingEnabled(bool enabled);
+  bool                            isLoadTracingEnabled() const;
+  osg::ref_ptr<ResourceLoadTrace> getLoadTrace() const;
+
+  /**
+   * Loads the resources of a manifest in the background, by descending priority of the entries.
+   * Resources requested with the load*Async() functions are always loaded before prefetched ones.
+   * Resources that fail to load are skipped with a warning.
+   * @return Becomes ready when all resources of the manifest have been loaded
+   */
+  std::future<void> prefetch(const ResourceManifest& manifest);
+
+  /**
+   * Records all resources that are requested from now on, e.g. to prefetch them on the next startup
+   */
+  void                           setManifestRecordingEnabled(bool enabled);
+  osg::ref_ptr<ResourceManifest> getRecordedManifest() const;
+
+  /**
+   * Watches the files of resources loaded from files, see IResourceLoader::getResourceFilename(), and reloads
+   * them in the background when they change. The negative cache of a LayeredResourceLoader is cleared then,
+   * so that files added to an overlay meanwhile are found. Shaders and images are updated in place, so
+   * existing state sets pick up the changes without rebuilding the scene graph. Other resources, including
+   * text and binary resources, are replaced in the cache, holders of the previous objects can reload them
+   * when notified by getResourceReloadedObservable().
+   *
+   * Binary resources read through a MappedFileResourceLoader are copied while hot reload is enabled, because
+   * an editor truncating a mapped file would make accesses to the mapping fail.
+   */
+  void setHotReloadEnabled(bool enabled);
+  bool isHotReloadEnabled() const;
+
+  /**
+   * Starts reloading changed files and applies the reloads that have finished. Call it regularly from
+   * the thread that updates the scene graph, e.g. once per frame.
+   */
+  void applyPendingReloads();
+
+  /**
+   * Blocks until a background reload is ready to be applied with applyPendingReloads()
+   * @return false, if the timeout expired first
+   */
+  bool waitForPendingReloads(std::chrono::milliseconds timeout);
+
+  /**
+   * Notified with the resource key whenever a reloaded resource has been applied
+   */
+  Observable<std::string>::Ptr getResourceReloadedObservable() const;
+
   static void                        setDefaultFont(const osg::ref_ptr<osgText::Font>& font);
   static osg::ref_ptr<osgText::Font> getDefaultFont();
 
 private:
-  using ResourceDictionary = std::map<std::string, osg::ref_ptr<osg::Object>>;
+  using LoadCallback          = std::function<void(const osg::ref_ptr<osg::Object>&, const std::exception_ptr&)>;
+
+  struct PendingLoad
+  {
+    std::vector<LoadCallback> callbacks;
+    int                       priority  = 0;
+    bool                      isStarted = false; //!< a load can be queued several times, only the first task runs it
+  };
+
+  using PendingLoadDictionary = std::unordered_map<ResourceKey, PendingLoad, ResourceKey::Hash>;
+
+  struct WatchedResource
+  {
+    std::string       resourceKey;
+    ResourceType      type;
+    osg::Shader::Type shaderType;
+  };
+
+  using WatchedResourceDictionary = std::map<std::string, WatchedResource>; //!< by filename
+  using ReloadedResourceList      = std::vector<std::pair<std::string, osg::ref_ptr<osg::Object>>>;
 
   osg::ref_ptr<IResourceLoader> resourceLoader();
+  ThreadPool&                   threadPool();
+
+  /**
+   * @param isRecorded Only requests of callers are recorded into the manifest, not the loads of prefetch()
+   */
+  osg::ref_ptr<osg::Object> loadObject(const ResourceKey& resourceKey, ResourceType type = ResourceType::Detect,
+                                       osg::Shader::Type shaderType = osg::Shader::FRAGMENT, bool isRecorded = true);
+
+  osg::ref_ptr<osg::Object> decodeObject(const osg::ref_ptr<ResourceData>& data, const ResourceKey& resourceKey,
+                                         ResourceType type, osg::Shader::Type shaderType, std::string& readerWriter);
+
+  osg::ref_ptr<osg::Object> readObject(const osg::ref_ptr<IResourceLoader>& loader, const ResourceKey& resourceKey,
+                                       ResourceType type, osg::Shader::Type shaderType);
+
+  void loadObjectAsync(const ResourceKey& resourceKey, ResourceType type, osg::Shader::Type shaderType,
+                       const LoadCallback& callback, int priority, bool isRecorded = true);
+
+  void recordLoad(const ResourceKey& resourceKey, ResourceType type, const std::string& readerWriter,
+                  std::size_t numBytes, ResourceLoadTrace::Clock::time_point beginTime,
+                  ResourceLoadTrace::Clock::time_point readEndTime, ResourceLoadTrace::Clock::time_point endTime);
+
+  void recordManifestEntry(const ResourceKey& resourceKey, ResourceType type, osg::Shader::Type shaderType);
 
-  char*                     loadBytesFromStream(std::ifstream& stream, long long length);
-  std::string               loadTextFromStream(std::ifstream& stream, long long length);
-  osg::ref_ptr<osg::Object> loadObject(const std::string& resourceKey, ResourceType type = ResourceType::Detect,
-                                       osg::Shader::Type shaderType = osg::Shader::FRAGMENT);
+  void watchResource(const ResourceKey& resourceKey, const std::string& filename, ResourceType type,
+                     osg::Shader::Type shaderType);
+  void applyReload(const ResourceKey& resourceKey, const osg::ref_ptr<osg::Object>& obj);
 
-  osg::ref_ptr<osg::Object> getCacheItem(const std::string& key);
-  void                      storeCacheItem(const std::string& key, const osg::ref_ptr<osg::Object>& obj);
+  osg::ref_ptr<osg::Object> getCacheItem(const ResourceKey& key);
+  osg::ref_ptr<osg::Object> storeCacheItem(const ResourceKey& key, const osg::ref_ptr<osg::Object>& obj);
 
-  ResourceDictionary m_cache;
+  ResourceCache m_cache;
 
   osg::ref_ptr<IResourceLoader> m_resourceLoader;
+  std::mutex                    m_resourceLoaderMutex;
+
+  osg::ref_ptr<DecodedImageCache> m_decodedImageCache;
+  std::mutex                      m_decodedImageCacheMutex;
+
+  PendingLoadDictionary m_pendingLoads;
+  std::mutex            m_pendingLoadsMutex;
+
+  LoadStatistics     m_loadStatistics;
+  mutable std::mutex m_loadStatisticsMutex;
+
+  std::atomic<bool>               m_isLoadTracing;
+  osg::ref_ptr<ResourceLoadTrace> m_loadTrace;
+  mutable std::mutex              m_loadTraceMutex;
+
+  std::atomic<bool>              m_isRecordingManifest;
+  osg::ref_ptr<ResourceManifest> m_recordedManifest;
+  mutable std::mutex             m_recordedManifestMutex;
+
+  std::atomic<bool>                 m_isHotReloadEnabled;
+  osg::ref_ptr<ResourceFileWatcher> m_hotReloadWatcher;
+  WatchedResourceDictionary         m_watchedResources;
+  ReloadedResourceList              m_reloadedResources;
+  std::mutex                        m_hotReloadMutex;
+  std::condition_variable           m_reloadFinished;
+  Observable<std::string>::Ptr      m_resourceReloaded;
+
+  unsigned int                m_numLoaderThreads;
+  std::once_flag              m_threadPoolInitialized;
+  std::unique_ptr<ThreadPool> m_threadPool;
 
   static osg::ref_ptr<osgText::Font> m_defaultFont;
 
 };
 
-}
\ No newline at end of file
+}
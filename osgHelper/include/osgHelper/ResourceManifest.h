@@ -0,0 +1,66 @@
+#pragma once
+
+#include <osgHelper/ResourceManager.h>
+
+#include <osg/Referenced>
+
+#include <istream>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace osgHelper
+{
+
+/**
+ * A list of resources to prefetch with ResourceManager::prefetch(), e.g. everything a scene needs.
+ * ResourceManager can record one from the resources requested during a session.
+ *
+ * Text format, one entry per line, '#' starts a comment:
+ *   <priority> <type> <resource key>
+ * where type is one of text, binary, detect, or shader:vertex, shader:fragment, shader:geometry, ...
+ */
+class ResourceManifest : public osg::Referenced
+{
+public:
+  struct Entry
+  {
+    std::string                   resourceKey;
+    ResourceManager::ResourceType type;
+    osg::Shader::Type             shaderType;
+    int                           priority; //!< higher priorities are loaded first
+  };
+
+  using EntryList = std::vector<Entry>;
+
+  ResourceManifest();
+  ~ResourceManifest() override;
+
+  /**
+   * Adds an entry, if the resource is not in the manifest yet
+   * @return false, if the resource was already in the manifest
+   */
+  bool add(const std::string& resourceKey, ResourceManager::ResourceType type,
+           osg::Shader::Type shaderType = osg::Shader::FRAGMENT, int priority = 0);
+
+  const EntryList& getEntries() const;
+  std::size_t      getNumEntries() const;
+  void             clear();
+
+  /**
+   * Reads entries from the text format, throws a GameException on syntax errors
+   */
+  void read(std::istream& stream);
+  void write(std::ostream& stream) const;
+
+  void readFromFile(const std::string& filename);
+  void writeToFile(const std::string& filename) const;
+
+private:
+  EntryList             m_entries;
+  std::set<std::string> m_keys;
+
+};
+
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <osgHelper/IShaderBlueprint.h>
+#include <osgHelper/ShaderPermutationCache.h>
+#include <osgHelper/ShaderPreprocessor.h>
 
 #include <memory>
 
@@ -10,13 +12,19 @@ namespace osgHelper
 class ShaderBlueprint : public IShaderBlueprint
 {
 public:
-  ShaderBlueprint();
+  /**
+   * @param cache        shares the built shaders with other blueprints, nullptr builds a new shader on every call
+   * @param preprocessor expands the modules with the defines of the blueprint, nullptr passes them through
+   */
+  explicit ShaderBlueprint(const osg::ref_ptr<ShaderPermutationCache>& cache        = nullptr,
+                           const osg::ref_ptr<ShaderPreprocessor>&     preprocessor = nullptr);
   ~ShaderBlueprint() override;
 
   osg::ref_ptr<IShaderBlueprint> version(int shaderVersion) override;
   osg::ref_ptr<IShaderBlueprint> type(osg::Shader::Type shaderType) override;
   osg::ref_ptr<IShaderBlueprint> extension(const std::string& extName) override;
   osg::ref_ptr<IShaderBlueprint> module(const std::string& module) override;
+  osg::ref_ptr<IShaderBlueprint> define(const std::string& name, const std::string& value = "") override;
 
   osg::ref_ptr<osg::Shader> build() override;
 
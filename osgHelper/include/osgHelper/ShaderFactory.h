@@ -1,11 +1,24 @@
 #pragma once
 
 #include <osgHelper/IShaderFactory.h>
+#include <osgHelper/ProgramBinaryCache.h>
+#include <osgHelper/ShaderPermutationCache.h>
+#include <osgHelper/ShaderPreprocessor.h>
 #include <osgHelper/ioc/Injector.h>
 
+#include <atomic>
+#include <filesystem>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
 namespace osgHelper
 {
 
+/**
+ * Shaders of fromSourceText() are shared by their type and source, the key names them for diagnostics and
+ * the shader directory. A key that is used for different sources is reported as a mismatch. Thread-safe.
+ */
 class ShaderFactory : public IShaderFactory
 {
 public:
@@ -14,11 +27,84 @@ public:
 
 	osg::ref_ptr<osg::Shader> fromSourceText(const std::string& key, const std::string& source, osg::Shader::Type type) override;
 	osg::ref_ptr<IShaderBlueprint> make() const override;
+	void prepareProgram(const osg::ref_ptr<osg::Program>& program) override;
+
+	/**
+	 * Opt-in, blueprints made afterwards share the shaders of identical permutations through the cache, so
+	 * that OSG compiles them only once per context. Shared shaders must not be modified.
+	 */
+	void                                 setPermutationCache(const osg::ref_ptr<ShaderPermutationCache>& cache);
+	osg::ref_ptr<ShaderPermutationCache> getPermutationCache() const;
+
+	/**
+	 * Opt-in, programs prepared afterwards use the binaries of the cache. The draw callback of the cache
+	 * has to be added to the camera that renders them, e.g. with osg::Camera::addFinalDrawCallback().
+	 */
+	void                             setProgramBinaryCache(const osg::ref_ptr<ProgramBinaryCache>& cache);
+	osg::ref_ptr<ProgramBinaryCache> getProgramBinaryCache() const;
+
+	/**
+	 * Opt-in, blueprints made afterwards expand #include and #ifdef directives of their modules
+	 */
+	void                             setShaderPreprocessor(const osg::ref_ptr<ShaderPreprocessor>& preprocessor);
+	osg::ref_ptr<ShaderPreprocessor> getShaderPreprocessor() const;
+
+	/**
+	 * Opt-in, fromSourceText() uses the file getShaderFilename() of the directory instead of the passed source
+	 * if it exists and starts with the getSourceStamp() of the passed source, e.g. the validated and minified
+	 * shaders written by osgHelperShaders. Each file is read once, outdated files are ignored.
+	 */
+	void        setShaderDirectory(const std::string& directory);
+	std::string getShaderDirectory() const;
+
+	/**
+	 * @return The key followed by the extension of the shader stage, e.g. ".frag"
+	 */
+	static std::string getShaderFilename(const std::string& key, osg::Shader::Type type);
+
+	/**
+	 * @return The first line of a shader directory file, a comment that identifies the source it was made from
+	 */
+	static std::string getSourceStamp(const std::string& source);
+
+	/**
+	 * @return The number of distinct shaders created by fromSourceText()
+	 */
+	std::size_t getNumShaders() const;
+
+	/**
+	 * @return The number of sources keys were used for besides their first one
+	 */
+	unsigned long long getNumKeyMismatches() const;
 
 private:
-	using ShaderDictionary = std::map<std::string, osg::ref_ptr<osg::Shader>>;
+	struct ShaderFile
+	{
+		std::string stamp;  //!< of the source passed when the file was read
+		std::string source; //!< empty if there is no file or it is outdated
+	};
+
+	using ShaderDictionary = std::unordered_multimap<std::size_t, osg::ref_ptr<osg::Shader>>; //!< by content hash
+	using KeyDictionary    = std::unordered_multimap<std::string, const osg::Shader*>;
+	using FileDictionary   = std::unordered_map<std::string, ShaderFile>; //!< by filename
+
+	ShaderDictionary                     m_shaderCache;
+	KeyDictionary                        m_shaderKeys;
+	std::atomic<unsigned long long>      m_numKeyMismatches;
+	mutable std::shared_mutex            m_shaderCacheMutex;
+	osg::ref_ptr<ShaderPermutationCache> m_permutationCache;
+	osg::ref_ptr<ProgramBinaryCache>     m_programBinaryCache;
+	osg::ref_ptr<ShaderPreprocessor>     m_shaderPreprocessor;
+	std::string                          m_shaderDirectory;
+	mutable std::shared_mutex            m_optionsMutex;
+	FileDictionary                       m_shaderFiles;
+	mutable std::shared_mutex            m_shaderFilesMutex;
 
-	ShaderDictionary m_shaderCache;
+	std::string               getShaderSource(const std::string& key, const std::string& source, osg::Shader::Type type);
+	ShaderFile                readShaderFile(const std::filesystem::path& filename, const std::string& stamp) const;
+	osg::ref_ptr<osg::Shader> findShader(std::size_t hash, const std::string& source, osg::Shader::Type type) const;
+	bool                      isKnownKey(const std::string& key, const osg::Shader* shader) const;
+	void                      addKey(const std::string& key, const osg::Shader* shader);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Shrinks GLSL sources without changing their meaning: comments are removed, whitespace is collapsed to
+ * the spaces needed to separate tokens and code is joined into one line. Preprocessor directives are kept
+ * on lines of their own, line continuations are joined. Identifiers are not renamed, so uniforms and
+ * attributes can still be bound by name.
+ */
+class ShaderMinifier
+{
+public:
+  static std::string minify(const std::string& source);
+
+};
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <osg/Referenced>
+#include <osg/Shader>
+#include <osg/ref_ptr>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osgHelper
+{
+
+/**
+ * Shares the shaders built by ShaderBlueprint between identical permutations of version, type, extensions,
+ * defines and modules, see ShaderFactory::setPermutationCache().
+ *
+ * When a new permutation exceeds the maximum number of shaders, the shaders that are no longer used outside of
+ * the cache are evicted, or the least recently used one if all of them are. Evicting a used shader only stops
+ * sharing it, its users keep it.
+ *
+ * Cached shaders are shared, they must not be modified. Thread-safe.
+ */
+class ShaderPermutationCache : public osg::Referenced
+{
+public:
+  struct Permutation
+  {
+    osg::Shader::Type                  type    = osg::Shader::FRAGMENT;
+    int                                version = 120;
+    std::vector<std::string>           extensions;
+    std::vector<std::string>           modules;
+    std::map<std::string, std::string> defines; //!< sorted by name, so that the order of definition does not matter
+
+    std::size_t getHash() const;
+    bool        operator==(const Permutation& rhs) const;
+  };
+
+  struct Statistics
+  {
+    unsigned long long numLookups = 0;
+    unsigned long long numHits      = 0;
+    unsigned long long numEvictions = 0;
+    std::size_t        numShaders   = 0;
+  };
+
+  using CreateFunc = std::function<osg::ref_ptr<osg::Shader>(const Permutation&)>;
+
+  explicit ShaderPermutationCache(std::size_t maxNumShaders = 1024);
+  ~ShaderPermutationCache() override;
+
+  /**
+   * @return The cached shader of the permutation, or the one created and stored with create()
+   */
+  osg::ref_ptr<osg::Shader> getOrCreate(const Permutation& permutation, const CreateFunc& create);
+
+  void        setMaxNumShaders(std::size_t maxNumShaders);
+  std::size_t getMaxNumShaders() const;
+
+  Statistics getStatistics() const;
+  void       resetStatistics();
+  void       clear();
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
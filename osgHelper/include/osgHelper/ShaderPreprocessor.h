@@ -0,0 +1,76 @@
+#pragma once
+
+#include <osgHelper/IResourceManager.h>
+#include <osgHelper/ResourceKey.h>
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Expands shader sources before they are handed to the GL compiler:
+ *
+ * - #include "name" and #include <name> are replaced by the text resource of the name, loaded through the
+ *   resource manager. Every file is included only once per source, as if it had an include guard. Includes
+ *   within #if sections the GL compiler evaluates are expanded in every branch and do not count.
+ * - #ifdef, #ifndef and #else sections of macros that are known are reduced to the active section. Macros are
+ *   known if they are passed as defines or defined with #define outside of unresolved sections. Macros
+ *   starting with "GL_" or "__" are left to the GL compiler, as well as #if and #elif expressions.
+ * - #line directives are inserted where the output continues at another line than the previous one, so that
+ *   the GL compiler reports errors at the lines of the original files. Source string 0 is the processed
+ *   source, included files are numbered by their first inclusion and named in a comment.
+ *
+ * Included files are parsed once, expanded sources are cached per source and defines. invalidate() only
+ * drops the expanded sources that depend on the changed file, e.g. connected to
+ * ResourceManager::getResourceReloadedObservable(). Thread-safe.
+ */
+class ShaderPreprocessor : public osg::Referenced
+{
+public:
+  using Defines = std::map<std::string, std::string>;
+
+  struct Statistics
+  {
+    unsigned long long numExpansions  = 0; //!< sources that were not cached
+    unsigned long long numCacheHits   = 0;
+    unsigned long long numParsedFiles = 0; //!< included files that were loaded and parsed
+  };
+
+  explicit ShaderPreprocessor(const osg::ref_ptr<IResourceManager>& resourceManager);
+  ~ShaderPreprocessor() override;
+
+  /**
+   * Throws a GameException if a conditional section is not terminated in the file it started in
+   * @param version GLSL version the source is compiled with, the meaning of #line changed with version 330
+   */
+  std::string process(const std::string& source, const Defines& defines = Defines(), int version = 330);
+
+  /**
+   * Enabled by default
+   */
+  void setLineDirectivesEnabled(bool enabled);
+  bool isLineDirectivesEnabled() const;
+
+  /**
+   * Drops the cached text of the included file and all expanded sources that include it, directly or
+   * through other files
+   */
+  void invalidate(const ResourceKey& includeKey);
+
+  void clear();
+
+  Statistics getStatistics() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
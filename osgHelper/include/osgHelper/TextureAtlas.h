@@ -0,0 +1,99 @@
+#pragma once
+
+#include <osg/Image>
+#include <osg/Referenced>
+#include <osg/Texture2D>
+#include <osg/Vec2f>
+#include <osg/ref_ptr>
+
+#include <memory>
+
+namespace osgHelper
+{
+
+/**
+ * Packs many small images into shared RGBA pages, so that everything on one page is drawn with a single
+ * texture bind. Regions are placed with the MaxRects best-short-side-fit heuristic, a new page is added
+ * when an image does not fit into any of the existing ones. Removed regions are given back to the free
+ * space of their page, a page without regions is reset completely.
+ *
+ * Each region is surrounded by a border of its edge pixels, so that linear filtering does not bleed
+ * neighbouring regions into it. Page textures do not use mipmaps for the same reason.
+ * Thread-safe. The page images are modified in place, so regions should be inserted and removed in the
+ * update traversal.
+ */
+class TextureAtlas : public osg::Referenced
+{
+public:
+  using RegionId = unsigned int;
+
+  static const RegionId InvalidRegionId = 0;
+
+  struct Region
+  {
+    RegionId     id     = InvalidRegionId;
+    unsigned int page   = 0;
+    int          x      = 0; //!< in pixels, without the border
+    int          y      = 0;
+    int          width  = 0;
+    int          height = 0;
+    osg::Vec2f   uvMin;      //!< texture coordinates of the lower left corner
+    osg::Vec2f   uvMax;      //!< texture coordinates of the upper right corner
+  };
+
+  struct Statistics
+  {
+    unsigned int       numPages    = 0;
+    unsigned int       numRegions  = 0;
+    unsigned long long usedPixels  = 0;    //!< pixels covered by regions, without their borders
+    unsigned long long totalPixels = 0;    //!< pixels of all pages
+    float              efficiency  = 0.0f; //!< usedPixels / totalPixels
+  };
+
+  /**
+   * @param pageSize Width and height of each page in pixels
+   * @param border   Pixels of each region's edge that are repeated around it
+   */
+  explicit TextureAtlas(int pageSize = 1024, int border = 1);
+  ~TextureAtlas() override;
+
+  int getPageSize() const;
+  int getBorder() const;
+
+  /**
+   * Copies the image into a free area of a page. Images must be 2D with unsigned byte RGBA, BGRA, RGB,
+   * luminance, luminance-alpha or alpha pixels. Throws a GameException if the format is not supported or
+   * the image is larger than a page.
+   */
+  Region insert(const osg::ref_ptr<osg::Image>& image);
+
+  /**
+   * Gives the area of the region back to its page. The pixels are left unchanged.
+   *
+   * @return false if there is no such region
+   */
+  bool remove(RegionId id);
+
+  /**
+   * @return false if there is no such region
+   */
+  bool getRegion(RegionId id, Region& region) const;
+
+  unsigned int getNumPages() const;
+
+  /**
+   * Pages are never removed, textures stay valid for the lifetime of the atlas.
+   * Their images are dirtied on changes, so OSG uploads them again before the next frame.
+   */
+  osg::ref_ptr<osg::Texture2D> getPageTexture(unsigned int page) const;
+  osg::ref_ptr<osg::Image>     getPageImage(unsigned int page) const;
+
+  Statistics getStatistics() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
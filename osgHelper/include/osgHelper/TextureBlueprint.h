@@ -1,6 +1,7 @@
 #pragma once
 
 #include <osgHelper/ITextureBlueprint.h>
+#include <osgHelper/TextureCache.h>
 
 #include <memory>
 
@@ -10,7 +11,14 @@ namespace osgHelper
 class TextureBlueprint : public ITextureBlueprint
 {
 public:
-  TextureBlueprint();
+  /**
+   * @param cache     shares the built textures and sampler uniforms with other blueprints, nullptr creates new
+   *                  ones on every call
+   * @param processor generates the mipmaps and compresses the image on the CPU if requested by mipmaps() or
+   *                  compression(), nullptr leaves both to the driver
+   */
+  explicit TextureBlueprint(const osg::ref_ptr<TextureCache>&     cache     = nullptr,
+                            const osg::ref_ptr<TextureProcessor>& processor = nullptr);
   ~TextureBlueprint() override;
 
   osg::ref_ptr<ITextureBlueprint> image(const osg::ref_ptr<osg::Image>& img) override;
@@ -20,6 +28,8 @@ public:
   osg::ref_ptr<ITextureBlueprint> uniform(const osg::ref_ptr<osg::StateSet>& stateSet, const std::string& uniformName) override;
   osg::ref_ptr<ITextureBlueprint> minFilter(osg::Texture::FilterMode filterMode) override;
   osg::ref_ptr<ITextureBlueprint> magFilter(osg::Texture::FilterMode filterMode) override;
+  osg::ref_ptr<ITextureBlueprint> mipmaps(TextureProcessor::MipmapFilter filter) override;
+  osg::ref_ptr<ITextureBlueprint> compression(TextureProcessor::Compression compression) override;
 
   osg::ref_ptr<osg::Texture2D> build() const override;
 
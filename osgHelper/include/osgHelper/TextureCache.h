@@ -0,0 +1,89 @@
+#pragma once
+
+#include <osg/Image>
+#include <osg/Referenced>
+#include <osg/Texture2D>
+#include <osg/Uniform>
+#include <osg/ref_ptr>
+
+#include <osgHelper/TextureProcessor.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Shares the textures built by TextureBlueprint between blueprints with the same image and sampler state,
+ * and the sampler uniforms between blueprints with the same uniform name and texture unit, so that state
+ * sets using them compare equal and OSG's state sorting can skip the state changes, see
+ * TextureFactory::setTextureCache().
+ *
+ * Images and processors are compared by identity and kept alive by the cache until their textures are evicted.
+ * When a new texture exceeds the maximum number of textures, the textures that are no longer used outside of the
+ * cache are evicted, or the least recently used one if all of them are. Evicting a used texture only stops
+ * sharing it, its users keep it.
+ *
+ * Cached textures and uniforms are shared, they must not be modified. Thread-safe.
+ */
+class TextureCache : public osg::Referenced
+{
+public:
+  struct TextureKey
+  {
+    osg::ref_ptr<osg::Image>       image;
+    osg::Object::DataVariance      dataVariance  = osg::Object::DYNAMIC;
+    osg::Texture::WrapMode         wrapS         = osg::Texture::CLAMP_TO_EDGE;
+    osg::Texture::WrapMode         wrapT         = osg::Texture::CLAMP_TO_EDGE;
+    osg::Texture::FilterMode       minFilter     = osg::Texture::LINEAR_MIPMAP_LINEAR;
+    osg::Texture::FilterMode       magFilter     = osg::Texture::LINEAR;
+    float                          maxAnisotropy = 8.0f;
+    osg::ref_ptr<TextureProcessor> processor;        //!< nullptr if the image is used as is
+    TextureProcessor::Options      processorOptions; //!< only used with a processor
+
+    std::size_t getHash() const;
+    bool        operator==(const TextureKey& rhs) const;
+  };
+
+  struct Statistics
+  {
+    unsigned long long numTextureLookups   = 0;
+    unsigned long long numTextureHits      = 0;
+    unsigned long long numTextureEvictions = 0;
+    unsigned long long numUniformLookups   = 0;
+    unsigned long long numUniformHits      = 0;
+    std::size_t        numTextures         = 0;
+    std::size_t        numUniforms         = 0;
+  };
+
+  using CreateFunc = std::function<osg::ref_ptr<osg::Texture2D>(const TextureKey&)>;
+
+  explicit TextureCache(std::size_t maxNumTextures = 1024);
+  ~TextureCache() override;
+
+  /**
+   * @return The cached texture of the key, or the one created and stored with create()
+   */
+  osg::ref_ptr<osg::Texture2D> getOrCreateTexture(const TextureKey& key, const CreateFunc& create);
+
+  /**
+   * @return The cached sampler uniform with the name, set to the texture unit
+   */
+  osg::ref_ptr<osg::Uniform> getOrCreateSamplerUniform(const std::string& name, int texLayer);
+
+  void        setMaxNumTextures(std::size_t maxNumTextures);
+  std::size_t getMaxNumTextures() const;
+
+  Statistics getStatistics() const;
+  void       resetStatistics();
+  void       clear();
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
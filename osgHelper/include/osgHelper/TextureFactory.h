@@ -1,8 +1,12 @@
 #pragma once
 
 #include <osgHelper/ITextureFactory.h>
+#include <osgHelper/TextureCache.h>
+#include <osgHelper/TextureProcessor.h>
 #include <osgHelper/ioc/Injector.h>
 
+#include <shared_mutex>
+
 namespace osgHelper
 {
 
@@ -12,6 +16,23 @@ public:
 	explicit TextureFactory(ioc::Injector& injector);
 
   osg::ref_ptr<ITextureBlueprint> make() const override;
+
+  /**
+   * Opt-in, blueprints made afterwards share their textures and sampler uniforms with the cache
+   */
+  void                       setTextureCache(const osg::ref_ptr<TextureCache>& cache);
+  osg::ref_ptr<TextureCache> getTextureCache() const;
+
+  /**
+   * Opt-in, blueprints made afterwards generate mipmaps and compress images with it if requested
+   */
+  void                           setTextureProcessor(const osg::ref_ptr<TextureProcessor>& processor);
+  osg::ref_ptr<TextureProcessor> getTextureProcessor() const;
+
+private:
+  osg::ref_ptr<TextureCache>     m_textureCache;
+  osg::ref_ptr<TextureProcessor> m_textureProcessor;
+  mutable std::shared_mutex      m_optionsMutex;
 };
 
 }
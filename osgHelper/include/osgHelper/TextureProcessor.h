@@ -0,0 +1,83 @@
+#pragma once
+
+#include <osg/Image>
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include <memory>
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * Prepares images for upload on the CPU: generates their mipmap chains and encodes them into BC1 (DXT1) or
+ * BC3 (DXT5) blocks, so that the driver neither has to generate mipmaps nor keep uncompressed textures.
+ * The rows of each mipmap level and the block rows of each compressed level are processed in parallel by
+ * worker threads.
+ *
+ * Results are optionally cached on disk, keyed by the pixels of the image and the options. The pixels of an
+ * image are hashed again only after it was dirtied. Thread-safe.
+ */
+class TextureProcessor : public osg::Referenced
+{
+public:
+  enum class MipmapFilter
+  {
+    None,   //!< only the base level
+    Box,    //!< average of 2x2 pixels, fast
+    Kaiser  //!< Kaiser-windowed sinc over 6x6 pixels, sharper for minified textures
+  };
+
+  enum class Compression
+  {
+    None,
+    BC1,  //!< 4 bits per pixel, alpha is dropped
+    BC3   //!< 8 bits per pixel with interpolated alpha
+  };
+
+  struct Options
+  {
+    MipmapFilter mipmapFilter = MipmapFilter::Box;
+    Compression  compression  = Compression::None;
+  };
+
+  struct Statistics
+  {
+    unsigned long long numProcessed = 0; //!< images processed on the CPU
+    unsigned long long numCacheHits = 0; //!< images read from the disk cache
+  };
+
+  /**
+   * @param cacheDirectory Is created if it does not exist, empty disables the disk cache.
+   *                       Throws a GameException if it can not be created.
+   * @param numThreads     Number of worker threads, 0 uses the number of hardware threads
+   */
+  explicit TextureProcessor(const std::string& cacheDirectory = "", unsigned int numThreads = 0);
+  ~TextureProcessor() override;
+
+  const std::string& getCacheDirectory() const;
+
+  /**
+   * Images must be 2D with unsigned byte RGB or RGBA pixels, throws a GameException otherwise.
+   * The base level of uncompressed results is a copy, the source image is left unchanged.
+   * Results that can not be written to the disk cache are returned anyway with a warning.
+   *
+   * @return A new image with the mipmap levels of the options, tightly packed
+   */
+  osg::ref_ptr<osg::Image> process(const osg::Image& image, const Options& options);
+
+  Statistics getStatistics() const;
+
+  /**
+   * Removes all entries of the disk cache
+   */
+  void clearCache();
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace osgHelper
+{
+
+/**
+ * A fixed number of worker threads processing queued tasks by priority, tasks with the same priority
+ * in FIFO order. The destructor blocks until all queued tasks, including those enqueued by running
+ * tasks in the meantime, have finished.
+ */
+class ThreadPool
+{
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @param numThreads number of worker threads, 0 uses the number of hardware threads
+   */
+  explicit ThreadPool(unsigned int numThreads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @param priority tasks with a higher priority are started first
+   */
+  void enqueue(const Task& task, int priority = 0);
+
+  /**
+   * Blocks until the queue is empty and no task is running anymore
+   */
+  void waitForIdle();
+
+  unsigned int getNumThreads() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m;
+
+};
+
+}
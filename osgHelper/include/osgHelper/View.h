@@ -6,6 +6,7 @@
 
 #include <osgHelper/ppu/Effect.h>
 #include <osgHelper/Camera.h>
+#include <osgHelper/RenderTargetPool.h>
 #include <osgHelper/ppu/RenderTextureUnitSink.h>
 
 #include <osgViewer/View>
@@ -89,6 +90,13 @@ namespace osgHelper
     void updateResolution(const osg::Vec2i& resolution, float pixelRatio = 1.0f);
     void updateCameraViewports(int x, int y, int width, int height, float pixelRatio = 1.0f) const;
 
+    /**
+     * Stretches the existing render targets over the new resolution without recreating them, to bridge the
+     * frames until updateResolution() is called, e.g. by a coalescing ResizeEventHandler.
+     * Updates the resolution right away if it was not initialized yet.
+     */
+    void scaleRenderTargets(const osg::Vec2i& resolution, float pixelRatio = 1.0f);
+
     void setClampColorEnabled(bool enabled);
 
     osg::ref_ptr<osg::Group> getRootGroup() const;
@@ -105,6 +113,14 @@ namespace osgHelper
     osg::Vec2i                getResolution() const;
     bool isResolutionInitialized() const;
 
+    /**
+     * The pool the render textures of the scene camera and the render-to-texture slave cameras are recycled in.
+     * They have the exact resolution by default. Opt-in, with RenderTargetPool::setSizeGranularity() their sizes
+     * are rounded up from the next updateResolution() on, so that continuous resizes recycle them. The cameras
+     * then render across the whole textures and the screen camera stretches the result over the window.
+     */
+    osg::ref_ptr<RenderTargetPool> getRenderTargetPool() const;
+
     bool getPostProcessingEffectEnabled(const std::string& ppeName) const;
     bool hasPostProcessingEffect(const std::string& ppeName) const;
 
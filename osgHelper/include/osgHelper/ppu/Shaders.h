@@ -1,6 +1,9 @@
 #pragma once
 
+#include <osg/Shader>
+
 #include <string>
+#include <vector>
 
 namespace osgHelper
 {
@@ -9,6 +12,18 @@ namespace ppu
 
 	struct Shaders
 	{
+		struct Entry
+		{
+			std::string        name;
+			const std::string* source;
+			osg::Shader::Type  type;
+		};
+
+		/**
+		 * @return All shaders of the effects, e.g. to validate them offline
+		 */
+		static std::vector<Entry> getAll();
+
 		static const std::string ShaderBrightpassFp;
 		static const std::string ShaderDepthOfFieldFp;
 		static const std::string ShaderFxaaFp;
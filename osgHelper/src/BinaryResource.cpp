@@ -3,14 +3,11 @@
 namespace osgHelper
 {
 
-BinaryResource::BinaryResource() : Object(), m_bytes(nullptr)
+BinaryResource::BinaryResource() : Object()
 {
 }
 
-BinaryResource::~BinaryResource()
-{
-  delete[] m_bytes;
-}
+BinaryResource::~BinaryResource() = default;
 
 osg::Object* BinaryResource::cloneType() const
 {
@@ -34,15 +31,29 @@ const char* BinaryResource::className() const
   return "BinaryResource";
 }
 
-char* BinaryResource::getBytes() const
+const char* BinaryResource::getBytes() const
+{
+  return m_data.valid() ? m_data->getData() : nullptr;
+}
+
+std::size_t BinaryResource::getSize() const
+{
+  return m_data.valid() ? m_data->getSize() : 0;
+}
+
+void BinaryResource::setBytes(char* bytes, std::size_t size)
+{
+  m_data = bytes ? new ResourceBuffer(bytes, size) : nullptr;
+}
+
+void BinaryResource::setData(const osg::ref_ptr<ResourceData>& data)
 {
-  return m_bytes;
+  m_data = data;
 }
 
-void BinaryResource::setBytes(char* bytes)
+osg::ref_ptr<ResourceData> BinaryResource::getData() const
 {
-  delete[] m_bytes;
-  m_bytes = bytes;
+  return m_data;
 }
 
-}  // namespace osgHelper
\ No newline at end of file
+}  // namespace osgHelper
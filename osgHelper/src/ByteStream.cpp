@@ -1,30 +1,292 @@
 #include <osgHelper/ByteStream.h>
+#include <osgHelper/BinaryResource.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/ResourceChunkReader.h>
 
+#include <algorithm>
 #include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <cstdlib>
+#endif
 
 namespace osgHelper
 {
 
-ByteStream::ByteStream(char* data)
+#ifdef _MSC_VER
+static std::uint16_t byteSwap(std::uint16_t value) { return _byteswap_ushort(value); }
+static std::uint32_t byteSwap(std::uint32_t value) { return _byteswap_ulong(value); }
+static std::uint64_t byteSwap(std::uint64_t value) { return _byteswap_uint64(value); }
+#else
+static std::uint16_t byteSwap(std::uint16_t value) { return __builtin_bswap16(value); }
+static std::uint32_t byteSwap(std::uint32_t value) { return __builtin_bswap32(value); }
+static std::uint64_t byteSwap(std::uint64_t value) { return __builtin_bswap64(value); }
+#endif
+
+// a plain loop over whole words, which compilers turn into vector shuffles
+template <typename T>
+static void swapWords(char* data, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		T word;
+		std::memcpy(&word, data + i * sizeof(T), sizeof(T));
+		word = byteSwap(word);
+		std::memcpy(data + i * sizeof(T), &word, sizeof(T));
+	}
+}
+
+struct ByteStream::ChunkState
+{
+	osg::ref_ptr<ResourceChunkReader> reader;
+	osg::ref_ptr<ResourceData>        chunk;  //!< the window, if it is a single chunk
+	std::vector<char>                 buffer; //!< the window, if it has been assembled from several chunks
+};
+
+ByteStream::ByteStream(const char* data)
+	: m_data(data),
+	  m_size(UnknownSize),
+	  m_pos(0),
+	  m_windowOffset(0),
+	  m_totalSize(UnknownSize)
+{
+}
+
+ByteStream::ByteStream(const char* data, std::size_t size)
 	: m_data(data),
-	  m_pos(0)
+	  m_size(size),
+	  m_pos(0),
+	  m_windowOffset(0),
+	  m_totalSize(size)
+{
+}
+
+ByteStream::ByteStream(const BinaryResource& resource)
+	: ByteStream(resource.getBytes(), resource.getSize())
+{
+}
+
+ByteStream::ByteStream(const osg::ref_ptr<ResourceChunkReader>& chunkReader)
+	: m_data(nullptr),
+	  m_size(0),
+	  m_pos(0),
+	  m_windowOffset(0),
+	  m_totalSize(chunkReader->getSize()),
+	  m_chunks(new ChunkState())
+{
+	m_chunks->reader = chunkReader;
+}
+
+ByteStream::~ByteStream() = default;
+
+// the window stays valid, it points into data that is not owned by the stream or into the chunk state
+ByteStream::ByteStream(ByteStream&& other) noexcept = default;
+ByteStream& ByteStream::operator=(ByteStream&& other) noexcept = default;
+
+std::uint64_t ByteStream::readVarUInt()
+{
+	std::uint64_t value = 0;
+	for (auto shift = 0U; shift < 64; shift += 7)
+	{
+		const auto byte = static_cast<std::uint8_t>(read<char>());
+
+		// the 10th byte only holds the highest bit of the value
+		if ((shift == 63) && ((byte & 0x7f) > 1))
+		{
+			break;
+		}
+
+		value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+
+		if ((byte & 0x80) == 0)
+		{
+			return value;
+		}
+	}
+
+	throw GameException("ByteStream: invalid variable-length integer at position " + std::to_string(m_pos));
+}
+
+std::int64_t ByteStream::readVarInt()
+{
+	const auto value = readVarUInt();
+	return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+void ByteStream::swapBytes(void* data, std::size_t count, std::size_t width)
 {
+	const auto bytes = static_cast<char*>(data);
+	switch (width)
+	{
+	case 1:
+		break;
+	case 2:
+		swapWords<std::uint16_t>(bytes, count);
+		break;
+	case 4:
+		swapWords<std::uint32_t>(bytes, count);
+		break;
+	case 8:
+		swapWords<std::uint64_t>(bytes, count);
+		break;
+	default:
+		throw GameException("ByteStream: cannot swap the bytes of " + std::to_string(width) + "-byte values");
+	}
 }
 
 char* ByteStream::readString(int size)
 {
-	char* s = new char[size + 1];
-	std::memcpy(&s[0], &m_data[m_pos], size);
-	s[size] = '\0';
+	const auto view = readStringView(static_cast<std::size_t>(size));
 
-	m_pos += size;
+	char* s = new char[view.size() + 1];
+	std::memcpy(&s[0], view.data(), view.size());
+	s[view.size()] = '\0';
 
 	return s;
 }
 
+std::string_view ByteStream::readStringView(std::size_t size)
+{
+	checkRange(size);
+
+	const std::string_view view(&m_data[m_pos], size);
+	m_pos += size;
+
+	return view;
+}
+
+void ByteStream::skip(std::size_t size)
+{
+	if (m_chunks && (size > m_size - m_pos))
+	{
+		readChunked(nullptr, size);
+		return;
+	}
+
+	checkRange(size);
+	m_pos += size;
+}
+
 int ByteStream::getPos() const
 {
-	return m_pos;
+	return static_cast<int>(m_windowOffset + m_pos);
+}
+
+std::size_t ByteStream::getSize() const
+{
+	return m_totalSize;
+}
+
+std::size_t ByteStream::getRemaining() const
+{
+	return m_totalSize - (m_windowOffset + m_pos);
+}
+
+bool ByteStream::isEnd() const
+{
+	return m_windowOffset + m_pos >= m_totalSize;
+}
+
+void ByteStream::fillWindow(std::size_t size)
+{
+	if (!m_chunks)
+	{
+		throwOutOfRange(size);
+	}
+
+	// the unread rest of the window, followed by as many chunks as needed
+	std::vector<char> buffer(m_data + m_pos, m_data + m_size);
+	buffer.reserve(size + m_chunks->reader->getChunkSize());
+
+	m_windowOffset += m_pos;
+
+	while (buffer.size() < size)
+	{
+		const auto chunk = m_chunks->reader->readChunk();
+		if (!chunk.valid())
+		{
+			break;
+		}
+
+		// a chunk that holds the whole value is read in place
+		if (buffer.empty() && (chunk->getSize() >= size))
+		{
+			m_chunks->chunk = chunk;
+			m_chunks->buffer.clear();
+
+			m_data = chunk->getData();
+			m_size = chunk->getSize();
+			m_pos  = 0;
+			return;
+		}
+
+		buffer.insert(buffer.end(), chunk->getData(), chunk->getData() + chunk->getSize());
+	}
+
+	m_chunks->chunk = nullptr;
+	m_chunks->buffer.swap(buffer);
+
+	m_data = m_chunks->buffer.data();
+	m_size = m_chunks->buffer.size();
+	m_pos  = 0;
+
+	if (m_size < size)
+	{
+		throwOutOfRange(size);
+	}
+}
+
+bool ByteStream::nextChunk()
+{
+	const auto chunk = m_chunks->reader->readChunk();
+	if (!chunk.valid())
+	{
+		return false;
+	}
+
+	m_windowOffset += m_size;
+
+	m_chunks->chunk = chunk;
+	m_chunks->buffer.clear();
+
+	m_data = chunk->getData();
+	m_size = chunk->getSize();
+	m_pos  = 0;
+	return true;
+}
+
+void ByteStream::readChunked(void* out, std::size_t size)
+{
+	// copies chunk by chunk instead of assembling the whole range, skips if out is nullptr
+	auto dest      = static_cast<char*>(out);
+	auto remaining = size;
+
+	while (remaining > 0)
+	{
+		if ((m_pos == m_size) && !nextChunk())
+		{
+			throwOutOfRange(remaining);
+		}
+
+		const auto numBytes = std::min(remaining, m_size - m_pos);
+		if (dest)
+		{
+			std::memcpy(dest, m_data + m_pos, numBytes);
+			dest += numBytes;
+		}
+
+		m_pos += numBytes;
+		remaining -= numBytes;
+	}
+}
+
+void ByteStream::throwOutOfRange(std::size_t size) const
+{
+	throw GameException("ByteStream: reading " + std::to_string(size) + " bytes at position " +
+	                    std::to_string(m_windowOffset + m_pos) + " exceeds the size of " +
+	                    std::to_string(m_totalSize) + " bytes");
 }
 
 }
@@ -0,0 +1,58 @@
+#include "CacheUtils.h"
+
+#include <osgHelper/GameException.h>
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace osgHelper
+{
+
+std::string getCacheEntryName(std::uint64_t hash, const std::string& extension)
+{
+  char name[17];
+  std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+
+  return std::string(name) + extension;
+}
+
+void writeFileAtomically(const std::string& filename, const std::function<void(std::ostream&)>& write)
+{
+  static std::atomic<unsigned long> numTemporaryFiles(0);
+
+  const auto temporaryFilename = filename + ".tmp" +
+                                 std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "_" +
+                                 std::to_string(numTemporaryFiles++);
+
+  {
+    std::ofstream stream(temporaryFilename, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open())
+    {
+      throw GameException("Could not create file '" + temporaryFilename + "'");
+    }
+
+    write(stream);
+
+    if (!stream.good())
+    {
+      stream.close();
+
+      std::error_code error;
+      std::filesystem::remove(temporaryFilename, error);
+      throw GameException("Could not write file '" + temporaryFilename + "'");
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporaryFilename, filename, error);
+  if (error)
+  {
+    std::filesystem::remove(temporaryFilename, error);
+    throw GameException("Could not write file '" + filename + "'");
+  }
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace osgHelper
+{
+
+/**
+ * 64 bit FNV-1a, stable across runs and platforms unlike std::hash, for the names and stamps of cache files
+ */
+class Fnv1aHasher
+{
+public:
+  void addBytes(const void* data, std::size_t size)
+  {
+    for (std::size_t i = 0; i < size; i++)
+    {
+      m_hash ^= static_cast<const unsigned char*>(data)[i];
+      m_hash *= 1099511628211ULL;
+    }
+  }
+
+  template <typename T>
+  void addValue(T value)
+  {
+    addBytes(&value, sizeof(value));
+  }
+
+  //! preceded by its size, so that consecutive strings can not be confused
+  void addString(const std::string& str)
+  {
+    addValue(static_cast<std::uint64_t>(str.size()));
+    addBytes(str.data(), str.size());
+  }
+
+  std::uint64_t get() const
+  {
+    return m_hash;
+  }
+
+private:
+  std::uint64_t m_hash = 14695981039346656037ULL;
+
+};
+
+/**
+ * Mixes the hash into the seed, for in-memory hash tables
+ */
+inline void hashCombine(std::size_t& seed, std::size_t hash)
+{
+  seed ^= hash + static_cast<std::size_t>(0x9e3779b97f4a7c15ULL) + (seed << 6) + (seed >> 2);
+}
+
+/**
+ * @return The hash as 16 hex digits followed by the extension
+ */
+std::string getCacheEntryName(std::uint64_t hash, const std::string& extension);
+
+/**
+ * Writes to a temporary file that is renamed to the filename afterwards, so that readers never see partial
+ * entries. Concurrent writers of the same file each use their own temporary file, the last rename wins.
+ * Throws a GameException if the file can not be written.
+ */
+void writeFileAtomically(const std::string& filename, const std::function<void(std::ostream&)>& write);
+
+}
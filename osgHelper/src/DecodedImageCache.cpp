@@ -0,0 +1,284 @@
+#include <osgHelper/DecodedImageCache.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/MappedFile.h>
+
+#include "CacheUtils.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <type_traits>
+#include <vector>
+
+namespace osgHelper
+{
+
+static const char          Magic[4]      = { 'O', 'H', 'I', 'C' };
+static const std::uint32_t Version       = 1;
+static const std::uint64_t PageSize      = 4096;
+static const char*         FileExtension = ".ohimg";
+
+namespace
+{
+
+// written in native byte order, the cache is local to the machine that decoded the images
+struct EntryHeader
+{
+  char          magic[4];
+  std::uint32_t version;
+  std::uint64_t sourceSize;
+  std::int64_t  sourceTime;
+  std::int32_t  s;
+  std::int32_t  t;
+  std::int32_t  r;
+  std::int32_t  internalFormat;
+  std::uint32_t pixelFormat;
+  std::uint32_t dataType;
+  std::uint32_t packing;
+  std::uint32_t numMipmaps;     //!< followed by the mipmap offsets
+  std::uint32_t sourcePathSize; //!< followed by the source path, to detect hash collisions
+  std::uint32_t reserved;
+  std::uint64_t dataOffset;     //!< page-aligned
+  std::uint64_t dataSize;
+};
+
+static_assert(std::is_trivially_copyable<EntryHeader>::value, "EntryHeader is written with memcpy");
+
+struct SourceStamp
+{
+  std::string   path;
+  std::uint64_t size;
+  std::int64_t  time;
+};
+
+bool getSourceStamp(const std::string& filename, SourceStamp& stamp)
+{
+  std::error_code error;
+
+  const auto path = std::filesystem::absolute(filename, error).lexically_normal();
+  if (error)
+  {
+    return false;
+  }
+
+  const auto size = std::filesystem::file_size(path, error);
+  if (error)
+  {
+    return false;
+  }
+
+  const auto time = std::filesystem::last_write_time(path, error);
+  if (error)
+  {
+    return false;
+  }
+
+  stamp.path = path.generic_string();
+  stamp.size = static_cast<std::uint64_t>(size);
+  stamp.time = static_cast<std::int64_t>(time.time_since_epoch().count());
+  return true;
+}
+
+std::string getEntryName(const SourceStamp& stamp)
+{
+  Fnv1aHasher hasher;
+  hasher.addBytes(stamp.path.data(), stamp.path.size());
+  hasher.addValue(stamp.size);
+  hasher.addValue(stamp.time);
+
+  return getCacheEntryName(hasher.get(), FileExtension);
+}
+
+std::uint64_t alignedOffset(std::uint64_t offset)
+{
+  return (offset + PageSize - 1) / PageSize * PageSize;
+}
+
+/**
+ * Keeps the mapping of the entry alive as long as the image uses it
+ */
+class MappedImage : public osg::Image
+{
+public:
+  explicit MappedImage(const osg::ref_ptr<MappedFile>& file)
+    : osg::Image()
+    , m_file(file)
+  {
+  }
+
+private:
+  osg::ref_ptr<MappedFile> m_file;
+
+};
+
+}
+
+struct DecodedImageCache::Impl
+{
+  std::string                directory;
+
+  std::string getEntryFilename(const SourceStamp& stamp) const
+  {
+    return (std::filesystem::path(directory) / getEntryName(stamp)).string();
+  }
+
+};
+
+DecodedImageCache::DecodedImageCache(const std::string& directory)
+  : osg::Referenced()
+  , m(new Impl())
+{
+  m->directory = directory;
+
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  if (error)
+  {
+    throw GameException("Could not create directory '" + directory + "'");
+  }
+}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+const std::string& DecodedImageCache::getDirectory() const
+{
+  return m->directory;
+}
+
+osg::ref_ptr<osg::Image> DecodedImageCache::read(const std::string& sourceFilename) const
+{
+  SourceStamp stamp;
+  if (!getSourceStamp(sourceFilename, stamp))
+  {
+    return nullptr;
+  }
+
+  const auto entryFilename = m->getEntryFilename(stamp);
+
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(entryFilename, error))
+  {
+    return nullptr;
+  }
+
+  osg::ref_ptr<MappedFile> file;
+  try
+  {
+    file = new MappedFile(entryFilename, MappedFile::Access::CopyOnWrite);
+  }
+  catch (const GameException&)
+  {
+    // e.g. removed by clear() in the meantime
+    return nullptr;
+  }
+
+  const auto data = file->getWritableData();
+  const auto size = static_cast<std::uint64_t>(file->getSize());
+
+  EntryHeader header;
+  if (size < sizeof(header))
+  {
+    return nullptr;
+  }
+
+  std::memcpy(&header, data, sizeof(header));
+
+  const auto mipmapOffsetsSize = static_cast<std::uint64_t>(header.numMipmaps) * sizeof(std::uint32_t);
+  const auto sourcePathOffset  = sizeof(header) + mipmapOffsetsSize;
+
+  if ((std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) || (header.version != Version) ||
+      (header.sourceSize != stamp.size) || (header.sourceTime != stamp.time) ||
+      (header.sourcePathSize != stamp.path.size()) ||
+      (sourcePathOffset + header.sourcePathSize > header.dataOffset) ||
+      (header.dataOffset > size) || (header.dataSize > size - header.dataOffset) ||
+      (stamp.path.compare(0, stamp.path.size(), data + sourcePathOffset, header.sourcePathSize) != 0))
+  {
+    return nullptr;
+  }
+
+  osg::Image::MipmapDataType mipmapOffsets(header.numMipmaps);
+  for (std::size_t i = 0; i < mipmapOffsets.size(); i++)
+  {
+    std::uint32_t offset;
+    std::memcpy(&offset, data + sizeof(header) + i * sizeof(offset), sizeof(offset));
+
+    if (offset >= header.dataSize)
+    {
+      return nullptr;
+    }
+
+    mipmapOffsets[i] = offset;
+  }
+
+  // the mapping is copy-on-write, modifying the pixels leaves the entry unchanged
+  const auto pixels = reinterpret_cast<unsigned char*>(data + header.dataOffset);
+
+  osg::ref_ptr<osg::Image> image = new MappedImage(file);
+  image->setImage(header.s, header.t, header.r, header.internalFormat, header.pixelFormat, header.dataType,
+                  pixels, osg::Image::NO_DELETE, static_cast<int>(header.packing));
+  image->setMipmapLevels(mipmapOffsets);
+  image->setFileName(sourceFilename);
+
+  return image;
+}
+
+void DecodedImageCache::write(const std::string& sourceFilename, const osg::Image& image) const
+{
+  SourceStamp stamp;
+  if (!getSourceStamp(sourceFilename, stamp))
+  {
+    throw GameException("Could not determine modification time of file '" + sourceFilename + "'");
+  }
+
+  const auto& mipmapOffsets     = image.getMipmapLevels();
+  const auto  mipmapOffsetsSize = mipmapOffsets.size() * sizeof(std::uint32_t);
+
+  EntryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, Magic, sizeof(Magic));
+
+  header.version        = Version;
+  header.sourceSize     = stamp.size;
+  header.sourceTime     = stamp.time;
+  header.s              = image.s();
+  header.t              = image.t();
+  header.r              = image.r();
+  header.internalFormat = image.getInternalTextureFormat();
+  header.pixelFormat    = image.getPixelFormat();
+  header.dataType       = image.getDataType();
+  header.packing        = image.getPacking();
+  header.numMipmaps     = static_cast<std::uint32_t>(mipmapOffsets.size());
+  header.sourcePathSize = static_cast<std::uint32_t>(stamp.path.size());
+  header.dataOffset     = alignedOffset(sizeof(header) + mipmapOffsetsSize + stamp.path.size());
+  header.dataSize       = image.getTotalSizeInBytesIncludingMipmaps();
+
+  std::vector<char> prefix(static_cast<std::size_t>(header.dataOffset), 0);
+  std::memcpy(prefix.data(), &header, sizeof(header));
+  for (std::size_t i = 0; i < mipmapOffsets.size(); i++)
+  {
+    const auto offset = static_cast<std::uint32_t>(mipmapOffsets[i]);
+    std::memcpy(prefix.data() + sizeof(header) + i * sizeof(offset), &offset, sizeof(offset));
+  }
+
+  std::memcpy(prefix.data() + sizeof(header) + mipmapOffsetsSize, stamp.path.data(), stamp.path.size());
+
+  writeFileAtomically(m->getEntryFilename(stamp), [&](std::ostream& stream)
+  {
+    stream.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+    stream.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(header.dataSize));
+  });
+}
+
+void DecodedImageCache::clear()
+{
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(m->directory, error))
+  {
+    if (entry.is_regular_file() && (entry.path().extension() == FileExtension))
+    {
+      std::filesystem::remove(entry.path(), error);
+    }
+  }
+}
+
+}
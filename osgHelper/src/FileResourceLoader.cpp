@@ -1,6 +1,8 @@
 #include <osgHelper/FileResourceLoader.h>
 #include <osgHelper/GameException.h>
 
+#include <filesystem>
+
 namespace osgHelper
 {
 
@@ -18,4 +20,15 @@ void FileResourceLoader::getResourceStream(const std::string& resourceKey, std::
   stream.seekg(0, stream.beg);
 }
 
+bool FileResourceLoader::hasResource(const std::string& resourceKey)
+{
+  std::error_code error;
+  return std::filesystem::is_regular_file(resourceKey, error);
+}
+
+std::string FileResourceLoader::getResourceFilename(const std::string& resourceKey)
+{
+  return resourceKey;
+}
+
 }  // namespace osgHelper
\ No newline at end of file
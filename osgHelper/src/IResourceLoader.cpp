@@ -0,0 +1,86 @@
+#include <osgHelper/IResourceLoader.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/ResourceCodec.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace osgHelper
+{
+
+osg::ref_ptr<ResourceData> IResourceLoader::getResourceData(const std::string& resourceKey)
+{
+  std::ifstream stream;
+
+  auto length = 0LL;
+  getResourceStream(resourceKey, stream, length);
+
+  // decompress block by block instead of holding the whole compressed resource in memory
+  if (isCompressedResource(resourceKey))
+  {
+    const auto headerSize = static_cast<long long>(ResourceCodec::HeaderSize);
+
+    std::vector<char> header(static_cast<std::size_t>(std::min(length, headerSize)));
+    stream.read(header.data(), static_cast<std::streamsize>(header.size()));
+
+    const auto size = ResourceCodec::getDecompressedSize(header.data(), header.size(),
+                                                         static_cast<std::size_t>(length));
+
+    auto inSize = static_cast<std::size_t>(length) - header.size();
+
+    osg::ref_ptr<ResourceBuffer> buffer = new ResourceBuffer(size);
+    ResourceCodec::decompress(stream, inSize, ResourceCodec::getBlockSize(header.data()), buffer->getBuffer(),
+                              size);
+
+    return buffer;
+  }
+
+  osg::ref_ptr<ResourceBuffer> buffer = new ResourceBuffer(static_cast<std::size_t>(length));
+  stream.read(buffer->getBuffer(), length);
+  stream.close();
+
+  return buffer;
+}
+
+bool IResourceLoader::hasResource(const std::string& resourceKey)
+{
+  std::ifstream stream;
+
+  try
+  {
+    auto length = 0LL;
+    getResourceStream(resourceKey, stream, length);
+  }
+  catch (const GameException&)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+bool IResourceLoader::isCompressedResource(const std::string& resourceKey)
+{
+  return ResourceCodec::hasExtension(resourceKey);
+}
+
+std::string IResourceLoader::getResourceFilename(const std::string&)
+{
+  return std::string();
+}
+
+osg::ref_ptr<ResourceChunkReader> IResourceLoader::openResourceChunks(const std::string& resourceKey,
+                                                                      std::size_t chunkSize,
+                                                                      unsigned int numReadAheadChunks)
+{
+  auto stream = std::make_unique<std::ifstream>();
+
+  auto length = 0LL;
+  getResourceStream(resourceKey, *stream, length);
+
+  return new ResourceChunkReader(std::move(stream), static_cast<std::size_t>(length), chunkSize,
+                                 numReadAheadChunks, isCompressedResource(resourceKey));
+}
+
+}
@@ -0,0 +1,178 @@
+#include <osgHelper/LayeredResourceLoader.h>
+#include <osgHelper/GameException.h>
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace osgHelper
+{
+
+struct LayeredResourceLoader::Impl
+{
+  struct Layer
+  {
+    osg::ref_ptr<IResourceLoader> loader;
+    std::string                   searchPath;
+
+    // keys are case-sensitive here, the layers may be case-sensitive file systems
+    std::unordered_set<std::string> misses;
+    mutable std::shared_mutex       missesMutex;
+  };
+
+  std::vector<std::unique_ptr<Layer>> layers;
+  std::atomic<bool>                   isNegativeCacheEnabled{ true };
+  std::atomic<std::size_t>            maxNegativeCacheSize{ 10000 };
+
+  Layer& getLayerOf(const std::string& resourceKey, int layerIndex)
+  {
+    if (layerIndex < 0)
+    {
+      throw GameException("Could not find resource '" + resourceKey + "'");
+    }
+
+    return *layers[layerIndex];
+  }
+
+};
+
+LayeredResourceLoader::LayeredResourceLoader()
+  : IResourceLoader()
+  , m(new Impl())
+{
+}
+
+LayeredResourceLoader::~LayeredResourceLoader() = default;
+
+void LayeredResourceLoader::addLayer(const osg::ref_ptr<IResourceLoader>& loader, const std::string& searchPath)
+{
+  auto layer        = std::make_unique<Impl::Layer>();
+  layer->loader     = loader;
+  layer->searchPath = searchPath;
+
+  m->layers.push_back(std::move(layer));
+}
+
+unsigned int LayeredResourceLoader::getNumLayers() const
+{
+  return static_cast<unsigned int>(m->layers.size());
+}
+
+void LayeredResourceLoader::setNegativeCacheEnabled(bool enabled)
+{
+  m->isNegativeCacheEnabled = enabled;
+  if (!enabled)
+  {
+    clearNegativeCache();
+  }
+}
+
+bool LayeredResourceLoader::isNegativeCacheEnabled() const
+{
+  return m->isNegativeCacheEnabled;
+}
+
+void LayeredResourceLoader::clearNegativeCache()
+{
+  for (const auto& layer : m->layers)
+  {
+    std::unique_lock<std::shared_mutex> lock(layer->missesMutex);
+    layer->misses.clear();
+  }
+}
+
+void LayeredResourceLoader::setMaxNegativeCacheSize(std::size_t size)
+{
+  m->maxNegativeCacheSize = size;
+}
+
+std::size_t LayeredResourceLoader::getMaxNegativeCacheSize() const
+{
+  return m->maxNegativeCacheSize;
+}
+
+int LayeredResourceLoader::findLayer(const std::string& resourceKey)
+{
+  const auto isNegativeCacheEnabled = m->isNegativeCacheEnabled.load();
+
+  for (auto i = 0U; i < m->layers.size(); i++)
+  {
+    auto& layer = *m->layers[i];
+
+    if (isNegativeCacheEnabled)
+    {
+      std::shared_lock<std::shared_mutex> lock(layer.missesMutex);
+      if (layer.misses.count(resourceKey) > 0)
+      {
+        continue;
+      }
+    }
+
+    if (layer.loader->hasResource(layer.searchPath + resourceKey))
+    {
+      return static_cast<int>(i);
+    }
+
+    if (isNegativeCacheEnabled)
+    {
+      std::unique_lock<std::shared_mutex> lock(layer.missesMutex);
+
+      // e.g. a tool probing many generated names, starting over is cheaper than tracking the oldest miss
+      if (layer.misses.size() >= m->maxNegativeCacheSize)
+      {
+        layer.misses.clear();
+      }
+
+      layer.misses.insert(resourceKey);
+    }
+  }
+
+  return -1;
+}
+
+void LayeredResourceLoader::getResourceStream(const std::string& resourceKey, std::ifstream& stream, long long& length)
+{
+  auto& layer = m->getLayerOf(resourceKey, findLayer(resourceKey));
+  layer.loader->getResourceStream(layer.searchPath + resourceKey, stream, length);
+}
+
+osg::ref_ptr<ResourceData> LayeredResourceLoader::getResourceData(const std::string& resourceKey)
+{
+  auto& layer = m->getLayerOf(resourceKey, findLayer(resourceKey));
+  return layer.loader->getResourceData(layer.searchPath + resourceKey);
+}
+
+bool LayeredResourceLoader::hasResource(const std::string& resourceKey)
+{
+  return findLayer(resourceKey) >= 0;
+}
+
+bool LayeredResourceLoader::isCompressedResource(const std::string& resourceKey)
+{
+  auto& layer = m->getLayerOf(resourceKey, findLayer(resourceKey));
+  return layer.loader->isCompressedResource(layer.searchPath + resourceKey);
+}
+
+std::string LayeredResourceLoader::getResourceFilename(const std::string& resourceKey)
+{
+  const auto layerIndex = findLayer(resourceKey);
+  if (layerIndex < 0)
+  {
+    return std::string();
+  }
+
+  auto& layer = *m->layers[layerIndex];
+  return layer.loader->getResourceFilename(layer.searchPath + resourceKey);
+}
+
+osg::ref_ptr<ResourceChunkReader> LayeredResourceLoader::openResourceChunks(const std::string& resourceKey,
+                                                                            std::size_t chunkSize,
+                                                                            unsigned int numReadAheadChunks)
+{
+  auto& layer = m->getLayerOf(resourceKey, findLayer(resourceKey));
+  return layer.loader->openResourceChunks(layer.searchPath + resourceKey, chunkSize, numReadAheadChunks);
+}
+
+}
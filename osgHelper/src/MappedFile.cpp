@@ -0,0 +1,151 @@
+#include <osgHelper/MappedFile.h>
+#include <osgHelper/GameException.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace osgHelper
+{
+
+#ifdef WIN32
+
+MappedFile::MappedFile(const std::string& filename, Access access)
+  : ResourceData()
+  , m_data(nullptr)
+  , m_size(0)
+  , m_access(access)
+  , m_fileHandle(INVALID_HANDLE_VALUE)
+  , m_mappingHandle(nullptr)
+{
+  m_fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+  if (m_fileHandle == INVALID_HANDLE_VALUE)
+  {
+    throw GameException("Could not open file '" + filename + "'");
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_fileHandle, &size))
+  {
+    CloseHandle(m_fileHandle);
+    throw GameException("Could not determine size of file '" + filename + "'");
+  }
+
+  m_size = static_cast<std::size_t>(size.QuadPart);
+  if (m_size == 0)
+  {
+    return;
+  }
+
+  const auto protection = (access == Access::CopyOnWrite) ? PAGE_WRITECOPY : PAGE_READONLY;
+
+  m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, protection, 0, 0, nullptr);
+  if (m_mappingHandle == nullptr)
+  {
+    CloseHandle(m_fileHandle);
+    throw GameException("Could not map file '" + filename + "'");
+  }
+
+  const auto desiredAccess = (access == Access::CopyOnWrite) ? FILE_MAP_COPY : FILE_MAP_READ;
+
+  m_data = static_cast<char*>(MapViewOfFile(m_mappingHandle, desiredAccess, 0, 0, 0));
+  if (m_data == nullptr)
+  {
+    CloseHandle(m_mappingHandle);
+    CloseHandle(m_fileHandle);
+    throw GameException("Could not map file '" + filename + "'");
+  }
+}
+
+MappedFile::~MappedFile()
+{
+  if (m_data)
+  {
+    UnmapViewOfFile(m_data);
+  }
+
+  if (m_mappingHandle)
+  {
+    CloseHandle(m_mappingHandle);
+  }
+
+  CloseHandle(m_fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename, Access access)
+  : ResourceData()
+  , m_data(nullptr)
+  , m_size(0)
+  , m_access(access)
+{
+  const auto fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw GameException("Could not open file '" + filename + "'");
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0)
+  {
+    close(fd);
+    throw GameException("Could not determine size of file '" + filename + "'");
+  }
+
+  m_size = static_cast<std::size_t>(fileStat.st_size);
+  if (m_size > 0)
+  {
+    // MAP_PRIVATE makes writable mappings copy-on-write
+    const auto protection = (access == Access::CopyOnWrite) ? (PROT_READ | PROT_WRITE) : PROT_READ;
+
+    const auto addr = mmap(nullptr, m_size, protection, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+      close(fd);
+      throw GameException("Could not map file '" + filename + "'");
+    }
+
+    // resources are usually read front to back exactly once
+    madvise(addr, m_size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<char*>(addr);
+  }
+
+  // the mapping stays valid after the descriptor is closed
+  close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+  if (m_data)
+  {
+    munmap(m_data, m_size);
+  }
+}
+
+#endif
+
+const char* MappedFile::getData() const
+{
+  return m_data;
+}
+
+std::size_t MappedFile::getSize() const
+{
+  return m_size;
+}
+
+char* MappedFile::getWritableData()
+{
+  return (m_access == Access::CopyOnWrite) ? m_data : nullptr;
+}
+
+}
@@ -0,0 +1,19 @@
+#include <osgHelper/MappedFileResourceLoader.h>
+#include <osgHelper/MappedFile.h>
+#include <osgHelper/ResourceCodec.h>
+
+namespace osgHelper
+{
+
+osg::ref_ptr<ResourceData> MappedFileResourceLoader::getResourceData(const std::string& resourceKey)
+{
+  osg::ref_ptr<MappedFile> file = new MappedFile(resourceKey);
+  if (isCompressedResource(resourceKey))
+  {
+    return ResourceCodec::decompress(*file);
+  }
+
+  return file;
+}
+
+}
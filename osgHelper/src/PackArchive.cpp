@@ -0,0 +1,198 @@
+#include <osgHelper/PackArchive.h>
+#include <osgHelper/MappedFile.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/Helper.h>
+#include <osgHelper/ResourceCodec.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace osgHelper
+{
+
+template <typename T>
+static T readLittleEndian(const char* data)
+{
+  T value = 0;
+  for (auto i = 0U; i < sizeof(T); i++)
+  {
+    value |= static_cast<T>(static_cast<unsigned char>(data[i])) << (8 * i);
+  }
+
+  return value;
+}
+
+struct PackArchive::Impl
+{
+  struct IndexEntry
+  {
+    std::uint64_t dataOffset;
+    std::uint64_t dataSize;
+    std::uint32_t keyOffset;
+    std::uint32_t keyLength;
+    std::uint32_t flags;
+  };
+
+  IndexEntry getIndexEntry(unsigned int index) const
+  {
+    const auto data = file->getData() + HeaderSize + index * IndexEntrySize;
+
+    IndexEntry entry;
+    entry.dataOffset = readLittleEndian<std::uint64_t>(data);
+    entry.dataSize   = readLittleEndian<std::uint64_t>(data + 8);
+    entry.keyOffset  = readLittleEndian<std::uint32_t>(data + 16);
+    entry.keyLength  = readLittleEndian<std::uint32_t>(data + 20);
+    entry.flags      = readLittleEndian<std::uint32_t>(data + 24);
+
+    return entry;
+  }
+
+  int compareKey(const IndexEntry& entry, const std::string& key) const
+  {
+    const auto entryKey = file->getData() + stringTableOffset + entry.keyOffset;
+    const auto length   = std::min<std::size_t>(entry.keyLength, key.size());
+
+    const auto result = std::memcmp(entryKey, key.data(), length);
+    if (result != 0)
+    {
+      return result;
+    }
+
+    return (entry.keyLength < key.size()) ? -1 : ((entry.keyLength > key.size()) ? 1 : 0);
+  }
+
+  std::string              filename;
+  osg::ref_ptr<MappedFile> file;
+  unsigned int             numEntries        = 0;
+  std::size_t              stringTableOffset = 0;
+
+};
+
+const std::string  PackArchive::Magic          = "OSGHPACK";
+const unsigned int PackArchive::Version        = 2;
+const unsigned int PackArchive::Alignment      = 16;
+const unsigned int PackArchive::HeaderSize     = 24;
+const unsigned int PackArchive::IndexEntrySize = 28;
+const unsigned int PackArchive::CompressedFlag = 1;
+
+PackArchive::PackArchive(const std::string& filename)
+  : osg::Referenced()
+  , m(new Impl())
+{
+  m->filename = filename;
+  m->file     = new MappedFile(filename);
+
+  const auto data = m->file->getData();
+  const auto size = m->file->getSize();
+
+  if ((size < HeaderSize) || (std::memcmp(data, Magic.data(), Magic.size()) != 0))
+  {
+    throw GameException("'" + filename + "' is not a pack file");
+  }
+
+  const auto version = readLittleEndian<std::uint32_t>(data + 8);
+  if (version != Version)
+  {
+    throw GameException("Pack file '" + filename + "' has unsupported version " + std::to_string(version));
+  }
+
+  m->numEntries        = readLittleEndian<std::uint32_t>(data + 12);
+  m->stringTableOffset = HeaderSize + static_cast<std::size_t>(m->numEntries) * IndexEntrySize;
+
+  const auto stringTableSize = readLittleEndian<std::uint64_t>(data + 16);
+  if (m->stringTableOffset + stringTableSize > size)
+  {
+    throw GameException("Pack file '" + filename + "' is truncated");
+  }
+
+  for (auto i = 0U; i < m->numEntries; i++)
+  {
+    const auto entry = m->getIndexEntry(i);
+    if ((entry.dataOffset + entry.dataSize > size) || (entry.keyOffset + entry.keyLength > stringTableSize))
+    {
+      throw GameException("Pack file '" + filename + "' is truncated");
+    }
+  }
+}
+
+PackArchive::~PackArchive() = default;
+
+osg::ref_ptr<ResourceData> PackArchive::getResourceData(const std::string& resourceKey) const
+{
+  std::size_t  offset, size;
+  unsigned int flags;
+  if (!find(resourceKey, offset, size, flags))
+  {
+    return nullptr;
+  }
+
+  osg::ref_ptr<ResourceDataView> data = new ResourceDataView(m->file, offset, size);
+  if ((flags & CompressedFlag) != 0)
+  {
+    return ResourceCodec::decompress(*data);
+  }
+
+  return data;
+}
+
+bool PackArchive::find(const std::string& resourceKey, std::size_t& offset, std::size_t& size) const
+{
+  unsigned int flags;
+  return find(resourceKey, offset, size, flags);
+}
+
+bool PackArchive::find(const std::string& resourceKey, std::size_t& offset, std::size_t& size,
+                       unsigned int& flags) const
+{
+  const auto key = normalizeKey(resourceKey);
+
+  auto first = 0U;
+  auto last  = m->numEntries;
+
+  while (first < last)
+  {
+    const auto middle = first + (last - first) / 2;
+    const auto entry  = m->getIndexEntry(middle);
+    const auto result = m->compareKey(entry, key);
+
+    if (result == 0)
+    {
+      offset = static_cast<std::size_t>(entry.dataOffset);
+      size   = static_cast<std::size_t>(entry.dataSize);
+      flags  = entry.flags;
+      return true;
+    }
+
+    if (result < 0)
+    {
+      first = middle + 1;
+    }
+    else
+    {
+      last = middle;
+    }
+  }
+
+  return false;
+}
+
+const std::string& PackArchive::getFilename() const
+{
+  return m->filename;
+}
+
+unsigned int PackArchive::getNumEntries() const
+{
+  return m->numEntries;
+}
+
+std::string PackArchive::normalizeKey(const std::string& resourceKey)
+{
+  auto key = lowerString(resourceKey);
+  std::replace(key.begin(), key.end(), '\\', '/');
+
+  return key;
+}
+
+}
@@ -0,0 +1,181 @@
+#include <osgHelper/PackArchiveWriter.h>
+#include <osgHelper/PackArchive.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/ResourceCodec.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+namespace osgHelper
+{
+
+template <typename T>
+static void writeLittleEndian(std::ofstream& stream, T value)
+{
+  char bytes[sizeof(T)];
+  for (auto i = 0U; i < sizeof(T); i++)
+  {
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+
+  stream.write(bytes, sizeof(T));
+}
+
+static std::uint64_t alignedOffset(std::uint64_t offset)
+{
+  return (offset + PackArchive::Alignment - 1) / PackArchive::Alignment * PackArchive::Alignment;
+}
+
+struct PackArchiveWriter::Impl
+{
+  // ordered by key, which is the order of the index
+  std::map<std::string, std::vector<char>> entries;
+  bool                                     compressionEnabled = false;
+
+};
+
+PackArchiveWriter::PackArchiveWriter()
+  : m(new Impl())
+{
+}
+
+PackArchiveWriter::~PackArchiveWriter() = default;
+
+void PackArchiveWriter::addData(const std::string& resourceKey, const std::vector<char>& data)
+{
+  m->entries[PackArchive::normalizeKey(resourceKey)] = data;
+}
+
+void PackArchiveWriter::addFile(const std::string& resourceKey, const std::string& filename)
+{
+  std::ifstream stream(filename, std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw GameException("Could not open file '" + filename + "'");
+  }
+
+  stream.seekg(0, stream.end);
+  std::vector<char> data(static_cast<std::size_t>(stream.tellg()));
+  stream.seekg(0, stream.beg);
+
+  stream.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+  addData(resourceKey, data);
+}
+
+void PackArchiveWriter::addDirectory(const std::string& directory, const std::string& keyPrefix)
+{
+  for (const auto& entry : std::filesystem::recursive_directory_iterator(directory))
+  {
+    if (!entry.is_regular_file())
+    {
+      continue;
+    }
+
+    const auto relativePath = std::filesystem::relative(entry.path(), directory).generic_string();
+    addFile(keyPrefix + relativePath, entry.path().string());
+  }
+}
+
+unsigned int PackArchiveWriter::getNumEntries() const
+{
+  return static_cast<unsigned int>(m->entries.size());
+}
+
+void PackArchiveWriter::setCompressionEnabled(bool enabled)
+{
+  m->compressionEnabled = enabled;
+}
+
+bool PackArchiveWriter::isCompressionEnabled() const
+{
+  return m->compressionEnabled;
+}
+
+void PackArchiveWriter::write(const std::string& filename) const
+{
+  std::map<std::string, std::vector<char>> compressedEntries;
+  if (m->compressionEnabled)
+  {
+    for (const auto& entry : m->entries)
+    {
+      auto compressed = ResourceCodec::compress(entry.second.data(), entry.second.size());
+      if (compressed.size() < entry.second.size())
+      {
+        compressedEntries[entry.first] = std::move(compressed);
+      }
+    }
+  }
+
+  // only the entries that got smaller are stored compressed
+  std::map<std::string, const std::vector<char>*> entries;
+  for (const auto& entry : m->entries)
+  {
+    const auto it = compressedEntries.find(entry.first);
+    entries[entry.first] = (it != compressedEntries.end()) ? &it->second : &entry.second;
+  }
+
+  std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+  if (!stream.is_open())
+  {
+    throw GameException("Could not create pack file '" + filename + "'");
+  }
+
+  std::uint64_t stringTableSize = 0;
+  for (const auto& entry : entries)
+  {
+    stringTableSize += entry.first.size();
+  }
+
+  const auto numEntries = static_cast<std::uint32_t>(entries.size());
+  const auto dataBegin  = alignedOffset(PackArchive::HeaderSize +
+                                       static_cast<std::uint64_t>(numEntries) * PackArchive::IndexEntrySize +
+                                       stringTableSize);
+
+  stream.write(PackArchive::Magic.data(), static_cast<std::streamsize>(PackArchive::Magic.size()));
+  writeLittleEndian<std::uint32_t>(stream, PackArchive::Version);
+  writeLittleEndian<std::uint32_t>(stream, numEntries);
+  writeLittleEndian<std::uint64_t>(stream, stringTableSize);
+
+  std::uint64_t dataOffset = dataBegin;
+  std::uint32_t keyOffset  = 0;
+  for (const auto& entry : entries)
+  {
+    const auto isCompressed = compressedEntries.count(entry.first) > 0;
+
+    writeLittleEndian<std::uint64_t>(stream, dataOffset);
+    writeLittleEndian<std::uint64_t>(stream, entry.second->size());
+    writeLittleEndian<std::uint32_t>(stream, keyOffset);
+    writeLittleEndian<std::uint32_t>(stream, static_cast<std::uint32_t>(entry.first.size()));
+    writeLittleEndian<std::uint32_t>(stream, isCompressed ? PackArchive::CompressedFlag : 0U);
+
+    dataOffset = alignedOffset(dataOffset + entry.second->size());
+    keyOffset += static_cast<std::uint32_t>(entry.first.size());
+  }
+
+  for (const auto& entry : entries)
+  {
+    stream.write(entry.first.data(), static_cast<std::streamsize>(entry.first.size()));
+  }
+
+  const char padding[PackArchive::Alignment] = {};
+  auto       position = static_cast<std::uint64_t>(stream.tellp());
+
+  for (const auto& entry : entries)
+  {
+    const auto alignedPosition = alignedOffset(position);
+    stream.write(padding, static_cast<std::streamsize>(alignedPosition - position));
+    stream.write(entry.second->data(), static_cast<std::streamsize>(entry.second->size()));
+
+    position = alignedPosition + entry.second->size();
+  }
+
+  if (!stream.good())
+  {
+    throw GameException("Could not write pack file '" + filename + "'");
+  }
+}
+
+}
@@ -0,0 +1,63 @@
+#include <osgHelper/PackResourceLoader.h>
+#include <osgHelper/GameException.h>
+
+namespace osgHelper
+{
+
+PackResourceLoader::PackResourceLoader(const std::string& packFilename)
+  : IResourceLoader()
+  , m_archive(new PackArchive(packFilename))
+{
+}
+
+PackResourceLoader::~PackResourceLoader() = default;
+
+void PackResourceLoader::getResourceStream(const std::string& resourceKey, std::ifstream& stream, long long& length)
+{
+  std::size_t offset, size;
+  if (!m_archive->find(resourceKey, offset, size))
+  {
+    throw GameException("Could not find resource '" + resourceKey + "'");
+  }
+
+  stream.open(m_archive->getFilename().c_str(), std::ios::binary);
+
+  if (!stream.is_open())
+  {
+    throw GameException("Could not open file '" + m_archive->getFilename() + "'");
+  }
+
+  stream.seekg(static_cast<std::streamoff>(offset), stream.beg);
+  length = static_cast<long long>(size);
+}
+
+osg::ref_ptr<ResourceData> PackResourceLoader::getResourceData(const std::string& resourceKey)
+{
+  auto data = m_archive->getResourceData(resourceKey);
+  if (!data)
+  {
+    throw GameException("Could not find resource '" + resourceKey + "'");
+  }
+
+  return data;
+}
+
+bool PackResourceLoader::hasResource(const std::string& resourceKey)
+{
+  std::size_t offset, size;
+  return m_archive->find(resourceKey, offset, size);
+}
+
+bool PackResourceLoader::isCompressedResource(const std::string& resourceKey)
+{
+  std::size_t  offset, size;
+  unsigned int flags;
+  return m_archive->find(resourceKey, offset, size, flags) && ((flags & PackArchive::CompressedFlag) != 0);
+}
+
+osg::ref_ptr<PackArchive> PackResourceLoader::getArchive() const
+{
+  return m_archive;
+}
+
+}
@@ -0,0 +1,417 @@
+#include <osgHelper/ProgramBinaryCache.h>
+#include <osgHelper/GameException.h>
+
+#include "CacheUtils.h"
+
+#include <osg/GL2Extensions>
+#include <osg/RenderInfo>
+
+#include <utilsLib/Utils.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace osgHelper
+{
+
+static const char          Magic[4]       = { 'O', 'H', 'P', 'B' };
+static const std::uint32_t Version        = 1;
+static const char*         FileExtension  = ".ohprog";
+static const char*         DriverFilename = "driver.txt";
+
+namespace
+{
+
+// written in native byte order, binaries are only valid for the driver that created them anyway
+struct ProgramEntryHeader
+{
+  char          magic[4];
+  std::uint32_t version;
+  std::uint32_t format;
+  std::uint32_t driverStringSize; //!< followed by the driver string, to detect hash collisions
+  std::uint64_t sourceHash;
+  std::uint64_t dataSize;         //!< followed by the binary
+};
+
+static_assert(std::is_trivially_copyable<ProgramEntryHeader>::value, "ProgramEntryHeader is written with memcpy");
+
+std::uint64_t getSourceHash(const osg::Program& program)
+{
+  Fnv1aHasher hasher;
+  hasher.addValue(static_cast<std::uint32_t>(program.getNumShaders()));
+
+  for (auto i = 0U; i < program.getNumShaders(); i++)
+  {
+    const auto shader = program.getShader(i);
+    hasher.addValue(static_cast<std::int32_t>(shader->getType()));
+    hasher.addString(shader->getShaderSource());
+  }
+
+  return hasher.get();
+}
+
+std::string getEntryName(std::uint64_t sourceHash, const std::string& driverString)
+{
+  Fnv1aHasher hasher;
+  hasher.addValue(sourceHash);
+  hasher.addString(driverString);
+
+  return getCacheEntryName(hasher.get(), FileExtension);
+}
+
+std::string queryDriverString()
+{
+  const auto getString = [](GLenum name)
+  {
+    const auto str = glGetString(name);
+    return str ? std::string(reinterpret_cast<const char*>(str)) : std::string();
+  };
+
+  return getString(GL_VENDOR) + " / " + getString(GL_RENDERER) + " / " + getString(GL_VERSION);
+}
+
+void dropProgramBinary(osg::Program& program)
+{
+  program.setProgramBinary(nullptr);
+  program.dirtyProgram();
+}
+
+class ProgramBinaryDrawCallback : public osg::Camera::DrawCallback
+{
+public:
+  explicit ProgramBinaryDrawCallback(const osg::ref_ptr<ProgramBinaryCache>& cache)
+    : osg::Camera::DrawCallback()
+    , m_cache(cache)
+  {
+  }
+
+  void operator()(osg::RenderInfo& renderInfo) const override
+  {
+    m_cache->processPrograms(*renderInfo.getState());
+  }
+
+private:
+  osg::ref_ptr<ProgramBinaryCache> m_cache;
+
+};
+
+}
+
+struct ProgramBinaryCache::Impl
+{
+  struct PreparedProgram
+  {
+    osg::ref_ptr<osg::Program> program;
+    std::string                driverString; //!< of the cached binary, empty if compiled from source
+  };
+
+  std::string                directory;
+
+  std::string        driverString;
+  bool               isDriverStringQueried = false; //!< only accessed by the draw thread
+  mutable std::mutex driverStringMutex;
+
+  std::list<PreparedProgram> programs;
+  std::mutex                 programsMutex;
+
+  Statistics         statistics;
+  mutable std::mutex statisticsMutex;
+
+  std::string getPath(const std::string& filename) const
+  {
+    return (std::filesystem::path(directory) / filename).string();
+  }
+
+  std::string getEntryFilename(std::uint64_t sourceHash, const std::string& driverStr) const
+  {
+    return getPath(getEntryName(sourceHash, driverStr));
+  }
+
+  void removeEntry(const osg::Program& program, const std::string& driverStr) const
+  {
+    std::error_code error;
+    std::filesystem::remove(getEntryFilename(getSourceHash(program), driverStr), error);
+  }
+
+  // returns true when the program does not need to be checked anymore
+  bool processProgram(PreparedProgram& prepared, osg::State& state, bool isSupported, const std::string& driverStr,
+                      const ProgramBinaryCache& cache)
+  {
+    auto&      program         = *prepared.program;
+    const auto hasCachedBinary = !prepared.driverString.empty();
+
+    if (!isSupported)
+    {
+      if (hasCachedBinary)
+      {
+        dropProgramBinary(program);
+      }
+
+      return true;
+    }
+
+    // prepared with the driver string of the previous run before the context was current
+    if (hasCachedBinary && (prepared.driverString != driverStr))
+    {
+      dropProgramBinary(program);
+      prepared.driverString.clear();
+      return false;
+    }
+
+    const auto pcp = program.getPCP(state);
+    if (!pcp || pcp->needsLink())
+    {
+      // not rendered yet
+      return false;
+    }
+
+    if (!pcp->isLinked())
+    {
+      if (!hasCachedBinary)
+      {
+        // the sources do not compile, nothing to store
+        return true;
+      }
+
+      removeEntry(program, prepared.driverString);
+      dropProgramBinary(program);
+      prepared.driverString.clear();
+
+      std::lock_guard<std::mutex> lock(statisticsMutex);
+      statistics.numRejected++;
+      return false;
+    }
+
+    if (hasCachedBinary)
+    {
+      return true;
+    }
+
+    const osg::ref_ptr<osg::Program::ProgramBinary> binary = pcp->compileProgramBinary(state);
+    if (!binary.valid() || (binary->getSize() == 0))
+    {
+      return true;
+    }
+
+    try
+    {
+      cache.write(program, *binary);
+    }
+    catch (const GameException& e)
+    {
+      UTILS_LOG_WARN(std::string("Could not store program binary: ") + e.what());
+      return true;
+    }
+
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    statistics.numStored++;
+    return true;
+  }
+
+};
+
+ProgramBinaryCache::ProgramBinaryCache(const std::string& directory)
+  : osg::Referenced()
+  , m(new Impl())
+{
+  m->directory = directory;
+
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  if (error)
+  {
+    throw GameException("Could not create directory '" + directory + "'");
+  }
+
+  std::ifstream stream(m->getPath(DriverFilename));
+  std::getline(stream, m->driverString);
+}
+
+ProgramBinaryCache::~ProgramBinaryCache() = default;
+
+const std::string& ProgramBinaryCache::getDirectory() const
+{
+  return m->directory;
+}
+
+void ProgramBinaryCache::setDriverString(const std::string& driverString)
+{
+  std::lock_guard<std::mutex> lock(m->driverStringMutex);
+  if (driverString == m->driverString)
+  {
+    return;
+  }
+
+  m->driverString = driverString;
+
+  std::ofstream stream(m->getPath(DriverFilename), std::ios::trunc);
+  stream << driverString << std::endl;
+
+  if (!stream.good())
+  {
+    UTILS_LOG_WARN("Could not write driver string to '" + m->getPath(DriverFilename) + "'");
+  }
+}
+
+std::string ProgramBinaryCache::getDriverString() const
+{
+  std::lock_guard<std::mutex> lock(m->driverStringMutex);
+  return m->driverString;
+}
+
+bool ProgramBinaryCache::prepare(const osg::ref_ptr<osg::Program>& program)
+{
+  const auto driverString = getDriverString();
+
+  osg::ref_ptr<osg::Program::ProgramBinary> binary;
+  if (!driverString.empty())
+  {
+    binary = read(*program);
+  }
+
+  if (binary.valid())
+  {
+    program->setProgramBinary(binary.get());
+
+    std::lock_guard<std::mutex> lock(m->statisticsMutex);
+    m->statistics.numLoaded++;
+  }
+
+  std::lock_guard<std::mutex> lock(m->programsMutex);
+  m->programs.push_back({ program, binary.valid() ? driverString : std::string() });
+
+  return binary.valid();
+}
+
+osg::ref_ptr<osg::Program::ProgramBinary> ProgramBinaryCache::read(const osg::Program& program) const
+{
+  const auto driverString = getDriverString();
+  const auto sourceHash   = getSourceHash(program);
+
+  std::ifstream stream(m->getEntryFilename(sourceHash, driverString), std::ios::binary);
+  if (!stream.is_open())
+  {
+    return nullptr;
+  }
+
+  ProgramEntryHeader header;
+  stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+  if (!stream.good() || (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) || (header.version != Version) ||
+      (header.sourceHash != sourceHash) || (header.driverStringSize != driverString.size()) ||
+      (header.dataSize == 0))
+  {
+    return nullptr;
+  }
+
+  std::string entryDriverString(header.driverStringSize, '\0');
+  stream.read(&entryDriverString[0], static_cast<std::streamsize>(entryDriverString.size()));
+
+  if (!stream.good() || (entryDriverString != driverString))
+  {
+    return nullptr;
+  }
+
+  std::vector<unsigned char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  if (data.size() != header.dataSize)
+  {
+    return nullptr;
+  }
+
+  osg::ref_ptr<osg::Program::ProgramBinary> binary = new osg::Program::ProgramBinary();
+  binary->assign(static_cast<unsigned int>(data.size()), data.data());
+  binary->setFormat(header.format);
+
+  return binary;
+}
+
+void ProgramBinaryCache::write(const osg::Program& program, const osg::Program::ProgramBinary& binary) const
+{
+  const auto driverString = getDriverString();
+  const auto sourceHash   = getSourceHash(program);
+
+  ProgramEntryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, Magic, sizeof(Magic));
+
+  header.version          = Version;
+  header.format           = binary.getFormat();
+  header.driverStringSize = static_cast<std::uint32_t>(driverString.size());
+  header.sourceHash       = sourceHash;
+  header.dataSize         = binary.getSize();
+
+  writeFileAtomically(m->getEntryFilename(sourceHash, driverString), [&](std::ostream& stream)
+  {
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(driverString.data(), static_cast<std::streamsize>(driverString.size()));
+    stream.write(reinterpret_cast<const char*>(binary.getData()), static_cast<std::streamsize>(header.dataSize));
+  });
+}
+
+void ProgramBinaryCache::processPrograms(osg::State& state)
+{
+  {
+    std::lock_guard<std::mutex> lock(m->programsMutex);
+    if (m->programs.empty())
+    {
+      return;
+    }
+  }
+
+  if (!m->isDriverStringQueried)
+  {
+    m->isDriverStringQueried = true;
+    setDriverString(queryDriverString());
+  }
+
+  const auto extensions   = osg::GL2Extensions::Get(state.getContextID(), true);
+  const auto isSupported  = extensions && extensions->isGetProgramBinarySupported;
+  const auto driverString = getDriverString();
+
+  std::lock_guard<std::mutex> lock(m->programsMutex);
+
+  auto it = m->programs.begin();
+  while (it != m->programs.end())
+  {
+    if (m->processProgram(*it, state, isSupported, driverString, *this))
+    {
+      it = m->programs.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+osg::ref_ptr<osg::Camera::DrawCallback> ProgramBinaryCache::createDrawCallback()
+{
+  return new ProgramBinaryDrawCallback(this);
+}
+
+ProgramBinaryCache::Statistics ProgramBinaryCache::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m->statisticsMutex);
+  return m->statistics;
+}
+
+void ProgramBinaryCache::clear()
+{
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(m->directory, error))
+  {
+    if (entry.is_regular_file() && (entry.path().extension() == FileExtension))
+    {
+      std::filesystem::remove(entry.path(), error);
+    }
+  }
+}
+
+}
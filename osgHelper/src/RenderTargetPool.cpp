@@ -0,0 +1,289 @@
+#include <osgHelper/RenderTargetPool.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <utility>
+
+namespace osgHelper
+{
+
+namespace
+{
+
+struct RenderTargetKey
+{
+  int                      width;
+  int                      height;
+  GLint                    internalFormat;
+  osg::Texture::FilterMode filter;
+
+  bool operator<(const RenderTargetKey& rhs) const
+  {
+    return std::tie(width, height, internalFormat, filter) <
+           std::tie(rhs.width, rhs.height, rhs.internalFormat, rhs.filter);
+  }
+};
+
+int roundUp(int value, int granularity)
+{
+  return ((std::max(value, 1) + granularity - 1) / granularity) * granularity;
+}
+
+}
+
+struct RenderTargetPool::Impl
+{
+  Impl(int sizeGranularity, std::size_t maxFreePerKey, std::size_t maxNumFree)
+    : sizeGranularity(std::max(sizeGranularity, 1))
+    , maxFreePerKey(maxFreePerKey)
+    , maxNumFree(maxNumFree)
+    , numFree(0)
+    , useCounter(0)
+  {
+  }
+
+  struct FreeTextureList
+  {
+    std::deque<osg::ref_ptr<osg::Texture2D>> textures;
+    unsigned long long                       lastUse = 0;
+  };
+
+  int         sizeGranularity;
+  std::size_t maxFreePerKey;
+  std::size_t maxNumFree;
+  std::size_t numFree;
+
+  unsigned long long useCounter;
+
+  std::map<RenderTargetKey, FreeTextureList>              freeTextures;
+  std::map<osg::ref_ptr<osg::Texture2D>, RenderTargetKey> texturesInUse;
+
+  Statistics         statistics;
+  mutable std::mutex mutex;
+
+  osg::Vec2i getBucketSize(const osg::Vec2i& size) const
+  {
+    return osg::Vec2i(roundUp(size.x(), sizeGranularity), roundUp(size.y(), sizeGranularity));
+  }
+
+  osg::ref_ptr<osg::Texture2D> takeFreeTexture(const RenderTargetKey& key)
+  {
+    const auto it = freeTextures.find(key);
+    if (it == freeTextures.end())
+    {
+      return nullptr;
+    }
+
+    it->second.lastUse = ++useCounter;
+
+    // textures still referenced elsewhere, e.g. by a state set that has not been updated yet, must not be shared
+    auto& textures = it->second.textures;
+    const auto texIt = std::find_if(textures.begin(), textures.end(),
+      [](const osg::ref_ptr<osg::Texture2D>& texture) { return texture->referenceCount() == 1; });
+
+    if (texIt == textures.end())
+    {
+      return nullptr;
+    }
+
+    auto texture = *texIt;
+    textures.erase(texIt);
+    numFree--;
+
+    if (textures.empty())
+    {
+      freeTextures.erase(it);
+    }
+
+    return texture;
+  }
+
+  void addFreeTexture(const RenderTargetKey& key, const osg::ref_ptr<osg::Texture2D>& texture)
+  {
+    auto& list   = freeTextures[key];
+    list.lastUse = ++useCounter;
+
+    list.textures.push_back(texture);
+    numFree++;
+
+    if (list.textures.size() > maxFreePerKey)
+    {
+      list.textures.pop_front();
+      numFree--;
+    }
+
+    // drops the oldest textures of the least recently used key first
+    while ((numFree > maxNumFree) && !freeTextures.empty())
+    {
+      const auto lruIt = std::min_element(freeTextures.begin(), freeTextures.end(),
+        [](const std::pair<const RenderTargetKey, FreeTextureList>& lhs,
+           const std::pair<const RenderTargetKey, FreeTextureList>& rhs)
+        {
+          return lhs.second.lastUse < rhs.second.lastUse;
+        });
+
+      auto& textures = lruIt->second.textures;
+      if (!textures.empty())
+      {
+        textures.pop_front();
+        numFree--;
+      }
+
+      if (textures.empty())
+      {
+        freeTextures.erase(lruIt);
+      }
+    }
+  }
+
+  void clearFreeTextures()
+  {
+    freeTextures.clear();
+    numFree = 0;
+  }
+
+  static osg::ref_ptr<osg::Texture2D> createTexture(const RenderTargetKey& key)
+  {
+    osg::ref_ptr<osg::Texture2D> texture = new osg::Texture2D();
+
+    texture->setDataVariance(osg::Texture::DataVariance::DYNAMIC);
+    texture->setTextureSize(key.width, key.height);
+    texture->setInternalFormat(key.internalFormat);
+    texture->setFilter(osg::Texture2D::MIN_FILTER, key.filter);
+    texture->setFilter(osg::Texture2D::MAG_FILTER, key.filter);
+    texture->setResizeNonPowerOfTwoHint(false);
+    texture->setWrap(osg::Texture2D::WRAP_S, osg::Texture2D::CLAMP_TO_EDGE);
+    texture->setWrap(osg::Texture2D::WRAP_T, osg::Texture2D::CLAMP_TO_EDGE);
+
+    return texture;
+  }
+};
+
+RenderTargetPool::RenderTargetPool(int sizeGranularity, std::size_t maxFreePerKey, std::size_t maxNumFree)
+  : osg::Referenced()
+  , m(new Impl(sizeGranularity, maxFreePerKey, maxNumFree))
+{
+}
+
+RenderTargetPool::~RenderTargetPool() = default;
+
+void RenderTargetPool::setSizeGranularity(int granularity)
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  // released textures were bucketed with the previous granularity
+  m->sizeGranularity = std::max(granularity, 1);
+  m->clearFreeTextures();
+}
+
+int RenderTargetPool::getSizeGranularity() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  return m->sizeGranularity;
+}
+
+osg::Vec2i RenderTargetPool::getBucketSize(const osg::Vec2i& size) const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  return m->getBucketSize(size);
+}
+
+osg::ref_ptr<osg::Texture2D> RenderTargetPool::acquire(const osg::Vec2i& size, GLint internalFormat,
+                                                       osg::Texture::FilterMode filter)
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->statistics.numAcquires++;
+
+  const auto bucketSize = m->getBucketSize(size);
+  const RenderTargetKey key{ bucketSize.x(), bucketSize.y(), internalFormat, filter };
+
+  auto texture = m->takeFreeTexture(key);
+  if (texture.valid())
+  {
+    m->statistics.numReuses++;
+  }
+  else
+  {
+    texture = Impl::createTexture(key);
+    m->statistics.numAllocations++;
+  }
+
+  m->texturesInUse[texture] = key;
+
+  return texture;
+}
+
+void RenderTargetPool::release(const osg::ref_ptr<osg::Texture2D>& texture)
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  const auto it = m->texturesInUse.find(texture);
+  if (it == m->texturesInUse.end())
+  {
+    return;
+  }
+
+  const auto key = it->second;
+  m->texturesInUse.erase(it);
+
+  // e.g. osgPPU resizes the textures attached to a camera with its viewport
+  if ((texture->getTextureWidth() != key.width) || (texture->getTextureHeight() != key.height))
+  {
+    return;
+  }
+
+  m->addFreeTexture(key, texture);
+}
+
+RenderTargetPool::Statistics RenderTargetPool::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  auto statistics     = m->statistics;
+  statistics.numInUse = m->texturesInUse.size();
+  statistics.numFree  = m->numFree;
+
+  return statistics;
+}
+
+void RenderTargetPool::resetStatistics()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->statistics = Statistics();
+}
+
+void RenderTargetPool::clearUnusedSizes()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  std::set<std::pair<int, int>> sizesInUse;
+  for (const auto& texture : m->texturesInUse)
+  {
+    sizesInUse.emplace(texture.second.width, texture.second.height);
+  }
+
+  for (auto it = m->freeTextures.begin(); it != m->freeTextures.end();)
+  {
+    if (sizesInUse.count(std::make_pair(it->first.width, it->first.height)) == 0)
+    {
+      m->numFree -= it->second.textures.size();
+      it = m->freeTextures.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void RenderTargetPool::clear()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->clearFreeTextures();
+}
+
+}
@@ -2,20 +2,74 @@
 
 namespace osgHelper
 {
-ResizeEventHandler::ResizeEventHandler(const CallbackFunc& func)
+ResizeEventHandler::ResizeEventHandler(const CallbackFunc& func, Mode mode, double quietPeriod)
   : osgGA::GUIEventHandler()
   , m_func(func)
+  , m_mode(mode)
+  , m_quietPeriod(quietPeriod)
+  , m_hasPendingResize(false)
+  , m_lastResizeTime(0.0)
 {
 }
 
 ResizeEventHandler::~ResizeEventHandler() = default;
 
+void ResizeEventHandler::setPendingResizeCallback(const CallbackFunc& func)
+{
+  m_pendingFunc = func;
+}
+
+bool ResizeEventHandler::hasPendingResize() const
+{
+  return m_hasPendingResize;
+}
+
+bool ResizeEventHandler::flush()
+{
+  if (!m_hasPendingResize)
+  {
+    return false;
+  }
+
+  m_hasPendingResize = false;
+  return callFunc(m_pendingSize.x(), m_pendingSize.y());
+}
+
+const ResizeEventHandler::Statistics& ResizeEventHandler::getStatistics() const
+{
+  return m_statistics;
+}
+
 bool ResizeEventHandler::handle(const osgGA::GUIEventAdapter& ea, osgGA::GUIActionAdapter& aa)
 {
   switch (ea.getEventType())
   {
   case osgGA::GUIEventAdapter::RESIZE:
-    return m_func(ea.getWindowWidth(), ea.getWindowHeight());
+  {
+    m_statistics.numResizeEvents++;
+
+    if (m_mode == Mode::Immediate)
+    {
+      return callFunc(ea.getWindowWidth(), ea.getWindowHeight());
+    }
+
+    m_hasPendingResize = true;
+    m_pendingSize      = osg::Vec2i(ea.getWindowWidth(), ea.getWindowHeight());
+    m_lastResizeTime   = ea.getTime();
+
+    return m_pendingFunc ? m_pendingFunc(ea.getWindowWidth(), ea.getWindowHeight()) : true;
+  }
+  case osgGA::GUIEventAdapter::FRAME:
+  {
+    // the RESIZE events of a frame are handled before its FRAME event
+    if (m_hasPendingResize &&
+        ((m_mode == Mode::PerFrame) || (ea.getTime() - m_lastResizeTime >= m_quietPeriod)))
+    {
+      flush();
+    }
+
+    break;
+  }
   default:
     break;
   }
@@ -23,4 +77,10 @@ bool ResizeEventHandler::handle(const osgGA::GUIEventAdapter& ea, osgGA::GUIActi
   return osgGA::GUIEventHandler::handle(ea, aa);
 }
 
+bool ResizeEventHandler::callFunc(int width, int height)
+{
+  m_statistics.numCallbacks++;
+  return m_func(width, height);
+}
+
 }
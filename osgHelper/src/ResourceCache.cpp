@@ -0,0 +1,345 @@
+#include <osgHelper/ResourceCache.h>
+#include <osgHelper/TextResource.h>
+#include <osgHelper/BinaryResource.h>
+
+#include <osg/Image>
+#include <osg/Shader>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace osgHelper
+{
+
+struct ResourceCache::Impl
+{
+  struct Entry
+  {
+    Entry(const osg::ref_ptr<osg::Object>& obj, std::size_t size)
+      : obj(obj)
+      , size(size)
+      , isReferenced(false)
+    {}
+
+    osg::ref_ptr<osg::Object> obj;
+    std::size_t               size;
+
+    // second chance bit of the CLOCK eviction, set on lookups that only hold a shared lock
+    mutable std::atomic<bool> isReferenced;
+  };
+
+  using ResourceDictionary = std::unordered_map<ResourceKey, Entry, ResourceKey::Hash>;
+
+  // aligned to a cache line to avoid false sharing of the counters between shards
+  struct alignas(64) Shard
+  {
+    mutable std::shared_mutex mutex;
+    ResourceDictionary        resources;
+
+    // the clock hand walks through the dictionary in iteration order, it restarts when the table is rehashed
+    ResourceDictionary::iterator clockHand = resources.end();
+
+    mutable std::atomic<unsigned long long> numLookups{ 0 };
+    mutable std::atomic<unsigned long long> numHits{ 0 };
+    mutable std::atomic<unsigned long long> numStores{ 0 };
+    mutable std::atomic<unsigned long long> numContentions{ 0 };
+    mutable std::atomic<unsigned long long> numEvictions{ 0 };
+
+    std::shared_lock<std::shared_mutex> lockShared() const
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex, std::try_to_lock);
+      if (!lock.owns_lock())
+      {
+        numContentions.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+      }
+
+      return lock;
+    }
+
+    std::unique_lock<std::shared_mutex> lockUnique() const
+    {
+      std::unique_lock<std::shared_mutex> lock(mutex, std::try_to_lock);
+      if (!lock.owns_lock())
+      {
+        numContentions.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+      }
+
+      return lock;
+    }
+
+    void erase(ResourceDictionary::iterator it, std::atomic<std::size_t>& totalBytes)
+    {
+      totalBytes -= it->second.size;
+
+      const auto isClockHand = (clockHand == it);
+      const auto next        = resources.erase(it);
+
+      if (isClockHand)
+      {
+        clockHand = next;
+      }
+    }
+
+    // Must be called with the unique lock held. Evicts entries until the total size drops to the budget
+    // or no entry qualifies. Entries that are referenced outside of the cache, have an unknown size or have
+    // been looked up since the last pass of the clock hand are skipped.
+    void evict(std::atomic<std::size_t>& totalBytes, std::size_t budget)
+    {
+      // two full rotations clear all second chance bits
+      auto numSteps = 2 * resources.size();
+      while ((totalBytes > budget) && (numSteps > 0) && !resources.empty())
+      {
+        numSteps--;
+
+        if (clockHand == resources.end())
+        {
+          clockHand = resources.begin();
+        }
+
+        auto& entry = clockHand->second;
+        if (entry.isReferenced.exchange(false) || (entry.size == 0) || (entry.obj.valid() && entry.obj->referenceCount() > 1))
+        {
+          ++clockHand;
+          continue;
+        }
+
+        auto it = clockHand++;
+        erase(it, totalBytes);
+
+        numEvictions.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  explicit Impl(unsigned int numShards)
+    : shards(numShards > 0 ? numShards : 1)
+    , totalBytes(0)
+    , memoryBudget(0)
+  {
+  }
+
+  Shard& shardForKey(const ResourceKey& key)
+  {
+    // the low bits select the bucket within the shard, so use the high bits to select the shard
+    return shards[(key.getHash() >> (sizeof(std::size_t) * 4)) % shards.size()];
+  }
+
+  void enforceMemoryBudget(const Shard* startShard)
+  {
+    const auto budget = memoryBudget.load();
+    if ((budget == 0) || (totalBytes <= budget))
+    {
+      return;
+    }
+
+    // start with the shard that just grew, never hold more than one shard lock at once
+    const auto startIndex = static_cast<std::size_t>(startShard - shards.data());
+    for (auto i = 0U; (i < shards.size()) && (totalBytes > budget); i++)
+    {
+      auto& shard = shards[(startIndex + i) % shards.size()];
+
+      const auto lock = shard.lockUnique();
+      shard.evict(totalBytes, budget);
+    }
+  }
+
+  std::vector<Shard> shards;
+
+  std::atomic<std::size_t> totalBytes;
+  std::atomic<std::size_t> memoryBudget;
+
+};
+
+ResourceCache::ResourceCache(unsigned int numShards)
+  : m(new Impl(numShards))
+{
+}
+
+ResourceCache::~ResourceCache() = default;
+
+osg::ref_ptr<osg::Object> ResourceCache::get(const ResourceKey& key) const
+{
+  auto& shard = m->shardForKey(key);
+  shard.numLookups.fetch_add(1, std::memory_order_relaxed);
+
+  const auto lock = shard.lockShared();
+
+  const auto it = shard.resources.find(key);
+  if (it == shard.resources.end())
+  {
+    return nullptr;
+  }
+
+  it->second.isReferenced.store(true, std::memory_order_relaxed);
+
+  shard.numHits.fetch_add(1, std::memory_order_relaxed);
+  return it->second.obj;
+}
+
+osg::ref_ptr<osg::Object> ResourceCache::store(const ResourceKey& key, const osg::ref_ptr<osg::Object>& obj)
+{
+  auto& shard = m->shardForKey(key);
+  shard.numStores.fetch_add(1, std::memory_order_relaxed);
+
+  osg::ref_ptr<osg::Object> cachedObj;
+  {
+    const auto lock = shard.lockUnique();
+
+    const auto size        = estimateSize(obj.get());
+    const auto bucketCount = shard.resources.bucket_count();
+    const auto result      = shard.resources.emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                                                     std::forward_as_tuple(obj, size));
+
+    if (result.second)
+    {
+      m->totalBytes += size;
+    }
+
+    if (shard.resources.bucket_count() != bucketCount)
+    {
+      shard.clockHand = shard.resources.end();
+    }
+
+    cachedObj = result.first->second.obj;
+  }
+
+  m->enforceMemoryBudget(&shard);
+
+  return cachedObj;
+}
+
+bool ResourceCache::replace(const ResourceKey& key, const osg::ref_ptr<osg::Object>& obj)
+{
+  auto& shard = m->shardForKey(key);
+  {
+    const auto lock = shard.lockUnique();
+
+    const auto it = shard.resources.find(key);
+    if (it == shard.resources.end())
+    {
+      return false;
+    }
+
+    const auto size = estimateSize(obj.get());
+    m->totalBytes -= it->second.size;
+    m->totalBytes += size;
+
+    it->second.obj  = obj;
+    it->second.size = size;
+  }
+
+  m->enforceMemoryBudget(&shard);
+
+  return true;
+}
+
+bool ResourceCache::remove(const ResourceKey& key)
+{
+  auto& shard = m->shardForKey(key);
+
+  const auto lock = shard.lockUnique();
+
+  const auto it = shard.resources.find(key);
+  if (it == shard.resources.end())
+  {
+    return false;
+  }
+
+  shard.erase(it, m->totalBytes);
+  return true;
+}
+
+void ResourceCache::clear()
+{
+  for (auto& shard : m->shards)
+  {
+    const auto lock = shard.lockUnique();
+    while (!shard.resources.empty())
+    {
+      shard.erase(shard.resources.begin(), m->totalBytes);
+    }
+  }
+}
+
+void ResourceCache::setMemoryBudget(std::size_t bytes)
+{
+  m->memoryBudget = bytes;
+
+  if (!m->shards.empty())
+  {
+    m->enforceMemoryBudget(&m->shards.front());
+  }
+}
+
+std::size_t ResourceCache::getMemoryBudget() const
+{
+  return m->memoryBudget;
+}
+
+unsigned int ResourceCache::getNumShards() const
+{
+  return static_cast<unsigned int>(m->shards.size());
+}
+
+ResourceCache::Statistics ResourceCache::getStatistics() const
+{
+  Statistics stats;
+  for (const auto& shard : m->shards)
+  {
+    stats.numLookups += shard.numLookups.load(std::memory_order_relaxed);
+    stats.numHits += shard.numHits.load(std::memory_order_relaxed);
+    stats.numStores += shard.numStores.load(std::memory_order_relaxed);
+    stats.numContentions += shard.numContentions.load(std::memory_order_relaxed);
+    stats.numEvictions += shard.numEvictions.load(std::memory_order_relaxed);
+  }
+
+  stats.numMisses = stats.numLookups - stats.numHits;
+  stats.numBytes  = m->totalBytes;
+
+  return stats;
+}
+
+void ResourceCache::resetStatistics()
+{
+  for (auto& shard : m->shards)
+  {
+    shard.numLookups     = 0;
+    shard.numHits        = 0;
+    shard.numStores      = 0;
+    shard.numContentions = 0;
+    shard.numEvictions   = 0;
+  }
+}
+
+std::size_t ResourceCache::estimateSize(const osg::Object* obj)
+{
+  if (const auto image = dynamic_cast<const osg::Image*>(obj))
+  {
+    return image->getTotalSizeInBytesIncludingMipmaps();
+  }
+
+  if (const auto textRes = dynamic_cast<const TextResource*>(obj))
+  {
+    return textRes->text.size();
+  }
+
+  if (const auto binRes = dynamic_cast<const BinaryResource*>(obj))
+  {
+    return binRes->getSize();
+  }
+
+  if (const auto shader = dynamic_cast<const osg::Shader*>(obj))
+  {
+    return shader->getShaderSource().size();
+  }
+
+  return 0;
+}
+
+}
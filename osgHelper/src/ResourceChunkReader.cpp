@@ -0,0 +1,215 @@
+#include <osgHelper/ResourceChunkReader.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/ResourceCodec.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osgHelper
+{
+
+const std::size_t  ResourceChunkReader::DefaultChunkSize          = 1024 * 1024;
+const unsigned int ResourceChunkReader::DefaultNumReadAheadChunks = 2;
+
+struct ResourceChunkReader::Impl
+{
+  std::unique_ptr<std::istream> stream;
+
+  std::size_t  size               = 0;
+  std::size_t  chunkSize          = 0;
+  std::size_t  offset             = 0; //!< decompressed bytes read from the stream so far
+  std::size_t  inSize             = 0; //!< compressed bytes left in the stream
+  unsigned int numReadAheadChunks = 0;
+  bool         isCompressed       = false;
+
+  std::deque<osg::ref_ptr<ResourceData>> chunks;
+  std::exception_ptr                     error;
+  bool                                   isFinished = false;
+  bool                                   isStopping = false;
+
+  std::mutex              mutex;
+  std::condition_variable chunkRead;
+  std::condition_variable chunkTaken;
+  std::thread             thread;
+
+  osg::ref_ptr<ResourceData> readNextChunk()
+  {
+    if (offset == size)
+    {
+      return nullptr;
+    }
+
+    const auto numBytes = std::min(chunkSize, size - offset);
+
+    osg::ref_ptr<ResourceBuffer> chunk = new ResourceBuffer(numBytes);
+    if (isCompressed)
+    {
+      ResourceCodec::decompress(*stream, inSize, chunkSize, chunk->getBuffer(), numBytes);
+    }
+    else if (!stream->read(chunk->getBuffer(), static_cast<std::streamsize>(numBytes)))
+    {
+      throw GameException("Could not read " + std::to_string(numBytes) + " bytes at offset " +
+                          std::to_string(offset) + " of a resource");
+    }
+
+    offset += numBytes;
+    return chunk;
+  }
+
+  void readAhead()
+  {
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        chunkTaken.wait(lock, [this]() { return isStopping || (chunks.size() < numReadAheadChunks); });
+
+        if (isStopping)
+        {
+          return;
+        }
+      }
+
+      osg::ref_ptr<ResourceData> chunk;
+      std::exception_ptr         chunkError;
+
+      try
+      {
+        chunk = readNextChunk();
+      }
+      catch (...)
+      {
+        chunkError = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (chunk.valid())
+        {
+          chunks.push_back(chunk);
+        }
+        else
+        {
+          error      = chunkError;
+          isFinished = true;
+        }
+      }
+
+      chunkRead.notify_one();
+
+      if (!chunk.valid())
+      {
+        return;
+      }
+    }
+  }
+
+};
+
+ResourceChunkReader::ResourceChunkReader(std::unique_ptr<std::istream> stream, std::size_t size,
+                                         std::size_t chunkSize, unsigned int numReadAheadChunks,
+                                         bool isCompressed)
+  : osg::Referenced()
+  , m(new Impl())
+{
+  if (chunkSize == 0)
+  {
+    throw GameException("Invalid chunk size 0");
+  }
+
+  m->stream             = std::move(stream);
+  m->size               = size;
+  m->chunkSize          = chunkSize;
+  m->numReadAheadChunks = numReadAheadChunks;
+
+  if (isCompressed)
+  {
+    std::vector<char> header(std::min(size, ResourceCodec::HeaderSize));
+    if (!m->stream->read(header.data(), static_cast<std::streamsize>(header.size())))
+    {
+      throw GameException("Could not read resource header");
+    }
+
+    // the stream stays behind the header, the blocks follow
+    m->isCompressed = true;
+    m->inSize       = size - header.size();
+    m->size         = ResourceCodec::getDecompressedSize(header.data(), header.size(), size);
+    m->chunkSize    = ResourceCodec::getBlockSize(header.data());
+
+    if (m->chunkSize == 0)
+    {
+      throw GameException("Compressed resource is corrupt");
+    }
+  }
+
+  if (numReadAheadChunks > 0)
+  {
+    m->thread = std::thread([this]() { m->readAhead(); });
+  }
+}
+
+ResourceChunkReader::~ResourceChunkReader()
+{
+  if (m->thread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(m->mutex);
+      m->isStopping = true;
+    }
+
+    m->chunkTaken.notify_one();
+    m->thread.join();
+  }
+}
+
+osg::ref_ptr<ResourceData> ResourceChunkReader::readChunk()
+{
+  if (m->numReadAheadChunks == 0)
+  {
+    return m->readNextChunk();
+  }
+
+  osg::ref_ptr<ResourceData> chunk;
+  {
+    std::unique_lock<std::mutex> lock(m->mutex);
+    m->chunkRead.wait(lock, [this]() { return !m->chunks.empty() || m->isFinished; });
+
+    if (m->chunks.empty())
+    {
+      if (m->error)
+      {
+        std::rethrow_exception(m->error);
+      }
+
+      return nullptr;
+    }
+
+    chunk = m->chunks.front();
+    m->chunks.pop_front();
+  }
+
+  m->chunkTaken.notify_one();
+  return chunk;
+}
+
+std::size_t ResourceChunkReader::getSize() const
+{
+  return m->size;
+}
+
+std::size_t ResourceChunkReader::getChunkSize() const
+{
+  return m->chunkSize;
+}
+
+bool ResourceChunkReader::isCompressed() const
+{
+  return m->isCompressed;
+}
+
+}
@@ -0,0 +1,430 @@
+#include <osgHelper/ResourceCodec.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/Helper.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace osgHelper
+{
+
+static const char          Magic[4]       = { 'O', 'H', 'Z', '1' };
+static const std::uint32_t StoredFlag     = 0x80000000U;
+static const std::size_t   MinMatchLength = 4;
+static const std::size_t   MaxOffset      = 0xffff;
+static const unsigned int  HashBits       = 14;
+
+template <typename T>
+static T readLittleEndian(const char* data)
+{
+  T value = 0;
+  for (auto i = 0U; i < sizeof(T); i++)
+  {
+    value |= static_cast<T>(static_cast<unsigned char>(data[i])) << (8 * i);
+  }
+
+  return value;
+}
+
+template <typename T>
+static void writeLittleEndian(std::vector<char>& out, T value)
+{
+  for (auto i = 0U; i < sizeof(T); i++)
+  {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+static std::uint32_t read32(const unsigned char* data)
+{
+  std::uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static void writeLength(std::vector<char>& out, std::size_t length)
+{
+  while (length >= 255)
+  {
+    out.push_back(static_cast<char>(255));
+    length -= 255;
+  }
+
+  out.push_back(static_cast<char>(length));
+}
+
+static void writeSequence(std::vector<char>& out, const unsigned char* literals, std::size_t numLiterals,
+                          std::size_t offset, std::size_t matchLength)
+{
+  const auto literalToken = (numLiterals >= 15) ? 15 : numLiterals;
+  const auto matchToken   = (matchLength == 0) ? 0 :
+                            ((matchLength - MinMatchLength >= 15) ? 15 : matchLength - MinMatchLength);
+
+  out.push_back(static_cast<char>((literalToken << 4) | matchToken));
+  if (literalToken == 15)
+  {
+    writeLength(out, numLiterals - 15);
+  }
+
+  out.insert(out.end(), literals, literals + numLiterals);
+
+  if (matchLength == 0)
+  {
+    return;
+  }
+
+  out.push_back(static_cast<char>(offset & 0xff));
+  out.push_back(static_cast<char>(offset >> 8));
+
+  if (matchToken == 15)
+  {
+    writeLength(out, matchLength - MinMatchLength - 15);
+  }
+}
+
+static void compressBlock(const unsigned char* data, std::size_t size, std::vector<char>& out)
+{
+  std::vector<std::int32_t> hashTable(1 << HashBits, -1);
+
+  std::size_t anchor = 0;
+  std::size_t pos    = 0;
+  std::size_t misses = 0;
+
+  while (pos + MinMatchLength <= size)
+  {
+    const auto sequence  = read32(data + pos);
+    const auto hash      = (sequence * 2654435761U) >> (32 - HashBits);
+    const auto candidate = hashTable[hash];
+
+    hashTable[hash] = static_cast<std::int32_t>(pos);
+
+    if ((candidate < 0) || (pos - candidate > MaxOffset) || (read32(data + candidate) != sequence))
+    {
+      // skip faster through data that does not compress
+      pos += 1 + (misses++ >> 6);
+      continue;
+    }
+
+    auto matchLength = MinMatchLength;
+    while ((pos + matchLength < size) && (data[candidate + matchLength] == data[pos + matchLength]))
+    {
+      matchLength++;
+    }
+
+    writeSequence(out, data + anchor, pos - anchor, pos - candidate, matchLength);
+
+    pos += matchLength;
+    anchor = pos;
+    misses = 0;
+  }
+
+  writeSequence(out, data + anchor, size - anchor, 0, 0);
+}
+
+[[noreturn]] static void throwCorrupt()
+{
+  throw GameException("Compressed resource is corrupt");
+}
+
+static std::size_t readLength(const unsigned char*& in, const unsigned char* inEnd)
+{
+  std::size_t length = 0;
+  unsigned char byte;
+
+  do
+  {
+    if (in == inEnd)
+    {
+      throwCorrupt();
+    }
+
+    byte = *in++;
+    length += byte;
+  } while (byte == 255);
+
+  return length;
+}
+
+static void decompressBlock(const unsigned char* in, std::size_t inSize, unsigned char* out, std::size_t outSize)
+{
+  const auto inEnd    = in + inSize;
+  const auto outBegin = out;
+  const auto outEnd   = out + outSize;
+
+  while (in < inEnd)
+  {
+    const auto token = *in++;
+
+    std::size_t numLiterals = token >> 4;
+    if (numLiterals == 15)
+    {
+      numLiterals += readLength(in, inEnd);
+    }
+
+    if ((numLiterals > static_cast<std::size_t>(inEnd - in)) ||
+        (numLiterals > static_cast<std::size_t>(outEnd - out)))
+    {
+      throwCorrupt();
+    }
+
+    std::memcpy(out, in, numLiterals);
+    in += numLiterals;
+    out += numLiterals;
+
+    if (in == inEnd)
+    {
+      break;
+    }
+
+    if (inEnd - in < 2)
+    {
+      throwCorrupt();
+    }
+
+    const std::size_t offset = in[0] | (in[1] << 8);
+    in += 2;
+
+    std::size_t matchLength = (token & 0x0f) + MinMatchLength;
+    if ((token & 0x0f) == 15)
+    {
+      matchLength += readLength(in, inEnd);
+    }
+
+    if ((offset == 0) || (offset > static_cast<std::size_t>(out - outBegin)) ||
+        (matchLength > static_cast<std::size_t>(outEnd - out)))
+    {
+      throwCorrupt();
+    }
+
+    const auto match = out - offset;
+    if (offset >= matchLength)
+    {
+      std::memcpy(out, match, matchLength);
+    }
+    else
+    {
+      // overlapping copy repeats the last offset bytes
+      for (std::size_t i = 0; i < matchLength; i++)
+      {
+        out[i] = match[i];
+      }
+    }
+
+    out += matchLength;
+  }
+
+  if (out != outEnd)
+  {
+    throwCorrupt();
+  }
+}
+
+const std::string ResourceCodec::Extension         = ".ohz";
+const std::size_t ResourceCodec::HeaderSize        = 16;
+const std::size_t ResourceCodec::DefaultBlockSize  = 256 * 1024;
+const std::size_t ResourceCodec::MaxExpansionRatio = 256;
+
+std::vector<char> ResourceCodec::compress(const char* data, std::size_t size, std::size_t blockSize)
+{
+  if ((blockSize == 0) || (blockSize >= StoredFlag))
+  {
+    throw GameException("Invalid compression block size " + std::to_string(blockSize));
+  }
+
+  std::vector<char> out(Magic, Magic + sizeof(Magic));
+  out.reserve(HeaderSize + size / 2);
+
+  writeLittleEndian<std::uint32_t>(out, static_cast<std::uint32_t>(blockSize));
+  writeLittleEndian<std::uint64_t>(out, size);
+
+  std::vector<char> block;
+  for (std::size_t offset = 0; offset < size; offset += blockSize)
+  {
+    const auto blockBegin = reinterpret_cast<const unsigned char*>(data + offset);
+    const auto blockBytes = std::min(blockSize, size - offset);
+
+    block.clear();
+    compressBlock(blockBegin, blockBytes, block);
+
+    if (block.size() < blockBytes)
+    {
+      writeLittleEndian<std::uint32_t>(out, static_cast<std::uint32_t>(block.size()));
+      out.insert(out.end(), block.begin(), block.end());
+    }
+    else
+    {
+      writeLittleEndian<std::uint32_t>(out, static_cast<std::uint32_t>(blockBytes) | StoredFlag);
+      out.insert(out.end(), blockBegin, blockBegin + blockBytes);
+    }
+  }
+
+  return out;
+}
+
+bool ResourceCodec::isCompressed(const char* data, std::size_t size)
+{
+  return (size >= HeaderSize) && (std::memcmp(data, Magic, sizeof(Magic)) == 0);
+}
+
+std::size_t ResourceCodec::getDecompressedSize(const char* data, std::size_t size)
+{
+  return getDecompressedSize(data, size, size);
+}
+
+std::size_t ResourceCodec::getDecompressedSize(const char* header, std::size_t headerSize, std::size_t compressedSize)
+{
+  if (!isCompressed(header, headerSize) || (compressedSize < HeaderSize))
+  {
+    throw GameException("Resource is not compressed");
+  }
+
+  // a sequence of a few bytes expands to at most 255 bytes per length byte, stored blocks do not expand at all
+  const auto size    = readLittleEndian<std::uint64_t>(header + 8);
+  const auto maxSize = static_cast<std::uint64_t>(compressedSize - HeaderSize) * MaxExpansionRatio;
+
+  if ((size > maxSize) || (size > std::numeric_limits<std::size_t>::max()))
+  {
+    throwCorrupt();
+  }
+
+  return static_cast<std::size_t>(size);
+}
+
+std::size_t ResourceCodec::getBlockSize(const char* header)
+{
+  return readLittleEndian<std::uint32_t>(header + 4);
+}
+
+bool ResourceCodec::hasExtension(const std::string& resourceKey)
+{
+  return (resourceKey.size() > Extension.size()) &&
+         (lowerString(resourceKey.substr(resourceKey.size() - Extension.size())) == Extension);
+}
+
+std::string ResourceCodec::stripExtension(const std::string& resourceKey)
+{
+  return hasExtension(resourceKey) ? resourceKey.substr(0, resourceKey.size() - Extension.size()) : resourceKey;
+}
+
+void ResourceCodec::decompress(const char* data, std::size_t size, char* out, std::size_t outSize)
+{
+  if (getDecompressedSize(data, size) != outSize)
+  {
+    throwCorrupt();
+  }
+
+  const auto blockSize = getBlockSize(data);
+  auto       in        = data + HeaderSize;
+  const auto inEnd     = data + size;
+
+  if (blockSize == 0)
+  {
+    throwCorrupt();
+  }
+
+  for (std::size_t offset = 0; offset < outSize; offset += blockSize)
+  {
+    if (inEnd - in < 4)
+    {
+      throwCorrupt();
+    }
+
+    const auto blockHeader = readLittleEndian<std::uint32_t>(in);
+    const auto blockBytes  = std::min(blockSize, outSize - offset);
+    const auto inBytes     = static_cast<std::size_t>(blockHeader & ~StoredFlag);
+    in += 4;
+
+    if (inBytes > static_cast<std::size_t>(inEnd - in))
+    {
+      throwCorrupt();
+    }
+
+    if ((blockHeader & StoredFlag) != 0)
+    {
+      if (inBytes != blockBytes)
+      {
+        throwCorrupt();
+      }
+
+      std::memcpy(out + offset, in, blockBytes);
+    }
+    else
+    {
+      decompressBlock(reinterpret_cast<const unsigned char*>(in), inBytes,
+                      reinterpret_cast<unsigned char*>(out + offset), blockBytes);
+    }
+
+    in += inBytes;
+  }
+}
+
+osg::ref_ptr<ResourceBuffer> ResourceCodec::decompress(const ResourceData& data)
+{
+  const auto size = getDecompressedSize(data.getData(), data.getSize());
+
+  osg::ref_ptr<ResourceBuffer> buffer = new ResourceBuffer(size);
+  decompress(data.getData(), data.getSize(), buffer->getBuffer(), size);
+
+  return buffer;
+}
+
+void ResourceCodec::decompress(std::istream& stream, std::size_t& inSize, std::size_t blockSize, char* out,
+                               std::size_t outSize)
+{
+  if (blockSize == 0)
+  {
+    throwCorrupt();
+  }
+
+  std::vector<char> block;
+  for (std::size_t offset = 0; offset < outSize; offset += blockSize)
+  {
+    char blockHeaderBytes[4];
+    if ((inSize < sizeof(blockHeaderBytes)) || !stream.read(blockHeaderBytes, sizeof(blockHeaderBytes)))
+    {
+      throwCorrupt();
+    }
+
+    const auto blockHeader = readLittleEndian<std::uint32_t>(blockHeaderBytes);
+    const auto blockBytes  = std::min(blockSize, outSize - offset);
+    const auto inBytes     = static_cast<std::size_t>(blockHeader & ~StoredFlag);
+
+    inSize -= sizeof(blockHeaderBytes);
+    if (inBytes > inSize)
+    {
+      throwCorrupt();
+    }
+
+    inSize -= inBytes;
+
+    if ((blockHeader & StoredFlag) != 0)
+    {
+      if ((inBytes != blockBytes) || !stream.read(out + offset, static_cast<std::streamsize>(blockBytes)))
+      {
+        throwCorrupt();
+      }
+
+      continue;
+    }
+
+    // a compressed block is never larger than the block size, otherwise it would have been stored
+    if (inBytes >= blockBytes)
+    {
+      throwCorrupt();
+    }
+
+    block.resize(inBytes);
+    if (!stream.read(block.data(), static_cast<std::streamsize>(inBytes)))
+    {
+      throwCorrupt();
+    }
+
+    decompressBlock(reinterpret_cast<const unsigned char*>(block.data()), inBytes,
+                    reinterpret_cast<unsigned char*>(out + offset), blockBytes);
+  }
+}
+
+}
@@ -0,0 +1,113 @@
+#include <osgHelper/ResourceData.h>
+
+namespace osgHelper
+{
+
+ResourceBuffer::ResourceBuffer(std::size_t size)
+  : ResourceData()
+  , m_bytes(new char[size])
+  , m_size(size)
+{
+}
+
+ResourceBuffer::ResourceBuffer(char* bytes, std::size_t size)
+  : ResourceData()
+  , m_bytes(bytes)
+  , m_size(size)
+{
+}
+
+ResourceBuffer::~ResourceBuffer() = default;
+
+const char* ResourceBuffer::getData() const
+{
+  return m_bytes.get();
+}
+
+std::size_t ResourceBuffer::getSize() const
+{
+  return m_size;
+}
+
+char* ResourceBuffer::getBuffer()
+{
+  return m_bytes.get();
+}
+
+ResourceDataView::ResourceDataView(const osg::ref_ptr<const ResourceData>& parent, std::size_t offset,
+                                   std::size_t size)
+  : ResourceData()
+  , m_parent(parent)
+  , m_offset(offset)
+  , m_size(size)
+{
+}
+
+ResourceDataView::~ResourceDataView() = default;
+
+const char* ResourceDataView::getData() const
+{
+  return m_parent->getData() + m_offset;
+}
+
+std::size_t ResourceDataView::getSize() const
+{
+  return m_size;
+}
+
+ResourceDataStream::StreamBuffer::StreamBuffer(const ResourceData& data)
+  : std::streambuf()
+{
+  // the get area is never written to, std::streambuf just lacks a const interface
+  auto begin = const_cast<char*>(data.getData());
+  setg(begin, begin, begin + data.getSize());
+}
+
+ResourceDataStream::StreamBuffer::pos_type ResourceDataStream::StreamBuffer::seekoff(
+  off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+  if ((which & std::ios_base::in) == 0)
+  {
+    return pos_type(off_type(-1));
+  }
+
+  off_type base = 0;
+  switch (dir)
+  {
+  case std::ios_base::cur:
+    base = gptr() - eback();
+    break;
+  case std::ios_base::end:
+    base = egptr() - eback();
+    break;
+  default:
+    break;
+  }
+
+  const auto pos = base + off;
+  if ((pos < 0) || (pos > egptr() - eback()))
+  {
+    return pos_type(off_type(-1));
+  }
+
+  setg(eback(), eback() + pos, egptr());
+  return pos_type(pos);
+}
+
+ResourceDataStream::StreamBuffer::pos_type ResourceDataStream::StreamBuffer::seekpos(
+  pos_type pos, std::ios_base::openmode which)
+{
+  return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+ResourceDataStream::ResourceDataStream(const osg::ref_ptr<ResourceData>& data)
+  : std::istream(nullptr)
+  , m_data(data)
+  , m_buffer(*data)
+{
+  rdbuf(&m_buffer);
+}
+
+ResourceDataStream::~ResourceDataStream() = default;
+
+}
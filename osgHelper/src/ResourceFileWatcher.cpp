@@ -0,0 +1,218 @@
+#include <osgHelper/ResourceFileWatcher.h>
+#include <osgHelper/GameException.h>
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace osgHelper
+{
+
+static std::string normalizePath(const std::string& filename)
+{
+  std::error_code error;
+  const auto      path = std::filesystem::absolute(filename, error);
+
+  return error ? filename : path.lexically_normal().string();
+}
+
+struct ResourceFileWatcher::Impl
+{
+  struct WatchedFile
+  {
+    std::string                     filename; //!< as passed to watch()
+    std::filesystem::file_time_type lastWriteTime;
+  };
+
+  // by normalized path
+  std::map<std::string, WatchedFile> files;
+  mutable std::mutex                 mutex;
+
+#ifdef __linux__
+  struct WatchedDirectory
+  {
+    int descriptor;
+    int numFiles;
+  };
+
+  int                                     inotifyDescriptor = -1;
+  std::map<std::string, WatchedDirectory> directories; //!< by path
+  std::map<int, std::string>              directoryPaths; //!< by watch descriptor
+
+  void addDirectory(const std::string& directory)
+  {
+    auto it = directories.find(directory);
+    if (it != directories.end())
+    {
+      it->second.numFiles++;
+      return;
+    }
+
+    const auto descriptor = inotify_add_watch(inotifyDescriptor, directory.c_str(),
+                                              IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (descriptor < 0)
+    {
+      throw GameException("Could not watch directory '" + directory + "': " + std::strerror(errno));
+    }
+
+    directories[directory]     = { descriptor, 1 };
+    directoryPaths[descriptor] = directory;
+  }
+
+  void removeDirectory(const std::string& directory)
+  {
+    auto it = directories.find(directory);
+    if ((it == directories.end()) || (--it->second.numFiles > 0))
+    {
+      return;
+    }
+
+    inotify_rm_watch(inotifyDescriptor, it->second.descriptor);
+    directoryPaths.erase(it->second.descriptor);
+    directories.erase(it);
+  }
+#endif
+
+};
+
+ResourceFileWatcher::ResourceFileWatcher()
+  : osg::Referenced()
+  , m(new Impl())
+{
+#ifdef __linux__
+  m->inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m->inotifyDescriptor < 0)
+  {
+    throw GameException(std::string("Could not initialize inotify: ") + std::strerror(errno));
+  }
+#endif
+}
+
+ResourceFileWatcher::~ResourceFileWatcher()
+{
+#ifdef __linux__
+  close(m->inotifyDescriptor);
+#endif
+}
+
+void ResourceFileWatcher::watch(const std::string& filename)
+{
+  const auto path = normalizePath(filename);
+
+  std::error_code error;
+  const auto      lastWriteTime = std::filesystem::last_write_time(path, error);
+  if (error)
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m->mutex);
+  if (m->files.count(path) > 0)
+  {
+    return;
+  }
+
+#ifdef __linux__
+  m->addDirectory(std::filesystem::path(path).parent_path().string());
+#endif
+
+  m->files[path] = { filename, lastWriteTime };
+}
+
+void ResourceFileWatcher::unwatch(const std::string& filename)
+{
+  const auto path = normalizePath(filename);
+
+  std::lock_guard<std::mutex> lock(m->mutex);
+  if (m->files.erase(path) == 0)
+  {
+    return;
+  }
+
+#ifdef __linux__
+  m->removeDirectory(std::filesystem::path(path).parent_path().string());
+#endif
+}
+
+bool ResourceFileWatcher::isWatching(const std::string& filename) const
+{
+  const auto path = normalizePath(filename);
+
+  std::lock_guard<std::mutex> lock(m->mutex);
+  return m->files.count(path) > 0;
+}
+
+std::vector<std::string> ResourceFileWatcher::pollChanges()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  // one save often causes several events
+  std::set<std::string> changedPaths;
+
+#ifdef __linux__
+  alignas(inotify_event) char buffer[4096];
+
+  while (true)
+  {
+    const auto length = read(m->inotifyDescriptor, buffer, sizeof(buffer));
+    if (length <= 0)
+    {
+      break;
+    }
+
+    for (auto pos = 0L; pos < length;)
+    {
+      const auto event = reinterpret_cast<const inotify_event*>(buffer + pos);
+      pos += static_cast<long>(sizeof(inotify_event) + event->len);
+
+      const auto directory = m->directoryPaths.find(event->wd);
+      if ((directory == m->directoryPaths.end()) || (event->len == 0))
+      {
+        continue;
+      }
+
+      const auto path = (std::filesystem::path(directory->second) / event->name).string();
+      if (m->files.count(path) > 0)
+      {
+        changedPaths.insert(path);
+      }
+    }
+  }
+#else
+  for (const auto& file : m->files)
+  {
+    std::error_code error;
+    const auto      lastWriteTime = std::filesystem::last_write_time(file.first, error);
+
+    if (!error && (lastWriteTime != file.second.lastWriteTime))
+    {
+      changedPaths.insert(file.first);
+    }
+  }
+#endif
+
+  std::vector<std::string> changes;
+  for (const auto& path : changedPaths)
+  {
+    auto& file = m->files[path];
+
+    std::error_code error;
+    file.lastWriteTime = std::filesystem::last_write_time(path, error);
+
+    changes.push_back(file.filename);
+  }
+
+  return changes;
+}
+
+}
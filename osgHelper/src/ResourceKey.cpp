@@ -0,0 +1,69 @@
+#include <osgHelper/ResourceKey.h>
+
+#include "CacheUtils.h"
+
+#include <cstdint>
+
+namespace osgHelper
+{
+
+static char foldCase(char c)
+{
+  return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+ResourceKey::ResourceKey()
+  : m_hash(computeHash(m_name))
+{
+}
+
+ResourceKey::ResourceKey(const std::string& name)
+  : m_name(name)
+  , m_hash(computeHash(m_name))
+{
+}
+
+ResourceKey::ResourceKey(std::string&& name)
+  : m_name(std::move(name))
+  , m_hash(computeHash(m_name))
+{
+}
+
+ResourceKey::ResourceKey(const char* name)
+  : m_name(name)
+  , m_hash(computeHash(m_name))
+{
+}
+
+bool ResourceKey::equalsIgnoreCase(const std::string& lhs, const std::string& rhs)
+{
+  if (lhs.size() != rhs.size())
+  {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < lhs.size(); i++)
+  {
+    if (foldCase(lhs[i]) != foldCase(rhs[i]))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::size_t ResourceKey::computeHash(const std::string& name)
+{
+  // over the case-folded characters
+  Fnv1aHasher hasher;
+  for (const auto c : name)
+  {
+    hasher.addValue(static_cast<unsigned char>(foldCase(c)));
+  }
+
+  const auto hash = hasher.get();
+  return static_cast<std::size_t>(hash ^ (hash >> 32));
+}
+
+}
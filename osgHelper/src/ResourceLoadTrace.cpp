@@ -0,0 +1,161 @@
+#include <osgHelper/ResourceLoadTrace.h>
+#include <osgHelper/GameException.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+namespace osgHelper
+{
+
+static std::string escapeJson(const std::string& str)
+{
+  std::string result;
+  result.reserve(str.size());
+
+  for (const auto c : str)
+  {
+    switch (c)
+    {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    case '\r':
+      result += "\\r";
+      break;
+    case '\t':
+      result += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+        result += escaped;
+      }
+      else
+      {
+        result += c;
+      }
+      break;
+    }
+  }
+
+  return result;
+}
+
+static double toMicroseconds(std::chrono::nanoseconds duration)
+{
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+static void writeSlice(std::ostream& stream, const ResourceLoadTrace::Event& event, const char* category,
+                       double timestamp, double duration, unsigned int threadIndex)
+{
+  stream << "{\"name\":\"" << escapeJson(event.resourceKey) << "\",\"cat\":\"" << category
+         << "\",\"ph\":\"X\",\"ts\":" << timestamp << ",\"dur\":" << duration
+         << ",\"pid\":1,\"tid\":" << threadIndex
+         << ",\"args\":{\"type\":\"" << escapeJson(event.type)
+         << "\",\"readerWriter\":\"" << escapeJson(event.readerWriter)
+         << "\",\"bytes\":" << event.numBytes << "}}";
+}
+
+struct ResourceLoadTrace::Impl
+{
+  EventList          events;
+  mutable std::mutex mutex;
+};
+
+ResourceLoadTrace::ResourceLoadTrace()
+  : osg::Referenced()
+  , m(new Impl())
+{
+}
+
+ResourceLoadTrace::~ResourceLoadTrace() = default;
+
+void ResourceLoadTrace::add(const Event& event)
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->events.push_back(event);
+}
+
+ResourceLoadTrace::EventList ResourceLoadTrace::getEvents() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  return m->events;
+}
+
+void ResourceLoadTrace::clear()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->events.clear();
+}
+
+void ResourceLoadTrace::writeChromeTrace(std::ostream& stream) const
+{
+  const auto events = getEvents();
+
+  Clock::time_point baseTime;
+  if (!events.empty())
+  {
+    baseTime = std::min_element(events.begin(), events.end(), [](const Event& lhs, const Event& rhs)
+    {
+      return lhs.beginTime < rhs.beginTime;
+    })->beginTime;
+  }
+
+  // small sequential thread ids read better in the viewer than hashed ones
+  std::map<std::thread::id, unsigned int> threadIndices;
+
+  const auto flags     = stream.flags();
+  const auto precision = stream.precision();
+  stream.setf(std::ios::fixed, std::ios::floatfield);
+  stream.precision(3);
+
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  auto isFirst = true;
+  for (const auto& event : events)
+  {
+    const auto threadIndex = threadIndices.emplace(event.threadId,
+                                                   static_cast<unsigned int>(threadIndices.size()) + 1).first->second;
+
+    const auto readBegin  = toMicroseconds(event.beginTime - baseTime);
+    const auto readTime   = toMicroseconds(event.readDuration);
+    const auto decodeTime = toMicroseconds(event.decodeDuration);
+
+    stream << (isFirst ? "\n" : ",\n");
+    writeSlice(stream, event, "read", readBegin, readTime, threadIndex);
+    stream << ",\n";
+    writeSlice(stream, event, "decode", readBegin + readTime, decodeTime, threadIndex);
+
+    isFirst = false;
+  }
+
+  stream << "\n]}\n";
+
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void ResourceLoadTrace::writeChromeTraceToFile(const std::string& filename) const
+{
+  std::ofstream stream(filename);
+  if (!stream.is_open())
+  {
+    throw GameException("Could not create file '" + filename + "'");
+  }
+
+  writeChromeTrace(stream);
+}
+
+}
@@ -1,64 +1,240 @@
 #include <osgHelper/ResourceManager.h>
 #include <osgHelper/TextResource.h>
-#include <osgHelper/Helper.h>
 #include <osgHelper/BinaryResource.h>
 #include <osgHelper/GameException.h>
 #include <osgHelper/FileResourceLoader.h>
+#include <osgHelper/LayeredResourceLoader.h>
+#include <osgHelper/MappedFile.h>
+#include <osgHelper/ResourceCodec.h>
+#include <osgHelper/ResourceLoadTrace.h>
+#include <osgHelper/ResourceManifest.h>
 
 #include <osgDB/ReadFile>
 #include <osgDB/FileNameUtils>
 
+#include <utilsLib/Utils.h>
+
+#include <cstring>
+#include <limits>
+
 namespace osgHelper
 {
 
+// on-demand requests are never queued behind prefetched resources
+static const int RequestPriority = std::numeric_limits<int>::max();
+
+static void replaceImage(osg::Image& image, const osg::Image& source)
+{
+  const auto size = source.getTotalSizeInBytesIncludingMipmaps();
+  const auto data = new unsigned char[size];
+  std::memcpy(data, source.data(), size);
+
+  image.setImage(source.s(), source.t(), source.r(), source.getInternalTextureFormat(), source.getPixelFormat(),
+                 source.getDataType(), data, osg::Image::USE_NEW_DELETE, source.getPacking());
+  image.setMipmapLevels(source.getMipmapLevels());
+}
+
+static void logException(const std::string& message, const std::exception_ptr& error)
+{
+  try
+  {
+    std::rethrow_exception(error);
+  }
+  catch (const std::exception& e)
+  {
+    UTILS_LOG_WARN(message + ": " + e.what());
+  }
+  catch (...)
+  {
+    UTILS_LOG_WARN(message);
+  }
+}
+
+static std::string getTypeName(ResourceManager::ResourceType type)
+{
+  switch (type)
+  {
+  case ResourceManager::ResourceType::Text:
+    return "text";
+  case ResourceManager::ResourceType::Binary:
+    return "binary";
+  case ResourceManager::ResourceType::Shader:
+    return "shader";
+  default:
+    break;
+  }
+
+  return "detect";
+}
+
+static void storeDecodedImage(const DecodedImageCache& cache, const ResourceKey& resourceKey, const osg::Image& image)
+{
+  try
+  {
+    cache.write(resourceKey.str(), image);
+  }
+  catch (...)
+  {
+    // the image has been loaded anyway, it is just decoded again next time
+    logException("Could not cache decoded image '" + resourceKey.str() + "'", std::current_exception());
+  }
+}
+
+template <typename T, typename ConvertFunc>
+std::function<void(const osg::ref_ptr<osg::Object>&, const std::exception_ptr&)> makePromiseCallback(
+  const std::shared_ptr<std::promise<T>>& promise, const ConvertFunc& convert)
+{
+  return [promise, convert](const osg::ref_ptr<osg::Object>& obj, const std::exception_ptr& error)
+  {
+    if (error)
+    {
+      promise->set_exception(error);
+      return;
+    }
+
+    promise->set_value(convert(obj));
+  };
+}
+
 ResourceManager::ResourceManager(ioc::Injector& injector)
   : IResourceManager()
+  , m_isLoadTracing(false)
+  , m_isRecordingManifest(false)
+  , m_isHotReloadEnabled(false)
+  , m_resourceReloaded(new Observable<std::string>())
+  , m_numLoaderThreads(0)
 {
 }
 
 ResourceManager::~ResourceManager() = default;
 
-std::string ResourceManager::loadText(const std::string& resourceKey)
+std::string ResourceManager::loadText(const ResourceKey& resourceKey)
 {
   const auto textRes = dynamic_cast<TextResource*>(loadObject(resourceKey, ResourceType::Text).get());
   return textRes ? textRes->text : "";
 }
 
-char* ResourceManager::loadBinary(const std::string& resourceKey)
+osg::ref_ptr<BinaryResource> ResourceManager::loadBinary(const ResourceKey& resourceKey)
 {
-  const auto binRes = dynamic_cast<BinaryResource*>(loadObject(resourceKey, ResourceType::Binary).get());
-  return binRes ? binRes->getBytes() : nullptr;
+  return dynamic_cast<BinaryResource*>(loadObject(resourceKey, ResourceType::Binary).get());
 }
 
-osg::ref_ptr<osg::Image> ResourceManager::loadImage(const std::string& resourceKey)
+osg::ref_ptr<osg::Image> ResourceManager::loadImage(const ResourceKey& resourceKey)
 {
   return dynamic_cast<osg::Image*>(loadObject(resourceKey).get());
 }
 
-osg::ref_ptr<osgText::Font> ResourceManager::loadFont(const std::string& resourceKey)
+osg::ref_ptr<osgText::Font> ResourceManager::loadFont(const ResourceKey& resourceKey)
 {
   return dynamic_cast<osgText::Font*>(loadObject(resourceKey).get());
 }
 
-osg::ref_ptr<osg::Shader> ResourceManager::loadShader(const std::string& resourceKey, osg::Shader::Type type)
+osg::ref_ptr<osg::Shader> ResourceManager::loadShader(const ResourceKey& resourceKey, osg::Shader::Type type)
 {
   return dynamic_cast<osg::Shader*>(loadObject(resourceKey, ResourceType::Shader, type).get());
 }
 
+std::future<std::string> ResourceManager::loadTextAsync(const ResourceKey& resourceKey)
+{
+  auto promise = std::make_shared<std::promise<std::string>>();
+  loadObjectAsync(resourceKey, ResourceType::Text, osg::Shader::FRAGMENT,
+                  makePromiseCallback(promise, [](const osg::ref_ptr<osg::Object>& obj)
+                  {
+                    const auto textRes = dynamic_cast<TextResource*>(obj.get());
+                    return textRes ? textRes->text : "";
+                  }), RequestPriority);
+
+  return promise->get_future();
+}
+
+std::future<osg::ref_ptr<osg::Image>> ResourceManager::loadImageAsync(const ResourceKey& resourceKey)
+{
+  auto promise = std::make_shared<std::promise<osg::ref_ptr<osg::Image>>>();
+  loadObjectAsync(resourceKey, ResourceType::Detect, osg::Shader::FRAGMENT,
+                  makePromiseCallback(promise, [](const osg::ref_ptr<osg::Object>& obj)
+                  {
+                    return osg::ref_ptr<osg::Image>(dynamic_cast<osg::Image*>(obj.get()));
+                  }), RequestPriority);
+
+  return promise->get_future();
+}
+
+std::future<osg::ref_ptr<osgText::Font>> ResourceManager::loadFontAsync(const ResourceKey& resourceKey)
+{
+  auto promise = std::make_shared<std::promise<osg::ref_ptr<osgText::Font>>>();
+  loadObjectAsync(resourceKey, ResourceType::Detect, osg::Shader::FRAGMENT,
+                  makePromiseCallback(promise, [](const osg::ref_ptr<osg::Object>& obj)
+                  {
+                    return osg::ref_ptr<osgText::Font>(dynamic_cast<osgText::Font*>(obj.get()));
+                  }), RequestPriority);
+
+  return promise->get_future();
+}
+
+std::future<osg::ref_ptr<osg::Shader>> ResourceManager::loadShaderAsync(const ResourceKey& resourceKey,
+                                                                        osg::Shader::Type type)
+{
+  auto promise = std::make_shared<std::promise<osg::ref_ptr<osg::Shader>>>();
+  loadObjectAsync(resourceKey, ResourceType::Shader, type,
+                  makePromiseCallback(promise, [](const osg::ref_ptr<osg::Object>& obj)
+                  {
+                    return osg::ref_ptr<osg::Shader>(dynamic_cast<osg::Shader*>(obj.get()));
+                  }), RequestPriority);
+
+  return promise->get_future();
+}
+
 void ResourceManager::setResourceLoader(const osg::ref_ptr<IResourceLoader>& loader)
 {
+  std::lock_guard<std::mutex> lock(m_resourceLoaderMutex);
   m_resourceLoader = loader;
 }
 
-void ResourceManager::clearCacheResource(const std::string& resourceKey)
+std::vector<osg::ref_ptr<osg::Image>> ResourceManager::loadImages(const std::vector<ResourceKey>& resourceKeys)
 {
-  const auto it = m_cache.find(lowerString(resourceKey));
-  if (it == m_cache.end())
+  std::vector<std::future<osg::ref_ptr<osg::Image>>> futures;
+  futures.reserve(resourceKeys.size());
+
+  for (const auto& resourceKey : resourceKeys)
+  {
+    futures.push_back(loadImageAsync(resourceKey));
+  }
+
+  std::vector<osg::ref_ptr<osg::Image>> images;
+  images.reserve(resourceKeys.size());
+
+  for (auto i = 0U; i < futures.size(); i++)
   {
-    throw GameException("Clear cache resource: resource key '" + resourceKey + "' not found");
+    try
+    {
+      images.push_back(futures[i].get());
+    }
+    catch (...)
+    {
+      logException("Could not load image '" + resourceKeys[i].str() + "'", std::current_exception());
+      images.push_back(nullptr);
+    }
   }
 
-  m_cache.erase(it);
+  return images;
+}
+
+void ResourceManager::setDecodedImageCache(const osg::ref_ptr<DecodedImageCache>& cache)
+{
+  std::lock_guard<std::mutex> lock(m_decodedImageCacheMutex);
+  m_decodedImageCache = cache;
+}
+
+osg::ref_ptr<DecodedImageCache> ResourceManager::getDecodedImageCache()
+{
+  std::lock_guard<std::mutex> lock(m_decodedImageCacheMutex);
+  return m_decodedImageCache;
+}
+
+void ResourceManager::clearCacheResource(const ResourceKey& resourceKey)
+{
+  // the resource might have been evicted already, which is not an error
+  m_cache.remove(resourceKey);
 }
 
 void ResourceManager::clearCache()
@@ -66,6 +242,214 @@ void ResourceManager::clearCache()
   m_cache.clear();
 }
 
+void ResourceManager::setNumLoaderThreads(unsigned int numThreads)
+{
+  m_numLoaderThreads = numThreads;
+}
+
+void ResourceManager::setCacheMemoryBudget(std::size_t bytes)
+{
+  m_cache.setMemoryBudget(bytes);
+}
+
+ResourceCache::Statistics ResourceManager::getCacheStatistics() const
+{
+  return m_cache.getStatistics();
+}
+
+ResourceManager::LoadStatistics ResourceManager::getLoadStatistics() const
+{
+  LoadStatistics statistics;
+  {
+    std::lock_guard<std::mutex> lock(m_loadStatisticsMutex);
+    statistics = m_loadStatistics;
+  }
+
+  statistics.cache = m_cache.getStatistics();
+  return statistics;
+}
+
+void ResourceManager::resetLoadStatistics()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_loadStatisticsMutex);
+    m_loadStatistics = LoadStatistics();
+  }
+
+  m_cache.resetStatistics();
+}
+
+void ResourceManager::setLoadTracingEnabled(bool enabled)
+{
+  std::lock_guard<std::mutex> lock(m_loadTraceMutex);
+  if (enabled && !m_loadTrace.valid())
+  {
+    m_loadTrace = new ResourceLoadTrace();
+  }
+
+  m_isLoadTracing = enabled;
+}
+
+bool ResourceManager::isLoadTracingEnabled() const
+{
+  return m_isLoadTracing;
+}
+
+osg::ref_ptr<ResourceLoadTrace> ResourceManager::getLoadTrace() const
+{
+  std::lock_guard<std::mutex> lock(m_loadTraceMutex);
+  if (!m_loadTrace.valid())
+  {
+    return new ResourceLoadTrace();
+  }
+
+  return m_loadTrace;
+}
+
+std::future<void> ResourceManager::prefetch(const ResourceManifest& manifest)
+{
+  const auto promise      = std::make_shared<std::promise<void>>();
+  const auto numRemaining = std::make_shared<std::atomic<std::size_t>>(manifest.getNumEntries());
+
+  if (manifest.getNumEntries() == 0)
+  {
+    promise->set_value();
+    return promise->get_future();
+  }
+
+  auto future = promise->get_future();
+  for (const auto& entry : manifest.getEntries())
+  {
+    const auto resourceKey = entry.resourceKey;
+    loadObjectAsync(resourceKey, entry.type, entry.shaderType,
+                    [promise, numRemaining, resourceKey](const osg::ref_ptr<osg::Object>&,
+                                                         const std::exception_ptr& error)
+                    {
+                      if (error)
+                      {
+                        logException("Could not prefetch resource '" + resourceKey + "'", error);
+                      }
+
+                      if (--(*numRemaining) == 0)
+                      {
+                        promise->set_value();
+                      }
+                    }, entry.priority, false);
+  }
+
+  return future;
+}
+
+void ResourceManager::setManifestRecordingEnabled(bool enabled)
+{
+  std::lock_guard<std::mutex> lock(m_recordedManifestMutex);
+  if (enabled && !m_recordedManifest.valid())
+  {
+    m_recordedManifest = new ResourceManifest();
+  }
+
+  m_isRecordingManifest = enabled;
+}
+
+osg::ref_ptr<ResourceManifest> ResourceManager::getRecordedManifest() const
+{
+  osg::ref_ptr<ResourceManifest> manifest = new ResourceManifest();
+
+  std::lock_guard<std::mutex> lock(m_recordedManifestMutex);
+  if (m_recordedManifest.valid())
+  {
+    for (const auto& entry : m_recordedManifest->getEntries())
+    {
+      manifest->add(entry.resourceKey, entry.type, entry.shaderType, entry.priority);
+    }
+  }
+
+  return manifest;
+}
+
+void ResourceManager::setHotReloadEnabled(bool enabled)
+{
+  std::lock_guard<std::mutex> lock(m_hotReloadMutex);
+  if (enabled && !m_hotReloadWatcher.valid())
+  {
+    m_hotReloadWatcher = new ResourceFileWatcher();
+  }
+
+  m_isHotReloadEnabled = enabled;
+}
+
+bool ResourceManager::isHotReloadEnabled() const
+{
+  return m_isHotReloadEnabled;
+}
+
+void ResourceManager::applyPendingReloads()
+{
+  if (!m_isHotReloadEnabled)
+  {
+    return;
+  }
+
+  ReloadedResourceList         reloadedResources;
+  std::vector<WatchedResource> changedResources;
+  {
+    std::lock_guard<std::mutex> lock(m_hotReloadMutex);
+    reloadedResources.swap(m_reloadedResources);
+
+    for (const auto& filename : m_hotReloadWatcher->pollChanges())
+    {
+      changedResources.push_back(m_watchedResources[filename]);
+    }
+  }
+
+  const auto layeredLoader = dynamic_cast<LayeredResourceLoader*>(resourceLoader().get());
+  if (layeredLoader && !changedResources.empty())
+  {
+    layeredLoader->clearNegativeCache();
+  }
+
+  for (const auto& reloaded : reloadedResources)
+  {
+    applyReload(reloaded.first, reloaded.second);
+  }
+
+  for (const auto& resource : changedResources)
+  {
+    const auto resourceKey = resource.resourceKey;
+
+    threadPool().enqueue([this, resourceKey, resource]()
+    {
+      try
+      {
+        const auto obj = readObject(resourceLoader(), resourceKey, resource.type, resource.shaderType);
+
+        {
+          std::lock_guard<std::mutex> lock(m_hotReloadMutex);
+          m_reloadedResources.emplace_back(resourceKey, obj);
+        }
+
+        m_reloadFinished.notify_all();
+      }
+      catch (...)
+      {
+        // e.g. a shader that is still being edited, the next change triggers another reload
+        logException("Could not reload resource '" + resourceKey + "'", std::current_exception());
+      }
+    }, RequestPriority);
+  }
+}
+
+bool ResourceManager::waitForPendingReloads(std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> lock(m_hotReloadMutex);
+  return m_reloadFinished.wait_for(lock, timeout, [this]() { return !m_reloadedResources.empty(); });
+}
+
+Observable<std::string>::Ptr ResourceManager::getResourceReloadedObservable() const
+{
+  return m_resourceReloaded;
+}
+
 void ResourceManager::setDefaultFont(const osg::ref_ptr<osgText::Font>& font)
 {
   m_defaultFont = font;
@@ -78,6 +462,8 @@ osg::ref_ptr<osgText::Font> ResourceManager::getDefaultFont()
 
 osg::ref_ptr<IResourceLoader> ResourceManager::resourceLoader()
 {
+  std::lock_guard<std::mutex> lock(m_resourceLoaderMutex);
+
   if (!m_resourceLoader.valid())
   {
     m_resourceLoader = new FileResourceLoader();
@@ -86,97 +472,332 @@ osg::ref_ptr<IResourceLoader> ResourceManager::resourceLoader()
   return m_resourceLoader;
 }
 
-char* ResourceManager::loadBytesFromStream(std::ifstream& stream, long long length)
+ThreadPool& ResourceManager::threadPool()
 {
-  char* buffer = new char[length];
-  stream.read(buffer, length);
+  std::call_once(m_threadPoolInitialized, [this]()
+  {
+    m_threadPool = std::make_unique<ThreadPool>(m_numLoaderThreads);
+  });
 
-  return buffer;
+  return *m_threadPool;
 }
 
-std::string ResourceManager::loadTextFromStream(std::ifstream& stream, long long length)
+osg::ref_ptr<osg::Object> ResourceManager::loadObject(const ResourceKey& resourceKey, ResourceType type,
+                                                      osg::Shader::Type shaderType, bool isRecorded)
 {
-  char* buffer = new char[length + 1];
-  stream.read(buffer, length);
-  buffer[length] = '\0';
+  if (isRecorded && m_isRecordingManifest)
+  {
+    recordManifestEntry(resourceKey, type, shaderType);
+  }
+
+  auto obj = getCacheItem(resourceKey);
+  if (obj.valid())
+  {
+    return obj;
+  }
 
-  std::string text(buffer);
+  const auto loader = resourceLoader();
+  obj = readObject(loader, resourceKey, type, shaderType);
 
-  delete[] buffer;
+  if (m_isHotReloadEnabled)
+  {
+    const auto filename = loader->getResourceFilename(resourceKey.str());
+    if (!filename.empty())
+    {
+      watchResource(resourceKey, filename, type, shaderType);
+    }
+  }
 
-  return text;
+  return storeCacheItem(resourceKey, obj);
 }
 
-osg::ref_ptr<osg::Object> ResourceManager::loadObject(const std::string& resourceKey, ResourceType type,
+osg::ref_ptr<osg::Object> ResourceManager::readObject(const osg::ref_ptr<IResourceLoader>& loader,
+                                                      const ResourceKey& resourceKey, ResourceType type,
                                                       osg::Shader::Type shaderType)
 {
-  auto obj = getCacheItem(resourceKey);
-  if (obj.valid())
+  using Clock = ResourceLoadTrace::Clock;
+
+  const auto beginTime   = Clock::now();
+  auto       readEndTime = beginTime;
+
+  // only files have the modification time the decoded images are keyed by
+  const auto imageCache = ((type == ResourceType::Detect) && dynamic_cast<FileResourceLoader*>(loader.get())) ?
+                          getDecodedImageCache() : nullptr;
+
+  osg::ref_ptr<osg::Object> obj;
+  std::size_t               numBytes = 0;
+  std::string               readerWriter;
+
+  try
   {
-    return obj;
+    osg::ref_ptr<osg::Image> cachedImage = imageCache.valid() ? imageCache->read(resourceKey.str()) : nullptr;
+    if (cachedImage.valid())
+    {
+      numBytes     = cachedImage->getTotalSizeInBytesIncludingMipmaps();
+      readEndTime  = Clock::now();
+      readerWriter = "DecodedImageCache";
+      obj          = cachedImage.get();
+    }
+    else
+    {
+      const auto data = loader->getResourceData(resourceKey.str());
+      numBytes        = data->getSize();
+      readEndTime = Clock::now();
+      obj         = decodeObject(data, resourceKey, type, shaderType, readerWriter);
+
+      const auto image = dynamic_cast<osg::Image*>(obj.get());
+      if (imageCache.valid() && image)
+      {
+        storeDecodedImage(*imageCache, resourceKey, *image);
+      }
+    }
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(m_loadStatisticsMutex);
+    m_loadStatistics.numFailedLoads++;
+    throw;
   }
 
-  std::ifstream stream;
+  recordLoad(resourceKey, type, readerWriter, numBytes, beginTime, readEndTime, Clock::now());
 
-  auto length = 0LL;
-  resourceLoader()->getResourceStream(resourceKey, stream, length);
+  return obj;
+}
+
+osg::ref_ptr<osg::Object> ResourceManager::decodeObject(const osg::ref_ptr<ResourceData>& data,
+                                                        const ResourceKey& resourceKey, ResourceType type,
+                                                        osg::Shader::Type shaderType, std::string& readerWriter)
+{
+  osg::ref_ptr<osg::Object> obj;
 
   if (type == ResourceType::Detect)
   {
-    const auto rw = osgDB::Registry::instance()->getReaderWriterForExtension(osgDB::getLowerCaseFileExtension(resourceKey));
-    auto res      = rw->readObject(stream);
+    const auto rw = osgDB::Registry::instance()->getReaderWriterForExtension(
+      osgDB::getLowerCaseFileExtension(ResourceCodec::stripExtension(resourceKey.str())));
+    if (!rw)
+    {
+      throw GameException("No reader writer found for resource '" + resourceKey.str() + "'");
+    }
+
+    readerWriter = rw->className();
+
+    ResourceDataStream stream(data);
+    auto res = rw->readObject(stream);
 
     obj = res.getObject();
   }
   else if (type == ResourceType::Text)
   {
     auto textRes = new TextResource();
-    textRes->text = loadTextFromStream(stream, length);
+    textRes->text.assign(data->getData(), data->getSize());
 
     obj = textRes;
   }
   else if (type == ResourceType::Binary)
   {
     auto binRes = new BinaryResource();
-    binRes->setBytes(loadBytesFromStream(stream, length));
+
+    // an editor can truncate a watched file while it is mapped
+    if (m_isHotReloadEnabled && dynamic_cast<MappedFile*>(data.get()))
+    {
+      osg::ref_ptr<ResourceBuffer> buffer = new ResourceBuffer(data->getSize());
+      std::memcpy(buffer->getBuffer(), data->getData(), data->getSize());
+
+      binRes->setData(buffer);
+    }
+    else
+    {
+      binRes->setData(data);
+    }
 
     obj = binRes;
   }
   else if (type == ResourceType::Shader)
   {
-    auto       shader = new osg::Shader(shaderType);
-    const auto source = loadTextFromStream(stream, length);
-
-    shader->setShaderSource(source);
+    auto shader = new osg::Shader(shaderType);
+    shader->setShaderSource(std::string(data->getData(), data->getSize()));
 
     obj = shader;
   }
 
-  stream.close();
+  return obj;
+}
+
+void ResourceManager::loadObjectAsync(const ResourceKey& resourceKey, ResourceType type, osg::Shader::Type shaderType,
+                                      const LoadCallback& callback, int priority, bool isRecorded)
+{
+  // recorded when requested, the load itself might be shared with a prefetch
+  if (isRecorded && m_isRecordingManifest)
+  {
+    recordManifestEntry(resourceKey, type, shaderType);
+  }
+
+  osg::ref_ptr<osg::Object> cachedObj;
+  {
+    std::lock_guard<std::mutex> lock(m_pendingLoadsMutex);
+
+    cachedObj = getCacheItem(resourceKey);
+    if (!cachedObj.valid())
+    {
+      // join a load that is already in flight for the same resource
+      auto& pendingLoad = m_pendingLoads[resourceKey];
+      pendingLoad.callbacks.push_back(callback);
+
+      if (pendingLoad.callbacks.size() > 1)
+      {
+        // a request for a resource that is still queued for prefetching must not wait behind the prefetch,
+        // the load is queued again with the higher priority and whichever task starts first performs it
+        if (pendingLoad.isStarted || (priority <= pendingLoad.priority))
+        {
+          return;
+        }
+      }
+
+      pendingLoad.priority = priority;
+    }
+  }
+
+  if (cachedObj.valid())
+  {
+    callback(cachedObj, nullptr);
+    return;
+  }
 
-  storeCacheItem(resourceKey, obj);
+  threadPool().enqueue([this, resourceKey, type, shaderType]()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_pendingLoadsMutex);
+
+      const auto it = m_pendingLoads.find(resourceKey);
+      if ((it == m_pendingLoads.end()) || it->second.isStarted)
+      {
+        return;
+      }
+
+      it->second.isStarted = true;
+    }
+
+    osg::ref_ptr<osg::Object> obj;
+    std::exception_ptr        error;
+
+    try
+    {
+      obj = loadObject(resourceKey, type, shaderType, false);
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+
+    std::vector<LoadCallback> callbacks;
+    {
+      std::lock_guard<std::mutex> lock(m_pendingLoadsMutex);
+
+      const auto it = m_pendingLoads.find(resourceKey);
+      callbacks     = std::move(it->second.callbacks);
+      m_pendingLoads.erase(it);
+    }
+
+    for (const auto& func : callbacks)
+    {
+      func(obj, error);
+    }
+  }, priority);
+}
 
-  return obj;
+void ResourceManager::recordLoad(const ResourceKey& resourceKey, ResourceType type, const std::string& readerWriter,
+                                 std::size_t numBytes, ResourceLoadTrace::Clock::time_point beginTime,
+                                 ResourceLoadTrace::Clock::time_point readEndTime,
+                                 ResourceLoadTrace::Clock::time_point endTime)
+{
+  const auto readDuration   = std::chrono::duration_cast<std::chrono::nanoseconds>(readEndTime - beginTime);
+  const auto decodeDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - readEndTime);
+
+  {
+    std::lock_guard<std::mutex> lock(m_loadStatisticsMutex);
+    m_loadStatistics.numLoads++;
+    m_loadStatistics.numBytesRead += numBytes;
+    m_loadStatistics.readTime += readDuration;
+    m_loadStatistics.decodeTime += decodeDuration;
+
+    if (!readerWriter.empty())
+    {
+      m_loadStatistics.numLoadsPerReaderWriter[readerWriter]++;
+    }
+  }
+
+  if (!m_isLoadTracing)
+  {
+    return;
+  }
+
+  osg::ref_ptr<ResourceLoadTrace> trace;
+  {
+    std::lock_guard<std::mutex> lock(m_loadTraceMutex);
+    trace = m_loadTrace;
+  }
+
+  if (trace.valid())
+  {
+    trace->add({ resourceKey.str(), getTypeName(type), readerWriter, numBytes, beginTime, readDuration,
+                 decodeDuration, std::this_thread::get_id() });
+  }
+}
+
+void ResourceManager::recordManifestEntry(const ResourceKey& resourceKey, ResourceType type,
+                                          osg::Shader::Type shaderType)
+{
+  std::lock_guard<std::mutex> lock(m_recordedManifestMutex);
+  if (m_recordedManifest.valid())
+  {
+    m_recordedManifest->add(resourceKey.str(), type, shaderType);
+  }
 }
 
-osg::ref_ptr<osg::Object> ResourceManager::getCacheItem(const std::string& key)
+void ResourceManager::watchResource(const ResourceKey& resourceKey, const std::string& filename, ResourceType type,
+                                    osg::Shader::Type shaderType)
 {
-  const auto lower_key = lowerString(key);
+  std::lock_guard<std::mutex> lock(m_hotReloadMutex);
+  m_watchedResources[filename] = { resourceKey.str(), type, shaderType };
+  m_hotReloadWatcher->watch(filename);
+}
+
+void ResourceManager::applyReload(const ResourceKey& resourceKey, const osg::ref_ptr<osg::Object>& obj)
+{
+  const auto cachedObj = getCacheItem(resourceKey);
+  if (!cachedObj.valid() || !obj.valid())
+  {
+    return;
+  }
 
-  const auto it = m_cache.find(lower_key);
-  if (it == m_cache.end())
+  const auto cachedShader = dynamic_cast<osg::Shader*>(cachedObj.get());
+  const auto cachedImage  = dynamic_cast<osg::Image*>(cachedObj.get());
+
+  // text and binary resources may be read by other threads, so they are swapped instead of modified
+  if (cachedShader && dynamic_cast<osg::Shader*>(obj.get()))
+  {
+    cachedShader->setShaderSource(static_cast<osg::Shader*>(obj.get())->getShaderSource());
+  }
+  else if (cachedImage && dynamic_cast<osg::Image*>(obj.get()))
   {
-    return nullptr;
+    replaceImage(*cachedImage, *static_cast<osg::Image*>(obj.get()));
+  }
+  else if (!m_cache.replace(resourceKey, obj))
+  {
+    return;
   }
 
-  return it->second;
+  m_resourceReloaded->set(resourceKey.str());
 }
 
-void ResourceManager::storeCacheItem(const std::string& key, const osg::ref_ptr<osg::Object>& obj)
+osg::ref_ptr<osg::Object> ResourceManager::getCacheItem(const ResourceKey& key)
 {
-  std::string lower_key = lowerString(key);
+  return m_cache.get(key);
+}
 
-  m_cache.insert(ResourceDictionary::value_type(lower_key, obj));
+osg::ref_ptr<osg::Object> ResourceManager::storeCacheItem(const ResourceKey& key, const osg::ref_ptr<osg::Object>& obj)
+{
+  return m_cache.store(key, obj);
 }
 
 osg::ref_ptr<osgText::Font> ResourceManager::m_defaultFont;
@@ -0,0 +1,184 @@
+#include <osgHelper/ResourceManifest.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/Helper.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace osgHelper
+{
+
+static const std::vector<std::pair<osg::Shader::Type, std::string>> ShaderTypeNames = {
+  { osg::Shader::VERTEX, "vertex" },
+  { osg::Shader::TESSCONTROL, "tesscontrol" },
+  { osg::Shader::TESSEVALUATION, "tessevaluation" },
+  { osg::Shader::GEOMETRY, "geometry" },
+  { osg::Shader::FRAGMENT, "fragment" },
+  { osg::Shader::COMPUTE, "compute" }
+};
+
+static const std::string ShaderTypePrefix = "shader:";
+
+static std::string getTypeName(const ResourceManifest::Entry& entry)
+{
+  switch (entry.type)
+  {
+  case ResourceManager::ResourceType::Text:
+    return "text";
+  case ResourceManager::ResourceType::Binary:
+    return "binary";
+  case ResourceManager::ResourceType::Shader:
+    for (const auto& name : ShaderTypeNames)
+    {
+      if (name.first == entry.shaderType)
+      {
+        return ShaderTypePrefix + name.second;
+      }
+    }
+    break;
+  default:
+    break;
+  }
+
+  return "detect";
+}
+
+static bool parseTypeName(const std::string& typeName, ResourceManager::ResourceType& type,
+                          osg::Shader::Type& shaderType)
+{
+  shaderType = osg::Shader::FRAGMENT;
+
+  if (typeName == "text")
+  {
+    type = ResourceManager::ResourceType::Text;
+    return true;
+  }
+  if (typeName == "binary")
+  {
+    type = ResourceManager::ResourceType::Binary;
+    return true;
+  }
+  if (typeName == "detect")
+  {
+    type = ResourceManager::ResourceType::Detect;
+    return true;
+  }
+
+  for (const auto& name : ShaderTypeNames)
+  {
+    if (typeName == ShaderTypePrefix + name.second)
+    {
+      type       = ResourceManager::ResourceType::Shader;
+      shaderType = name.first;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+ResourceManifest::ResourceManifest()
+  : osg::Referenced()
+{
+}
+
+ResourceManifest::~ResourceManifest() = default;
+
+bool ResourceManifest::add(const std::string& resourceKey, ResourceManager::ResourceType type,
+                           osg::Shader::Type shaderType, int priority)
+{
+  if (!m_keys.insert(lowerString(resourceKey)).second)
+  {
+    return false;
+  }
+
+  m_entries.push_back({ resourceKey, type, shaderType, priority });
+  return true;
+}
+
+const ResourceManifest::EntryList& ResourceManifest::getEntries() const
+{
+  return m_entries;
+}
+
+std::size_t ResourceManifest::getNumEntries() const
+{
+  return m_entries.size();
+}
+
+void ResourceManifest::clear()
+{
+  m_entries.clear();
+  m_keys.clear();
+}
+
+void ResourceManifest::read(std::istream& stream)
+{
+  std::string line;
+  auto        lineNumber = 0;
+
+  while (std::getline(stream, line))
+  {
+    lineNumber++;
+
+    const auto begin = line.find_first_not_of(" \t\r");
+    if ((begin == std::string::npos) || (line[begin] == '#'))
+    {
+      continue;
+    }
+
+    std::istringstream lineStream(line);
+
+    int         priority;
+    std::string typeName;
+    std::string resourceKey;
+
+    lineStream >> priority >> typeName >> std::ws;
+    std::getline(lineStream, resourceKey);
+
+    const auto end = resourceKey.find_last_not_of(" \t\r");
+    resourceKey    = (end == std::string::npos) ? "" : resourceKey.substr(0, end + 1);
+
+    ResourceManager::ResourceType type;
+    osg::Shader::Type             shaderType;
+
+    if (resourceKey.empty() || !parseTypeName(typeName, type, shaderType))
+    {
+      throw GameException("Invalid resource manifest entry in line " + std::to_string(lineNumber) + ": " + line);
+    }
+
+    add(resourceKey, type, shaderType, priority);
+  }
+}
+
+void ResourceManifest::write(std::ostream& stream) const
+{
+  for (const auto& entry : m_entries)
+  {
+    stream << entry.priority << " " << getTypeName(entry) << " " << entry.resourceKey << "\n";
+  }
+}
+
+void ResourceManifest::readFromFile(const std::string& filename)
+{
+  std::ifstream stream(filename);
+  if (!stream.is_open())
+  {
+    throw GameException("Could not open file '" + filename + "'");
+  }
+
+  read(stream);
+}
+
+void ResourceManifest::writeToFile(const std::string& filename) const
+{
+  std::ofstream stream(filename);
+  if (!stream.is_open())
+  {
+    throw GameException("Could not create file '" + filename + "'");
+  }
+
+  write(stream);
+}
+
+}
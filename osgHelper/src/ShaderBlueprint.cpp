@@ -2,76 +2,144 @@
 
 #include <utilsLib/Utils.h>
 
+#include <string>
+#include <vector>
+
 namespace osgHelper
 {
 
-struct ShaderBlueprint::Impl
+static osg::ref_ptr<osg::Shader> createShader(const ShaderPermutationCache::Permutation& permutation)
 {
-  Impl()
-    : version(120)
-    , type(osg::Shader::FRAGMENT)
-  {}
+  std::size_t codeSize = 32;
+  for (const auto& extension : permutation.extensions)
+  {
+    codeSize += extension.size() + 20;
+  }
+
+  for (const auto& define : permutation.defines)
+  {
+    codeSize += define.first.size() + define.second.size() + 10;
+  }
 
-  ~Impl() {}
+  for (const auto& module : permutation.modules)
+  {
+    codeSize += module.size() + 1;
+  }
 
-  int version;
-  osg::Shader::Type type;
-  std::vector<std::string> extensions;
-  std::vector<std::string> modules;
+  std::string code;
+  code.reserve(codeSize);
+  code += "#version " + std::to_string(permutation.version) + "\n";
+
+  for (const auto& extension : permutation.extensions)
+  {
+    code += "#extension ";
+    code += extension;
+    code += " : enable\n";
+  }
+
+  for (const auto& define : permutation.defines)
+  {
+    code += "#define ";
+    code += define.first;
+    if (!define.second.empty())
+    {
+      code += " ";
+      code += define.second;
+    }
+    code += "\n";
+  }
+
+  for (const auto& module : permutation.modules)
+  {
+    code += module;
+    code += "\n";
+  }
+
+  return new osg::Shader(permutation.type, code);
+}
+
+struct ShaderBlueprint::Impl
+{
+  ShaderPermutationCache::Permutation  permutation;
+  osg::ref_ptr<ShaderPermutationCache> cache;
+  osg::ref_ptr<ShaderPreprocessor>     preprocessor;
 
 };
 
-ShaderBlueprint::ShaderBlueprint()
+ShaderBlueprint::ShaderBlueprint(const osg::ref_ptr<ShaderPermutationCache>& cache,
+                                 const osg::ref_ptr<ShaderPreprocessor>&     preprocessor)
   : IShaderBlueprint()
   , m(new Impl())
 {
+  m->cache        = cache;
+  m->preprocessor = preprocessor;
 }
 
 ShaderBlueprint::~ShaderBlueprint() = default;
 
 osg::ref_ptr<IShaderBlueprint> ShaderBlueprint::version(int shaderVersion)
 {
-  m->version = shaderVersion;
+  m->permutation.version = shaderVersion;
   return this;
 }
 
 osg::ref_ptr<IShaderBlueprint> ShaderBlueprint::type(osg::Shader::Type shaderType)
 {
-  m->type = shaderType;
+  m->permutation.type = shaderType;
   return this;
 }
 
 osg::ref_ptr<IShaderBlueprint> ShaderBlueprint::extension(const std::string& extName)
 {
-  m->extensions.push_back(extName);
+  m->permutation.extensions.push_back(extName);
   return this;
 }
 
 osg::ref_ptr<IShaderBlueprint> ShaderBlueprint::module(const std::string& module)
 {
-  m->modules.push_back(module);
+  m->permutation.modules.push_back(module);
+  return this;
+}
+
+osg::ref_ptr<IShaderBlueprint> ShaderBlueprint::define(const std::string& name, const std::string& value)
+{
+  m->permutation.defines[name] = value;
   return this;
 }
 
 osg::ref_ptr<osg::Shader> ShaderBlueprint::build()
 {
-  assert_return(!m->modules.empty(), nullptr);
+  assert_return(!m->permutation.modules.empty(), nullptr);
 
-  osg::ref_ptr<osg::Shader> shader = new osg::Shader(m->type);
-  std::string code = "#version " + std::to_string(m->version) + "\n";
+  // the modules are expanded as one source, so that files included by several modules are only included once
+  const auto*                         permutation = &m->permutation;
+  ShaderPermutationCache::Permutation expandedPermutation;
 
-  for (auto& extension : m->extensions)
+  if (m->preprocessor.valid())
   {
-    code += ("#extension " + extension + " : enable\n");
+    std::string source = m->permutation.modules.front();
+    for (auto i = 1U; i < m->permutation.modules.size(); i++)
+    {
+      source += "\n";
+      source += m->permutation.modules[i];
+    }
+
+    expandedPermutation.type       = m->permutation.type;
+    expandedPermutation.version    = m->permutation.version;
+    expandedPermutation.extensions = m->permutation.extensions;
+    expandedPermutation.defines    = m->permutation.defines;
+    expandedPermutation.modules.push_back(
+      m->preprocessor->process(source, m->permutation.defines, m->permutation.version));
+
+    permutation = &expandedPermutation;
   }
 
-  for (auto& module : m->modules)
+  if (!m->cache.valid())
   {
-    code += (module + "\n");
+    return createShader(*permutation);
   }
 
-  shader->setShaderSource(code);
-  return shader;
+  return m->cache->getOrCreate(*permutation, createShader);
 }
 
 }
\ No newline at end of file
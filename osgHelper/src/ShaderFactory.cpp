@@ -1,37 +1,281 @@
 #include <osgHelper/ShaderFactory.h>
 #include <osgHelper/ShaderBlueprint.h>
 
+#include "CacheUtils.h"
+
+#include <utilsLib/Utils.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+
 namespace osgHelper
 {
 
+static std::size_t getContentHash(const std::string& source, osg::Shader::Type type)
+{
+  auto hash = std::hash<std::string>()(source);
+  hashCombine(hash, static_cast<std::size_t>(type));
+
+  return hash;
+}
+
 ShaderFactory::ShaderFactory(ioc::Injector& injector)
   : IShaderFactory()
+  , m_numKeyMismatches(0)
 {
 }
 
 ShaderFactory::~ShaderFactory() = default;
 
-osg::ref_ptr<osg::Shader> ShaderFactory::fromSourceText(const std::string& key, const std::string& source,
+osg::ref_ptr<osg::Shader> ShaderFactory::fromSourceText(const std::string& key, const std::string& passedSource,
                                                         osg::Shader::Type type)
 {
-  const auto it = m_shaderCache.find(key);
+  const auto source = getShaderSource(key, passedSource, type);
+  const auto hash   = getContentHash(source, type);
 
-  if (it != m_shaderCache.end())
   {
-    return it->second;
+    std::shared_lock<std::shared_mutex> lock(m_shaderCacheMutex);
+
+    const auto shader = findShader(hash, source, type);
+    if (shader.valid() && isKnownKey(key, shader.get()))
+    {
+      return shader;
+    }
   }
 
-  osg::ref_ptr<osg::Shader> shader = new osg::Shader(type);
-  shader->setShaderSource(source);
+  std::unique_lock<std::shared_mutex> lock(m_shaderCacheMutex);
+
+  // another thread might have created the shader in the meantime
+  auto shader = findShader(hash, source, type);
+  if (!shader.valid())
+  {
+    shader = new osg::Shader(type);
+    shader->setShaderSource(source);
+    shader->setName(key);
 
-  m_shaderCache.insert(ShaderDictionary::value_type(key, shader));
+    m_shaderCache.emplace(hash, shader);
+  }
+
+  if (!isKnownKey(key, shader.get()))
+  {
+    addKey(key, shader.get());
+  }
 
   return shader;
 }
 
 osg::ref_ptr<IShaderBlueprint> ShaderFactory::make() const
 {
-  return new ShaderBlueprint();
+  std::shared_lock<std::shared_mutex> lock(m_optionsMutex);
+  return new ShaderBlueprint(m_permutationCache, m_shaderPreprocessor);
+}
+
+void ShaderFactory::prepareProgram(const osg::ref_ptr<osg::Program>& program)
+{
+  const auto cache = getProgramBinaryCache();
+  if (cache.valid())
+  {
+    cache->prepare(program);
+  }
+}
+
+void ShaderFactory::setPermutationCache(const osg::ref_ptr<ShaderPermutationCache>& cache)
+{
+  std::unique_lock<std::shared_mutex> lock(m_optionsMutex);
+  m_permutationCache = cache;
+}
+
+osg::ref_ptr<ShaderPermutationCache> ShaderFactory::getPermutationCache() const
+{
+  std::shared_lock<std::shared_mutex> lock(m_optionsMutex);
+  return m_permutationCache;
+}
+
+void ShaderFactory::setProgramBinaryCache(const osg::ref_ptr<ProgramBinaryCache>& cache)
+{
+  std::unique_lock<std::shared_mutex> lock(m_optionsMutex);
+  m_programBinaryCache = cache;
+}
+
+osg::ref_ptr<ProgramBinaryCache> ShaderFactory::getProgramBinaryCache() const
+{
+  std::shared_lock<std::shared_mutex> lock(m_optionsMutex);
+  return m_programBinaryCache;
+}
+
+void ShaderFactory::setShaderPreprocessor(const osg::ref_ptr<ShaderPreprocessor>& preprocessor)
+{
+  std::unique_lock<std::shared_mutex> lock(m_optionsMutex);
+  m_shaderPreprocessor = preprocessor;
+}
+
+osg::ref_ptr<ShaderPreprocessor> ShaderFactory::getShaderPreprocessor() const
+{
+  std::shared_lock<std::shared_mutex> lock(m_optionsMutex);
+  return m_shaderPreprocessor;
+}
+
+void ShaderFactory::setShaderDirectory(const std::string& directory)
+{
+  {
+    std::unique_lock<std::shared_mutex> lock(m_optionsMutex);
+    m_shaderDirectory = directory;
+  }
+
+  std::unique_lock<std::shared_mutex> lock(m_shaderFilesMutex);
+  m_shaderFiles.clear();
+}
+
+std::string ShaderFactory::getShaderDirectory() const
+{
+  std::shared_lock<std::shared_mutex> lock(m_optionsMutex);
+  return m_shaderDirectory;
+}
+
+std::string ShaderFactory::getShaderFilename(const std::string& key, osg::Shader::Type type)
+{
+  switch (type)
+  {
+  case osg::Shader::VERTEX:
+    return key + ".vert";
+  case osg::Shader::TESSCONTROL:
+    return key + ".tesc";
+  case osg::Shader::TESSEVALUATION:
+    return key + ".tese";
+  case osg::Shader::GEOMETRY:
+    return key + ".geom";
+  case osg::Shader::COMPUTE:
+    return key + ".comp";
+  default:
+    return key + ".frag";
+  }
+}
+
+std::string ShaderFactory::getSourceStamp(const std::string& source)
+{
+  char stamp[64];
+  Fnv1aHasher hasher;
+  hasher.addBytes(source.data(), source.size());
+
+  std::snprintf(stamp, sizeof(stamp), "// osgHelperShaders source %016" PRIx64 "\n", hasher.get());
+
+  return stamp;
+}
+
+std::size_t ShaderFactory::getNumShaders() const
+{
+  std::shared_lock<std::shared_mutex> lock(m_shaderCacheMutex);
+  return m_shaderCache.size();
+}
+
+unsigned long long ShaderFactory::getNumKeyMismatches() const
+{
+  return m_numKeyMismatches;
+}
+
+std::string ShaderFactory::getShaderSource(const std::string& key, const std::string& source,
+                                           osg::Shader::Type type)
+{
+  const auto directory = getShaderDirectory();
+  if (directory.empty())
+  {
+    return source;
+  }
+
+  const auto filename = getShaderFilename(key, type);
+  const auto stamp    = getSourceStamp(source);
+
+  {
+    std::shared_lock<std::shared_mutex> lock(m_shaderFilesMutex);
+
+    const auto it = m_shaderFiles.find(filename);
+    if (it != m_shaderFiles.end())
+    {
+      // a file that matches another source is outdated for this one
+      const auto& file = it->second;
+      return ((file.stamp == stamp) && !file.source.empty()) ? file.source : source;
+    }
+  }
+
+  auto file = readShaderFile(std::filesystem::path(directory) / filename, stamp);
+
+  std::unique_lock<std::shared_mutex> lock(m_shaderFilesMutex);
+  const auto& result = m_shaderFiles.emplace(filename, std::move(file)).first->second;
+
+  return ((result.stamp == stamp) && !result.source.empty()) ? result.source : source;
+}
+
+ShaderFactory::ShaderFile ShaderFactory::readShaderFile(const std::filesystem::path& filename,
+                                                        const std::string&           stamp) const
+{
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(filename, error))
+  {
+    return { stamp, std::string() };
+  }
+
+  std::ifstream     stream(filename, std::ios::binary);
+  std::stringstream text;
+  text << stream.rdbuf();
+
+  const auto source = text.str();
+  if (!stream.is_open() || (source.size() <= stamp.size()))
+  {
+    UTILS_LOG_WARN("Could not read shader file '" + filename.string() + "', using the passed source");
+    return { stamp, std::string() };
+  }
+
+  if (source.compare(0, stamp.size(), stamp) != 0)
+  {
+    UTILS_LOG_WARN("Shader file '" + filename.string() + "' was made from another source, using the passed source");
+    return { stamp, std::string() };
+  }
+
+  return { stamp, source.substr(stamp.size()) };
+}
+
+osg::ref_ptr<osg::Shader> ShaderFactory::findShader(std::size_t hash, const std::string& source,
+                                                    osg::Shader::Type type) const
+{
+  const auto range = m_shaderCache.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if ((it->second->getType() == type) && (it->second->getShaderSource() == source))
+    {
+      return it->second;
+    }
+  }
+
+  return nullptr;
+}
+
+bool ShaderFactory::isKnownKey(const std::string& key, const osg::Shader* shader) const
+{
+  const auto range = m_shaderKeys.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (it->second == shader)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ShaderFactory::addKey(const std::string& key, const osg::Shader* shader)
+{
+  if (m_shaderKeys.count(key) > 0)
+  {
+    m_numKeyMismatches++;
+    UTILS_LOG_WARN("Shader key '" + key + "' is used for different sources, the shaders are kept apart");
+  }
+
+  m_shaderKeys.emplace(key, shader);
 }
 
 }
@@ -0,0 +1,159 @@
+#include <osgHelper/ShaderMinifier.h>
+
+#include <cctype>
+#include <cstring>
+
+namespace osgHelper
+{
+
+static bool isWordChar(char c)
+{
+  return std::isalnum(static_cast<unsigned char>(c)) || (c == '_') || (c == '.');
+}
+
+static bool isOperatorChar(char c)
+{
+  return (c != '\0') && (std::strchr("+-*/%<>=!&|^", c) != nullptr);
+}
+
+// e.g. "a b" or "a - -b", joining the characters would form another token
+static bool needsSpace(char previous, char next)
+{
+  return (isWordChar(previous) && isWordChar(next)) || (isOperatorChar(previous) && isOperatorChar(next));
+}
+
+// replaces comments by whitespace and joins continued lines, keeps the line breaks of block comments
+static std::string stripComments(const std::string& source)
+{
+  std::string text;
+  text.reserve(source.size());
+
+  std::size_t i = 0;
+  while (i < source.size())
+  {
+    if ((source[i] == '/') && (i + 1 < source.size()) && (source[i + 1] == '/'))
+    {
+      i = source.find('\n', i);
+      if (i == std::string::npos)
+      {
+        break;
+      }
+    }
+    else if ((source[i] == '/') && (i + 1 < source.size()) && (source[i + 1] == '*'))
+    {
+      const auto end = source.find("*/", i + 2);
+      const auto hasLineBreak =
+        source.find('\n', i) < ((end == std::string::npos) ? source.size() : end);
+
+      text += hasLineBreak ? '\n' : ' ';
+      if (end == std::string::npos)
+      {
+        break;
+      }
+
+      i = end + 2;
+    }
+    else if ((source[i] == '\\') && (i + 1 < source.size()) && (source[i + 1] == '\n'))
+    {
+      i += 2;
+    }
+    else if ((source[i] == '\\') && (i + 2 < source.size()) && (source[i + 1] == '\r') && (source[i + 2] == '\n'))
+    {
+      i += 3;
+    }
+    else
+    {
+      text += source[i++];
+    }
+  }
+
+  return text;
+}
+
+std::string ShaderMinifier::minify(const std::string& source)
+{
+  const auto text = stripComments(source);
+
+  std::string output;
+  output.reserve(text.size());
+
+  auto previous       = '\0';
+  auto isSpacePending = false;
+
+  std::size_t begin = 0;
+  while (begin < text.size())
+  {
+    auto end = text.find('\n', begin);
+    if (end == std::string::npos)
+    {
+      end = text.size();
+    }
+
+    auto pos = begin;
+    while ((pos < end) && std::isspace(static_cast<unsigned char>(text[pos])))
+    {
+      pos++;
+    }
+
+    if ((pos < end) && (text[pos] == '#'))
+    {
+      // directives keep single spaces, e.g. "#define F(x)" and "#define F (x)" differ
+      if (!output.empty() && (output.back() != '\n'))
+      {
+        output += '\n';
+      }
+
+      auto isSpace = false;
+      for (; pos < end; pos++)
+      {
+        if (std::isspace(static_cast<unsigned char>(text[pos])))
+        {
+          isSpace = true;
+          continue;
+        }
+
+        if (isSpace)
+        {
+          output += ' ';
+          isSpace = false;
+        }
+
+        output += text[pos];
+      }
+
+      output += '\n';
+      previous       = '\0';
+      isSpacePending = false;
+    }
+    else
+    {
+      for (; pos < end; pos++)
+      {
+        const auto c = text[pos];
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+          isSpacePending = true;
+          continue;
+        }
+
+        if (isSpacePending && needsSpace(previous, c))
+        {
+          output += ' ';
+        }
+
+        output += c;
+        previous       = c;
+        isSpacePending = false;
+      }
+
+      // the line break separates tokens as well
+      isSpacePending = true;
+    }
+
+    begin = end + 1;
+  }
+
+  return output;
+}
+
+}
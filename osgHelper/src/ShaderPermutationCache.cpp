@@ -0,0 +1,222 @@
+#include <osgHelper/ShaderPermutationCache.h>
+
+#include "CacheUtils.h"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace osgHelper
+{
+
+namespace
+{
+
+// combines the hashes of all components, std::hash of strings processes words instead of single bytes
+class PermutationHasher
+{
+public:
+  void add(const std::string& str)
+  {
+    addValue(str.size());
+    combine(std::hash<std::string_view>()(str));
+  }
+
+  template <typename T>
+  void addValue(T value)
+  {
+    combine(std::hash<T>()(value));
+  }
+
+  std::size_t get() const
+  {
+    return m_hash;
+  }
+
+private:
+  std::size_t m_hash = 0;
+
+  void combine(std::size_t hash)
+  {
+    hashCombine(m_hash, hash);
+  }
+
+};
+
+struct PermutationHash
+{
+  std::size_t operator()(const ShaderPermutationCache::Permutation& permutation) const
+  {
+    return permutation.getHash();
+  }
+};
+
+}
+
+std::size_t ShaderPermutationCache::Permutation::getHash() const
+{
+  PermutationHasher hasher;
+  hasher.addValue(static_cast<int>(type));
+  hasher.addValue(version);
+
+  hasher.addValue(extensions.size());
+  for (const auto& extension : extensions)
+  {
+    hasher.add(extension);
+  }
+
+  hasher.addValue(defines.size());
+  for (const auto& define : defines)
+  {
+    hasher.add(define.first);
+    hasher.add(define.second);
+  }
+
+  hasher.addValue(modules.size());
+  for (const auto& module : modules)
+  {
+    hasher.add(module);
+  }
+
+  return hasher.get();
+}
+
+bool ShaderPermutationCache::Permutation::operator==(const Permutation& rhs) const
+{
+  return (type == rhs.type) && (version == rhs.version) && (extensions == rhs.extensions) &&
+         (defines == rhs.defines) && (modules == rhs.modules);
+}
+
+struct ShaderPermutationCache::Impl
+{
+  struct Entry
+  {
+    osg::ref_ptr<osg::Shader> shader;
+    unsigned long long        lastUse;
+  };
+
+  using ShaderDictionary = std::unordered_map<Permutation, Entry, PermutationHash>;
+
+  explicit Impl(std::size_t maxNumShaders)
+    : maxNumShaders(maxNumShaders)
+    , useCounter(0)
+  {
+  }
+
+  std::size_t        maxNumShaders;
+  unsigned long long useCounter;
+  ShaderDictionary   shaders;
+  Statistics         statistics;
+  mutable std::mutex mutex;
+
+  void evict(std::size_t numShaders)
+  {
+    if (shaders.size() <= numShaders)
+    {
+      return;
+    }
+
+    for (auto it = shaders.begin(); it != shaders.end();)
+    {
+      if (it->second.shader->referenceCount() == 1)
+      {
+        it = shaders.erase(it);
+        statistics.numEvictions++;
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    while (shaders.size() > numShaders)
+    {
+      shaders.erase(std::min_element(shaders.begin(), shaders.end(),
+        [](const ShaderDictionary::value_type& lhs, const ShaderDictionary::value_type& rhs)
+        {
+          return lhs.second.lastUse < rhs.second.lastUse;
+        }));
+
+      statistics.numEvictions++;
+    }
+  }
+};
+
+ShaderPermutationCache::ShaderPermutationCache(std::size_t maxNumShaders)
+  : osg::Referenced()
+  , m(new Impl(maxNumShaders))
+{
+}
+
+ShaderPermutationCache::~ShaderPermutationCache() = default;
+
+osg::ref_ptr<osg::Shader> ShaderPermutationCache::getOrCreate(const Permutation& permutation, const CreateFunc& create)
+{
+  {
+    std::lock_guard<std::mutex> lock(m->mutex);
+    m->statistics.numLookups++;
+
+    const auto it = m->shaders.find(permutation);
+    if (it != m->shaders.end())
+    {
+      m->statistics.numHits++;
+      it->second.lastUse = ++m->useCounter;
+      return it->second.shader;
+    }
+  }
+
+  const auto shader = create(permutation);
+
+  // another thread might have created the same permutation in the meantime, all callers get the same shader
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  const auto result = m->shaders.emplace(permutation, Impl::Entry{ shader, ++m->useCounter });
+  if (!result.second)
+  {
+    return result.first->second.shader;
+  }
+
+  // the new shader is still referenced here, so it is not evicted as unused
+  m->evict(m->maxNumShaders);
+
+  return shader;
+}
+
+void ShaderPermutationCache::setMaxNumShaders(std::size_t maxNumShaders)
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->maxNumShaders = maxNumShaders;
+  m->evict(maxNumShaders);
+}
+
+std::size_t ShaderPermutationCache::getMaxNumShaders() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  return m->maxNumShaders;
+}
+
+ShaderPermutationCache::Statistics ShaderPermutationCache::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  auto statistics       = m->statistics;
+  statistics.numShaders = m->shaders.size();
+
+  return statistics;
+}
+
+void ShaderPermutationCache::resetStatistics()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->statistics = Statistics();
+}
+
+void ShaderPermutationCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->shaders.clear();
+}
+
+}
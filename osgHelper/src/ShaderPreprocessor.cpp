@@ -0,0 +1,661 @@
+#include <osgHelper/ShaderPreprocessor.h>
+#include <osgHelper/GameException.h>
+
+#include "CacheUtils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace osgHelper
+{
+
+namespace
+{
+
+enum class DirectiveType
+{
+  None,
+  Include,
+  IfDef,
+  IfNDef,
+  If,
+  Elif,
+  Else,
+  EndIf,
+  Define,
+  Undef,
+  PragmaOnce,
+  Version
+};
+
+struct Line
+{
+  DirectiveType type = DirectiveType::None;
+  std::string   text;     //!< the whole line
+  std::string   argument; //!< the macro or include name, the expression of #if and #elif
+};
+
+struct ParsedSource
+{
+  std::vector<Line> lines;
+};
+
+using ParsedSourcePtr = std::shared_ptr<const ParsedSource>;
+
+const char* Whitespace = " \t\r";
+
+std::string trim(const std::string& str)
+{
+  const auto begin = str.find_first_not_of(Whitespace);
+  if (begin == std::string::npos)
+  {
+    return "";
+  }
+
+  return str.substr(begin, str.find_last_not_of(Whitespace) - begin + 1);
+}
+
+std::string getIdentifier(const std::string& str)
+{
+  std::size_t end = 0;
+  while ((end < str.size()) && (std::isalnum(static_cast<unsigned char>(str[end])) || (str[end] == '_')))
+  {
+    end++;
+  }
+
+  return str.substr(0, end);
+}
+
+Line parseLine(const std::string& text)
+{
+  Line line;
+  line.text = text;
+
+  auto pos = text.find_first_not_of(Whitespace);
+  if ((pos == std::string::npos) || (text[pos] != '#'))
+  {
+    return line;
+  }
+
+  pos = text.find_first_not_of(Whitespace, pos + 1);
+  if (pos == std::string::npos)
+  {
+    return line;
+  }
+
+  const auto end       = text.find_first_of(Whitespace, pos);
+  const auto directive = text.substr(pos, end - pos);
+  const auto rest      = (end == std::string::npos) ? std::string() : trim(text.substr(end));
+
+  if (directive == "include")
+  {
+    const auto closing = rest.empty() ? std::string::npos : rest.find((rest[0] == '<') ? '>' : '"', 1);
+    if (((rest.empty()) || ((rest[0] != '"') && (rest[0] != '<'))) || (closing == std::string::npos))
+    {
+      throw GameException("Invalid include directive '" + text + "'");
+    }
+
+    line.type     = DirectiveType::Include;
+    line.argument = rest.substr(1, closing - 1);
+  }
+  else if ((directive == "ifdef") || (directive == "ifndef") || (directive == "define") || (directive == "undef"))
+  {
+    line.type     = (directive == "ifdef")    ? DirectiveType::IfDef
+                    : (directive == "ifndef") ? DirectiveType::IfNDef
+                    : (directive == "define") ? DirectiveType::Define
+                                              : DirectiveType::Undef;
+    line.argument = getIdentifier(rest);
+  }
+  else if ((directive == "if") || (directive == "elif"))
+  {
+    line.type     = (directive == "if") ? DirectiveType::If : DirectiveType::Elif;
+    line.argument = rest;
+  }
+  else if (directive == "else")
+  {
+    line.type = DirectiveType::Else;
+  }
+  else if (directive == "endif")
+  {
+    line.type = DirectiveType::EndIf;
+  }
+  else if ((directive == "pragma") && (getIdentifier(rest) == "once"))
+  {
+    line.type = DirectiveType::PragmaOnce;
+  }
+  else if (directive == "version")
+  {
+    line.type = DirectiveType::Version;
+  }
+
+  return line;
+}
+
+ParsedSourcePtr parseSource(const std::string& source)
+{
+  auto parsed = std::make_shared<ParsedSource>();
+
+  // a line break at the end of the source does not start another line
+  std::size_t begin = 0;
+  while (begin < source.size())
+  {
+    auto end = source.find('\n', begin);
+    if (end == std::string::npos)
+    {
+      end = source.size();
+    }
+
+    parsed->lines.push_back(parseLine(source.substr(begin, end - begin)));
+    begin = end + 1;
+  }
+
+  return parsed;
+}
+
+std::size_t getExpansionHash(const std::string& source, const ShaderPreprocessor::Defines& defines, int version)
+{
+  std::size_t hash = std::hash<std::string>()(source) ^ std::hash<int>()(version);
+
+  for (const auto& define : defines)
+  {
+    hashCombine(hash, std::hash<std::string>()(define.first));
+    hashCombine(hash, std::hash<std::string>()(define.second));
+  }
+
+  return hash;
+}
+
+}
+
+struct ShaderPreprocessor::Impl
+{
+  struct Expansion
+  {
+    std::string              source;
+    Defines                  defines;
+    int                      version;
+    std::string              expanded;
+    std::vector<ResourceKey> includedFiles;
+  };
+
+  using ParsedSourceDictionary = std::unordered_map<ResourceKey, ParsedSourcePtr, ResourceKey::Hash>;
+  using ExpansionDictionary    = std::unordered_multimap<std::size_t, Expansion>; //!< by source and defines
+
+  osg::ref_ptr<IResourceManager> resourceManager;
+
+  ParsedSourceDictionary parsedFiles;
+  ExpansionDictionary    expansions;
+  bool                   isLineDirectivesEnabled = true;
+  unsigned long long     generation              = 0; //!< incremented by each invalidation
+  Statistics             statistics;
+  mutable std::mutex     mutex;
+
+  ParsedSourcePtr getParsedFile(const ResourceKey& key)
+  {
+    unsigned long long parsedGeneration;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      const auto it = parsedFiles.find(key);
+      if (it != parsedFiles.end())
+      {
+        return it->second;
+      }
+
+      parsedGeneration = generation;
+    }
+
+    const auto parsed = parseSource(resourceManager->loadText(key));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    statistics.numParsedFiles++;
+
+    // the file might have changed while it was parsed
+    if (parsedGeneration == generation)
+    {
+      parsedFiles.emplace(key, parsed);
+    }
+
+    return parsed;
+  }
+
+};
+
+namespace
+{
+
+class Expander
+{
+public:
+  using GetParsedFileFunc = std::function<ParsedSourcePtr(const ResourceKey&)>;
+
+  /**
+   * @param version GLSL version, #line sets the number of the following line since 330 and GLSL ES 300,
+   *                the number of the directive itself before
+   */
+  Expander(const ShaderPreprocessor::Defines& defines, const GetParsedFileFunc& getParsedFile,
+           bool hasLineDirectives, int version)
+    : m_getParsedFile(getParsedFile)
+    , m_numVerbatimSections(0)
+    , m_hasLineDirectives(hasLineDirectives)
+    , m_lineOffset(((version >= 330) || (version == 300)) ? 0 : 1)
+    , m_outputSourceNumber(-1)
+    , m_outputLineNumber(0)
+  {
+    for (const auto& define : defines)
+    {
+      m_macros[define.first] = MacroState::Defined;
+    }
+  }
+
+  void expand(const ParsedSource& source, const std::string& name)
+  {
+    // a #version directive has to come first, the output then starts at line 1 of source string 0
+    const auto hasVersion = std::any_of(source.lines.begin(), source.lines.end(),
+      [](const Line& line) { return line.type == DirectiveType::Version; });
+
+    if (hasVersion)
+    {
+      m_outputSourceNumber = 0;
+      m_outputLineNumber   = 1;
+    }
+
+    expand(source, name, 0);
+  }
+
+  const std::string& getOutput() const
+  {
+    return m_output;
+  }
+
+  std::vector<ResourceKey> getIncludedFiles() const
+  {
+    return std::vector<ResourceKey>(m_includedFiles.begin(), m_includedFiles.end());
+  }
+
+private:
+  enum class MacroState
+  {
+    Defined,
+    Undefined,
+    Unknown
+  };
+
+  enum class SectionType
+  {
+    Resolved, //!< only the active branch is emitted
+    Verbatim, //!< emitted including the directives, evaluated by the GL compiler
+    Skipped   //!< within an inactive branch
+  };
+
+  struct Section
+  {
+    SectionType type;
+    bool        isActive;
+    bool        isTaken;
+  };
+
+  using ResourceKeySet = std::unordered_set<ResourceKey, ResourceKey::Hash>;
+
+  GetParsedFileFunc                                       m_getParsedFile;
+  std::unordered_map<std::string, MacroState>             m_macros;
+  ResourceKeySet                                          m_includedFiles; //!< including those of verbatim sections
+  ResourceKeySet                                          m_guardedFiles;  //!< included outside of verbatim sections
+  std::unordered_map<ResourceKey, int, ResourceKey::Hash> m_sourceNumbers;
+  std::vector<ResourceKey>                                m_includeStack;
+  int                                                     m_numVerbatimSections;
+  bool                                                    m_hasLineDirectives;
+  int                                                     m_lineOffset;
+  int                                                     m_outputSourceNumber; //!< of the next output line
+  int                                                     m_outputLineNumber;   //!< of the next output line
+  std::string                                             m_output;
+  bool                                                    m_hasOutput = false;
+
+  void expand(const ParsedSource& source, const std::string& name, int sourceNumber)
+  {
+    std::vector<Section> sections;
+    auto                 lineNumber = 0;
+
+    const auto isEmitting = [&sections]()
+    {
+      return sections.empty() || sections.back().isActive;
+    };
+
+    const auto getSection = [&sections, &name]() -> Section&
+    {
+      if (sections.empty())
+      {
+        throw GameException("Conditional directive without #if in '" + name + "'");
+      }
+
+      return sections.back();
+    };
+
+    const auto emit = [this, &name, sourceNumber, &lineNumber](const std::string& text)
+    {
+      emitLine(text, name, sourceNumber, lineNumber);
+    };
+
+    for (const auto& line : source.lines)
+    {
+      lineNumber++;
+
+      switch (line.type)
+      {
+      case DirectiveType::None:
+      case DirectiveType::Version:
+        if (isEmitting())
+        {
+          emit(line.text);
+        }
+        break;
+
+      case DirectiveType::Include:
+        if (isEmitting())
+        {
+          include(line.argument);
+        }
+        break;
+
+      case DirectiveType::IfDef:
+      case DirectiveType::IfNDef:
+      {
+        if (!isEmitting())
+        {
+          sections.push_back({ SectionType::Skipped, false, false });
+          break;
+        }
+
+        const auto state = getMacroState(line.argument);
+        if (state == MacroState::Unknown)
+        {
+          beginVerbatimSection(sections);
+          emit(line.text);
+          break;
+        }
+
+        const auto isActive = ((state == MacroState::Defined) == (line.type == DirectiveType::IfDef));
+        sections.push_back({ SectionType::Resolved, isActive, isActive });
+        break;
+      }
+
+      case DirectiveType::If:
+        if (!isEmitting())
+        {
+          sections.push_back({ SectionType::Skipped, false, false });
+          break;
+        }
+
+        beginVerbatimSection(sections);
+        emit(line.text);
+        break;
+
+      case DirectiveType::Elif:
+      {
+        auto& section = getSection();
+        if (section.type == SectionType::Verbatim)
+        {
+          emit(line.text);
+        }
+        else if (section.type == SectionType::Resolved)
+        {
+          if (section.isTaken)
+          {
+            section.isActive = false;
+          }
+          else
+          {
+            // the remaining branches are left to the GL compiler
+            sections.pop_back();
+            beginVerbatimSection(sections);
+            emit("#if " + line.argument);
+          }
+        }
+        break;
+      }
+
+      case DirectiveType::Else:
+      {
+        auto& section = getSection();
+        if (section.type == SectionType::Verbatim)
+        {
+          emit(line.text);
+        }
+        else if (section.type == SectionType::Resolved)
+        {
+          section.isActive = !section.isTaken;
+          section.isTaken  = true;
+        }
+        break;
+      }
+
+      case DirectiveType::EndIf:
+        if (getSection().type == SectionType::Verbatim)
+        {
+          emit(line.text);
+          m_numVerbatimSections--;
+        }
+
+        sections.pop_back();
+        break;
+
+      case DirectiveType::Define:
+      case DirectiveType::Undef:
+        if (isEmitting())
+        {
+          emit(line.text);
+
+          // defined or not depending on a condition the GL compiler evaluates
+          m_macros[line.argument] = (m_numVerbatimSections > 0)                ? MacroState::Unknown
+                                    : (line.type == DirectiveType::Define) ? MacroState::Defined
+                                                                           : MacroState::Undefined;
+        }
+        break;
+
+      case DirectiveType::PragmaOnce:
+        // files are included once outside of verbatim sections anyway
+        break;
+      }
+    }
+
+    if (!sections.empty())
+    {
+      throw GameException("Unterminated conditional section in '" + name + "'");
+    }
+  }
+
+  void include(const ResourceKey& key)
+  {
+    // the GL compiler might not take the branch, so it neither includes the file for good nor skips a file
+    // that is included in another branch
+    if (m_numVerbatimSections == 0)
+    {
+      if (!m_guardedFiles.insert(key).second)
+      {
+        return;
+      }
+    }
+    else if (m_guardedFiles.count(key) > 0)
+    {
+      return;
+    }
+
+    // recursive includes end as they would with an include guard
+    if (std::find(m_includeStack.begin(), m_includeStack.end(), key) != m_includeStack.end())
+    {
+      return;
+    }
+
+    m_includedFiles.insert(key);
+
+    const auto sourceNumber = static_cast<int>(m_sourceNumbers.size()) + 1;
+    const auto it           = m_sourceNumbers.emplace(key, sourceNumber).first;
+
+    m_includeStack.push_back(key);
+    expand(*m_getParsedFile(key), key.str(), it->second);
+    m_includeStack.pop_back();
+  }
+
+  MacroState getMacroState(const std::string& name) const
+  {
+    const auto it = m_macros.find(name);
+    if (it != m_macros.end())
+    {
+      return it->second;
+    }
+
+    // predefined by the GL compiler, e.g. GL_ES, __VERSION__ or the macros of supported extensions
+    if ((name.compare(0, 3, "GL_") == 0) || (name.compare(0, 2, "__") == 0))
+    {
+      return MacroState::Unknown;
+    }
+
+    return MacroState::Undefined;
+  }
+
+  void beginVerbatimSection(std::vector<Section>& sections)
+  {
+    sections.push_back({ SectionType::Verbatim, true, false });
+    m_numVerbatimSections++;
+  }
+
+  void emitLine(const std::string& text, const std::string& name, int sourceNumber, int lineNumber)
+  {
+    // after an include or a stripped section, the name is only a comment for the reader
+    if (m_hasLineDirectives && ((sourceNumber != m_outputSourceNumber) || (lineNumber != m_outputLineNumber)))
+    {
+      append("#line " + std::to_string(lineNumber - m_lineOffset) + " " + std::to_string(sourceNumber) +
+             " // " + name);
+    }
+
+    append(text);
+
+    m_outputSourceNumber = sourceNumber;
+    m_outputLineNumber   = lineNumber + 1;
+  }
+
+  void append(const std::string& text)
+  {
+    if (m_hasOutput)
+    {
+      m_output += '\n';
+    }
+
+    m_output += text;
+    m_hasOutput = true;
+  }
+
+};
+
+}
+
+ShaderPreprocessor::ShaderPreprocessor(const osg::ref_ptr<IResourceManager>& resourceManager)
+  : osg::Referenced()
+  , m(new Impl())
+{
+  m->resourceManager = resourceManager;
+}
+
+ShaderPreprocessor::~ShaderPreprocessor() = default;
+
+std::string ShaderPreprocessor::process(const std::string& source, const Defines& defines, int version)
+{
+  const auto hash = getExpansionHash(source, defines, version);
+
+  unsigned long long expansionGeneration;
+  bool               hasLineDirectives;
+  {
+    std::lock_guard<std::mutex> lock(m->mutex);
+
+    const auto range = m->expansions.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if ((it->second.source == source) && (it->second.defines == defines) && (it->second.version == version))
+      {
+        m->statistics.numCacheHits++;
+        return it->second.expanded;
+      }
+    }
+
+    expansionGeneration = m->generation;
+    hasLineDirectives   = m->isLineDirectivesEnabled;
+  }
+
+  Expander expander(defines, [this](const ResourceKey& key)
+  {
+    return m->getParsedFile(key);
+  }, hasLineDirectives, version);
+
+  expander.expand(*parseSource(source), "shader source");
+
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->statistics.numExpansions++;
+
+  // an included file might have changed while the source was expanded
+  if (expansionGeneration == m->generation)
+  {
+    m->expansions.emplace(hash, Impl::Expansion{ source, defines, version, expander.getOutput(),
+                                                 expander.getIncludedFiles() });
+  }
+
+  return expander.getOutput();
+}
+
+void ShaderPreprocessor::invalidate(const ResourceKey& includeKey)
+{
+  m->resourceManager->clearCacheResource(includeKey);
+
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->generation++;
+  m->parsedFiles.erase(includeKey);
+
+  auto it = m->expansions.begin();
+  while (it != m->expansions.end())
+  {
+    const auto& includedFiles = it->second.includedFiles;
+    if (std::find(includedFiles.begin(), includedFiles.end(), includeKey) != includedFiles.end())
+    {
+      it = m->expansions.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void ShaderPreprocessor::setLineDirectivesEnabled(bool enabled)
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->isLineDirectivesEnabled = enabled;
+  m->generation++;
+  m->expansions.clear();
+}
+
+bool ShaderPreprocessor::isLineDirectivesEnabled() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  return m->isLineDirectivesEnabled;
+}
+
+void ShaderPreprocessor::clear()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->generation++;
+  m->parsedFiles.clear();
+  m->expansions.clear();
+}
+
+ShaderPreprocessor::Statistics ShaderPreprocessor::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  return m->statistics;
+}
+
+}
@@ -0,0 +1,490 @@
+#include <osgHelper/GameException.h>
+#include <osgHelper/TextureAtlas.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osgHelper
+{
+
+namespace
+{
+
+struct PackRect
+{
+  int x;
+  int y;
+  int width;
+  int height;
+
+  int right() const
+  {
+    return x + width;
+  }
+
+  int top() const
+  {
+    return y + height;
+  }
+
+  bool contains(const PackRect& other) const
+  {
+    return (other.x >= x) && (other.y >= y) && (other.right() <= right()) && (other.top() <= top());
+  }
+
+  bool intersects(const PackRect& other) const
+  {
+    return (other.x < right()) && (other.right() > x) && (other.y < top()) && (other.top() > y);
+  }
+};
+
+int getNumComponents(GLenum pixelFormat)
+{
+  switch (pixelFormat)
+  {
+  case GL_RGBA:
+  case GL_BGRA:
+    return 4;
+  case GL_RGB:
+  case GL_BGR:
+    return 3;
+  case GL_LUMINANCE_ALPHA:
+    return 2;
+  case GL_LUMINANCE:
+  case GL_ALPHA:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+void toRgba(GLenum pixelFormat, const unsigned char* src, unsigned char* dst)
+{
+  switch (pixelFormat)
+  {
+  case GL_RGBA:
+    std::memcpy(dst, src, 4);
+    break;
+  case GL_BGRA:
+    dst[0] = src[2];
+    dst[1] = src[1];
+    dst[2] = src[0];
+    dst[3] = src[3];
+    break;
+  case GL_RGB:
+    std::memcpy(dst, src, 3);
+    dst[3] = 255;
+    break;
+  case GL_BGR:
+    dst[0] = src[2];
+    dst[1] = src[1];
+    dst[2] = src[0];
+    dst[3] = 255;
+    break;
+  case GL_LUMINANCE_ALPHA:
+    std::memset(dst, src[0], 3);
+    dst[3] = src[1];
+    break;
+  case GL_LUMINANCE:
+    std::memset(dst, src[0], 3);
+    dst[3] = 255;
+    break;
+  case GL_ALPHA:
+    std::memset(dst, 255, 3);
+    dst[3] = src[0];
+    break;
+  default:
+    break;
+  }
+}
+
+}
+
+struct TextureAtlas::Impl
+{
+  Impl(int pageSize, int border)
+    : pageSize(pageSize)
+    , border(border)
+    , nextId(1)
+  {
+  }
+
+  struct Page
+  {
+    osg::ref_ptr<osg::Image>     image;
+    osg::ref_ptr<osg::Texture2D> texture;
+    std::vector<PackRect>        freeRects;
+    unsigned int                 numRegions = 0;
+  };
+
+  struct Placement
+  {
+    int      page           = -1;
+    PackRect rect           = { 0, 0, 0, 0 };
+    int      shortSideScore = INT_MAX;
+    int      longSideScore  = INT_MAX;
+  };
+
+  int pageSize;
+  int border;
+
+  RegionId nextId;
+
+  std::vector<Page>                    pages;
+  std::unordered_map<RegionId, Region> regions;
+  mutable std::mutex                   mutex;
+
+  void addPage()
+  {
+    Page page;
+    page.image = new osg::Image();
+    page.image->allocateImage(pageSize, pageSize, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+    page.image->setInternalTextureFormat(GL_RGBA8);
+    page.image->setDataVariance(osg::Object::DYNAMIC);
+    std::memset(page.image->data(), 0, page.image->getImageSizeInBytes());
+
+    page.texture = new osg::Texture2D();
+    page.texture->setDataVariance(osg::Object::DYNAMIC);
+    page.texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+    page.texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+    page.texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+    page.texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+    page.texture->setResizeNonPowerOfTwoHint(false);
+    page.texture->setImage(page.image);
+
+    page.freeRects.push_back({ 0, 0, pageSize, pageSize });
+
+    pages.push_back(page);
+  }
+
+  // best short side fit, ties are broken by the long side
+  void findPlacement(int pageIndex, int width, int height, Placement& best) const
+  {
+    for (const auto& freeRect : pages[pageIndex].freeRects)
+    {
+      if ((freeRect.width < width) || (freeRect.height < height))
+      {
+        continue;
+      }
+
+      const auto leftoverX      = freeRect.width - width;
+      const auto leftoverY      = freeRect.height - height;
+      const auto shortSideScore = std::min(leftoverX, leftoverY);
+      const auto longSideScore  = std::max(leftoverX, leftoverY);
+
+      if ((shortSideScore < best.shortSideScore) ||
+          ((shortSideScore == best.shortSideScore) && (longSideScore < best.longSideScore)))
+      {
+        best.page           = pageIndex;
+        best.rect           = { freeRect.x, freeRect.y, width, height };
+        best.shortSideScore = shortSideScore;
+        best.longSideScore  = longSideScore;
+      }
+    }
+  }
+
+  static void pruneFreeRects(std::vector<PackRect>& freeRects)
+  {
+    for (std::size_t i = 0; i < freeRects.size(); i++)
+    {
+      for (std::size_t j = i + 1; j < freeRects.size(); j++)
+      {
+        if (freeRects[j].contains(freeRects[i]))
+        {
+          freeRects.erase(freeRects.begin() + i);
+          i--;
+          break;
+        }
+
+        if (freeRects[i].contains(freeRects[j]))
+        {
+          freeRects.erase(freeRects.begin() + j);
+          j--;
+        }
+      }
+    }
+  }
+
+  // every free rectangle overlapped by the used one is replaced by the maximal rectangles around it
+  static void splitFreeRects(std::vector<PackRect>& freeRects, const PackRect& used)
+  {
+    std::vector<PackRect> result;
+    result.reserve(freeRects.size() + 4);
+
+    for (const auto& freeRect : freeRects)
+    {
+      if (!freeRect.intersects(used))
+      {
+        result.push_back(freeRect);
+        continue;
+      }
+
+      if (used.x > freeRect.x)
+      {
+        result.push_back({ freeRect.x, freeRect.y, used.x - freeRect.x, freeRect.height });
+      }
+
+      if (used.right() < freeRect.right())
+      {
+        result.push_back({ used.right(), freeRect.y, freeRect.right() - used.right(), freeRect.height });
+      }
+
+      if (used.y > freeRect.y)
+      {
+        result.push_back({ freeRect.x, freeRect.y, freeRect.width, used.y - freeRect.y });
+      }
+
+      if (used.top() < freeRect.top())
+      {
+        result.push_back({ freeRect.x, used.top(), freeRect.width, freeRect.top() - used.top() });
+      }
+    }
+
+    freeRects.swap(result);
+    pruneFreeRects(freeRects);
+  }
+
+  // joins free rectangles sharing a full edge, so that removed regions can be reused by larger images
+  static void mergeFreeRects(std::vector<PackRect>& freeRects)
+  {
+    auto merged = true;
+    while (merged)
+    {
+      merged = false;
+      for (std::size_t i = 0; (i < freeRects.size()) && !merged; i++)
+      {
+        for (std::size_t j = 0; (j < freeRects.size()) && !merged; j++)
+        {
+          if (i == j)
+          {
+            continue;
+          }
+
+          auto&       a = freeRects[i];
+          const auto& b = freeRects[j];
+
+          if ((a.y == b.y) && (a.height == b.height) && (a.right() == b.x))
+          {
+            a.width += b.width;
+            merged = true;
+          }
+          else if ((a.x == b.x) && (a.width == b.width) && (a.top() == b.y))
+          {
+            a.height += b.height;
+            merged = true;
+          }
+
+          if (merged)
+          {
+            freeRects.erase(freeRects.begin() + j);
+          }
+        }
+      }
+    }
+
+    pruneFreeRects(freeRects);
+  }
+
+  void copyImage(const osg::Image& image, Page& page, const PackRect& rect) const
+  {
+    const auto pixelFormat   = image.getPixelFormat();
+    const auto numComponents = getNumComponents(pixelFormat);
+    const auto srcRowStep    = image.getRowStepInBytes();
+    const auto dstRowStep    = page.image->getRowStepInBytes();
+    const auto src           = image.data();
+    const auto dst           = page.image->data();
+
+    // the border repeats the edge pixels of the image
+    for (auto row = 0; row < rect.height; row++)
+    {
+      const auto srcRow  = std::clamp(row - border, 0, image.t() - 1);
+      const auto srcLine = src + srcRow * srcRowStep;
+      const auto dstLine = dst + (rect.y + row) * dstRowStep + rect.x * 4;
+
+      for (auto column = 0; column < rect.width; column++)
+      {
+        const auto srcColumn = std::clamp(column - border, 0, image.s() - 1);
+        toRgba(pixelFormat, srcLine + srcColumn * numComponents, dstLine + column * 4);
+      }
+    }
+
+    page.image->dirty();
+  }
+};
+
+TextureAtlas::TextureAtlas(int pageSize, int border)
+  : osg::Referenced()
+  , m(new Impl(pageSize, border))
+{
+  if ((pageSize <= 0) || (border < 0) || (2 * border >= pageSize))
+  {
+    throw GameException("Invalid texture atlas page size or border");
+  }
+}
+
+TextureAtlas::~TextureAtlas() = default;
+
+int TextureAtlas::getPageSize() const
+{
+  return m->pageSize;
+}
+
+int TextureAtlas::getBorder() const
+{
+  return m->border;
+}
+
+TextureAtlas::Region TextureAtlas::insert(const osg::ref_ptr<osg::Image>& image)
+{
+  if (!image.valid() || (image->s() <= 0) || (image->t() <= 0) || (image->r() != 1) || !image->data())
+  {
+    throw GameException("Texture atlas images must be 2D images with data");
+  }
+
+  if ((image->getDataType() != GL_UNSIGNED_BYTE) || (getNumComponents(image->getPixelFormat()) == 0))
+  {
+    throw GameException("Unsupported pixel format for texture atlas image '" + image->getFileName() + "'");
+  }
+
+  const auto width  = image->s() + 2 * m->border;
+  const auto height = image->t() + 2 * m->border;
+  if ((width > m->pageSize) || (height > m->pageSize))
+  {
+    throw GameException("Image '" + image->getFileName() + "' is larger than a texture atlas page");
+  }
+
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  Impl::Placement placement;
+  for (auto i = 0; i < static_cast<int>(m->pages.size()); i++)
+  {
+    m->findPlacement(i, width, height, placement);
+  }
+
+  if (placement.page < 0)
+  {
+    m->addPage();
+    m->findPlacement(static_cast<int>(m->pages.size()) - 1, width, height, placement);
+  }
+
+  auto& page = m->pages[placement.page];
+  Impl::splitFreeRects(page.freeRects, placement.rect);
+  m->copyImage(*image, page, placement.rect);
+  page.numRegions++;
+
+  const auto size = static_cast<float>(m->pageSize);
+
+  Region region;
+  region.id     = m->nextId++;
+  region.page   = static_cast<unsigned int>(placement.page);
+  region.x      = placement.rect.x + m->border;
+  region.y      = placement.rect.y + m->border;
+  region.width  = image->s();
+  region.height = image->t();
+  region.uvMin  = osg::Vec2f(region.x / size, region.y / size);
+  region.uvMax  = osg::Vec2f((region.x + region.width) / size, (region.y + region.height) / size);
+
+  m->regions[region.id] = region;
+
+  return region;
+}
+
+bool TextureAtlas::remove(RegionId id)
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  const auto it = m->regions.find(id);
+  if (it == m->regions.end())
+  {
+    return false;
+  }
+
+  const auto& region = it->second;
+  auto&       page   = m->pages[region.page];
+
+  page.numRegions--;
+  if (page.numRegions == 0)
+  {
+    page.freeRects.assign(1, { 0, 0, m->pageSize, m->pageSize });
+  }
+  else
+  {
+    page.freeRects.push_back({ region.x - m->border, region.y - m->border, region.width + 2 * m->border,
+                               region.height + 2 * m->border });
+    Impl::mergeFreeRects(page.freeRects);
+  }
+
+  m->regions.erase(it);
+  return true;
+}
+
+bool TextureAtlas::getRegion(RegionId id, Region& region) const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  const auto it = m->regions.find(id);
+  if (it == m->regions.end())
+  {
+    return false;
+  }
+
+  region = it->second;
+  return true;
+}
+
+unsigned int TextureAtlas::getNumPages() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  return static_cast<unsigned int>(m->pages.size());
+}
+
+osg::ref_ptr<osg::Texture2D> TextureAtlas::getPageTexture(unsigned int page) const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  if (page >= m->pages.size())
+  {
+    return nullptr;
+  }
+
+  return m->pages[page].texture;
+}
+
+osg::ref_ptr<osg::Image> TextureAtlas::getPageImage(unsigned int page) const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  if (page >= m->pages.size())
+  {
+    return nullptr;
+  }
+
+  return m->pages[page].image;
+}
+
+TextureAtlas::Statistics TextureAtlas::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  Statistics statistics;
+  statistics.numPages    = static_cast<unsigned int>(m->pages.size());
+  statistics.numRegions  = static_cast<unsigned int>(m->regions.size());
+  statistics.totalPixels = static_cast<unsigned long long>(m->pageSize) * m->pageSize * m->pages.size();
+
+  for (const auto& region : m->regions)
+  {
+    statistics.usedPixels += static_cast<unsigned long long>(region.second.width) * region.second.height;
+  }
+
+  if (statistics.totalPixels > 0)
+  {
+    statistics.efficiency = static_cast<float>(statistics.usedPixels) / statistics.totalPixels;
+  }
+
+  return statistics;
+}
+
+}
@@ -5,15 +5,20 @@ namespace osgHelper
 
 struct TextureBlueprint::Impl
 {
-  Impl() 
-    : texLayer(0)
+  Impl(const osg::ref_ptr<TextureCache>& cache, const osg::ref_ptr<TextureProcessor>& processor)
+    : cache(cache)
+    , processor(processor)
+    , texLayer(0)
     , dataVariance(osg::Object::DYNAMIC)
     , wrapS(osg::Texture::WrapMode::CLAMP_TO_EDGE)
     , wrapT(osg::Texture::WrapMode::CLAMP_TO_EDGE)
     , minFilter(osg::Texture::FilterMode::LINEAR_MIPMAP_LINEAR)
     , magFilter(osg::Texture::FilterMode::LINEAR)
     , maxAnisotropy(8.0f)
-  {}
+  {
+    processorOptions.mipmapFilter = TextureProcessor::MipmapFilter::None;
+    processorOptions.compression  = TextureProcessor::Compression::None;
+  }
 
   struct BpUniform
   {
@@ -24,6 +29,10 @@ struct TextureBlueprint::Impl
   using BpUniformList = std::vector<BpUniform>;
   using StateSetList  = std::vector<osg::ref_ptr<osg::StateSet>>;
 
+  osg::ref_ptr<TextureCache>     cache;
+  osg::ref_ptr<TextureProcessor> processor;
+  TextureProcessor::Options      processorOptions;
+
   osg::ref_ptr<osg::Image> image;
 
   int texLayer;
@@ -38,11 +47,68 @@ struct TextureBlueprint::Impl
 
   BpUniformList bpUniforms;
   StateSetList assignToStateSets;
+
+  TextureCache::TextureKey getTextureKey() const
+  {
+    TextureCache::TextureKey key;
+    key.image            = image;
+    key.dataVariance     = dataVariance;
+    key.wrapS            = wrapS;
+    key.wrapT            = wrapT;
+    key.minFilter        = minFilter;
+    key.magFilter        = magFilter;
+    key.maxAnisotropy    = maxAnisotropy;
+
+    // other processors, e.g. with other caches or versions, might produce other images for the same options
+    if (isProcessed())
+    {
+      key.processor        = processor;
+      key.processorOptions = processorOptions;
+    }
+
+    return key;
+  }
+
+  bool isProcessed() const
+  {
+    return processor.valid() && ((processorOptions.mipmapFilter != TextureProcessor::MipmapFilter::None) ||
+                                 (processorOptions.compression != TextureProcessor::Compression::None));
+  }
+
+  osg::ref_ptr<osg::Texture2D> createTexture() const
+  {
+    osg::ref_ptr<osg::Texture2D> texture = new osg::Texture2D();
+    texture->setDataVariance(dataVariance);
+    texture->setWrap(osg::Texture::WRAP_S, wrapS);
+    texture->setWrap(osg::Texture::WRAP_T, wrapT);
+    texture->setFilter(osg::Texture::MIN_FILTER, minFilter);
+    texture->setFilter(osg::Texture::MAG_FILTER, magFilter);
+    texture->setMaxAnisotropy(maxAnisotropy);
+
+    if (image.valid() && isProcessed())
+    {
+      const auto processed = processor->process(*image, processorOptions);
+      texture->setImage(processed);
+
+      // compressed images without mipmaps still leave the mipmaps to the driver
+      if (processed->isMipmap())
+      {
+        texture->setUseHardwareMipMapGeneration(false);
+      }
+    }
+    else if (image.valid())
+    {
+      texture->setImage(image);
+    }
+
+    return texture;
+  }
 };
 
-TextureBlueprint::TextureBlueprint()
+TextureBlueprint::TextureBlueprint(const osg::ref_ptr<TextureCache>&     cache,
+                                   const osg::ref_ptr<TextureProcessor>& processor)
   : ITextureBlueprint()
-  , m(new Impl())
+  , m(new Impl(cache, processor))
 {
 
 }
@@ -93,19 +159,30 @@ osg::ref_ptr<ITextureBlueprint> TextureBlueprint::magFilter(osg::Texture::Filter
   return this;
 }
 
+osg::ref_ptr<ITextureBlueprint> TextureBlueprint::mipmaps(TextureProcessor::MipmapFilter filter)
+{
+  m->processorOptions.mipmapFilter = filter;
+  return this;
+}
+
+osg::ref_ptr<ITextureBlueprint> TextureBlueprint::compression(TextureProcessor::Compression compression)
+{
+  m->processorOptions.compression = compression;
+  return this;
+}
+
 osg::ref_ptr<osg::Texture2D> TextureBlueprint::build() const
 {
-  auto texture = new osg::Texture2D();
-  texture->setDataVariance(m->dataVariance);
-  texture->setWrap(osg::Texture::WRAP_S, m->wrapS);
-  texture->setWrap(osg::Texture::WRAP_T, m->wrapT);
-  texture->setFilter(osg::Texture::MIN_FILTER, m->minFilter);
-  texture->setFilter(osg::Texture::MAG_FILTER, m->magFilter);
-  texture->setMaxAnisotropy(m->maxAnisotropy);
-
-  if (m->image.valid())
+  // textures without an image are render targets, they are never shared
+  osg::ref_ptr<osg::Texture2D> texture;
+  if (m->cache.valid() && m->image.valid())
+  {
+    texture = m->cache->getOrCreateTexture(m->getTextureKey(),
+                                           [this](const TextureCache::TextureKey&) { return m->createTexture(); });
+  }
+  else
   {
-    texture->setImage(m->image);
+    texture = m->createTexture();
   }
 
   for (const auto& stateSet : m->assignToStateSets)
@@ -115,12 +192,21 @@ osg::ref_ptr<osg::Texture2D> TextureBlueprint::build() const
 
   for (const auto& uniform : m->bpUniforms)
   {
-    auto uf = new osg::Uniform(osg::Uniform::SAMPLER_2D, uniform.uniformName);
-    uf->set(m->texLayer);
+    osg::ref_ptr<osg::Uniform> uf;
+    if (m->cache.valid())
+    {
+      uf = m->cache->getOrCreateSamplerUniform(uniform.uniformName, m->texLayer);
+    }
+    else
+    {
+      uf = new osg::Uniform(osg::Uniform::SAMPLER_2D, uniform.uniformName);
+      uf->set(m->texLayer);
+    }
+
     uniform.stateSet->addUniform(uf);
   }
 
   return texture;
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,207 @@
+#include <osgHelper/TextureCache.h>
+
+#include "CacheUtils.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace osgHelper
+{
+
+namespace
+{
+
+struct TextureKeyHash
+{
+  std::size_t operator()(const TextureCache::TextureKey& key) const
+  {
+    return key.getHash();
+  }
+};
+
+}
+
+std::size_t TextureCache::TextureKey::getHash() const
+{
+  std::size_t hash = std::hash<const osg::Image*>()(image.get());
+
+  hashCombine(hash, static_cast<std::size_t>(dataVariance));
+  hashCombine(hash, static_cast<std::size_t>(wrapS));
+  hashCombine(hash, static_cast<std::size_t>(wrapT));
+  hashCombine(hash, static_cast<std::size_t>(minFilter));
+  hashCombine(hash, static_cast<std::size_t>(magFilter));
+  hashCombine(hash, std::hash<float>()(maxAnisotropy));
+  hashCombine(hash, std::hash<const TextureProcessor*>()(processor.get()));
+  hashCombine(hash, static_cast<std::size_t>(processorOptions.mipmapFilter));
+  hashCombine(hash, static_cast<std::size_t>(processorOptions.compression));
+
+  return hash;
+}
+
+bool TextureCache::TextureKey::operator==(const TextureKey& rhs) const
+{
+  return (image == rhs.image) && (dataVariance == rhs.dataVariance) && (wrapS == rhs.wrapS) &&
+         (wrapT == rhs.wrapT) && (minFilter == rhs.minFilter) && (magFilter == rhs.magFilter) &&
+         (maxAnisotropy == rhs.maxAnisotropy) && (processor == rhs.processor) &&
+         (processorOptions.mipmapFilter == rhs.processorOptions.mipmapFilter) &&
+         (processorOptions.compression == rhs.processorOptions.compression);
+}
+
+struct TextureCache::Impl
+{
+  struct Entry
+  {
+    osg::ref_ptr<osg::Texture2D> texture;
+    unsigned long long           lastUse;
+  };
+
+  using TextureDictionary = std::unordered_map<TextureKey, Entry, TextureKeyHash>;
+  using UniformDictionary = std::map<std::pair<std::string, int>, osg::ref_ptr<osg::Uniform>>;
+
+  explicit Impl(std::size_t maxNumTextures)
+    : maxNumTextures(maxNumTextures)
+    , useCounter(0)
+  {
+  }
+
+  std::size_t        maxNumTextures;
+  unsigned long long useCounter;
+  TextureDictionary  textures;
+  UniformDictionary  uniforms;
+  Statistics         statistics;
+  mutable std::mutex mutex;
+
+  void evict(std::size_t numTextures)
+  {
+    if (textures.size() <= numTextures)
+    {
+      return;
+    }
+
+    for (auto it = textures.begin(); it != textures.end();)
+    {
+      if (it->second.texture->referenceCount() == 1)
+      {
+        it = textures.erase(it);
+        statistics.numTextureEvictions++;
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    while (textures.size() > numTextures)
+    {
+      textures.erase(std::min_element(textures.begin(), textures.end(),
+        [](const TextureDictionary::value_type& lhs, const TextureDictionary::value_type& rhs)
+        {
+          return lhs.second.lastUse < rhs.second.lastUse;
+        }));
+
+      statistics.numTextureEvictions++;
+    }
+  }
+};
+
+TextureCache::TextureCache(std::size_t maxNumTextures)
+  : osg::Referenced()
+  , m(new Impl(maxNumTextures))
+{
+}
+
+TextureCache::~TextureCache() = default;
+
+osg::ref_ptr<osg::Texture2D> TextureCache::getOrCreateTexture(const TextureKey& key, const CreateFunc& create)
+{
+  {
+    std::lock_guard<std::mutex> lock(m->mutex);
+    m->statistics.numTextureLookups++;
+
+    const auto it = m->textures.find(key);
+    if (it != m->textures.end())
+    {
+      m->statistics.numTextureHits++;
+      it->second.lastUse = ++m->useCounter;
+      return it->second.texture;
+    }
+  }
+
+  // e.g. processing the image takes a while, other textures can be looked up in the meantime
+  const auto texture = create(key);
+
+  // another thread might have created the same texture in the meantime, all callers get the same one
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  const auto result = m->textures.emplace(key, Impl::Entry{ texture, ++m->useCounter });
+  if (!result.second)
+  {
+    return result.first->second.texture;
+  }
+
+  // the new texture is still referenced here, so it is not evicted as unused
+  m->evict(m->maxNumTextures);
+
+  return texture;
+}
+
+osg::ref_ptr<osg::Uniform> TextureCache::getOrCreateSamplerUniform(const std::string& name, int texLayer)
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->statistics.numUniformLookups++;
+
+  auto& uniform = m->uniforms[std::make_pair(name, texLayer)];
+  if (uniform.valid())
+  {
+    m->statistics.numUniformHits++;
+    return uniform;
+  }
+
+  uniform = new osg::Uniform(osg::Uniform::SAMPLER_2D, name);
+  uniform->set(texLayer);
+
+  return uniform;
+}
+
+void TextureCache::setMaxNumTextures(std::size_t maxNumTextures)
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->maxNumTextures = maxNumTextures;
+  m->evict(maxNumTextures);
+}
+
+std::size_t TextureCache::getMaxNumTextures() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  return m->maxNumTextures;
+}
+
+TextureCache::Statistics TextureCache::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+
+  auto statistics        = m->statistics;
+  statistics.numTextures = m->textures.size();
+  statistics.numUniforms = m->uniforms.size();
+
+  return statistics;
+}
+
+void TextureCache::resetStatistics()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->statistics = Statistics();
+}
+
+void TextureCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m->mutex);
+  m->textures.clear();
+  m->uniforms.clear();
+}
+
+}
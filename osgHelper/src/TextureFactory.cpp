@@ -1,6 +1,8 @@
 #include <osgHelper/TextureFactory.h>
 #include <osgHelper/TextureBlueprint.h>
 
+#include <mutex>
+
 namespace osgHelper
 {
 
@@ -11,7 +13,32 @@ TextureFactory::TextureFactory(ioc::Injector& injector)
 
 osg::ref_ptr<ITextureBlueprint> TextureFactory::make() const
 {
-  return new TextureBlueprint();
+  std::shared_lock<std::shared_mutex> lock(m_optionsMutex);
+  return new TextureBlueprint(m_textureCache, m_textureProcessor);
+}
+
+void TextureFactory::setTextureCache(const osg::ref_ptr<TextureCache>& cache)
+{
+  std::unique_lock<std::shared_mutex> lock(m_optionsMutex);
+  m_textureCache = cache;
+}
+
+osg::ref_ptr<TextureCache> TextureFactory::getTextureCache() const
+{
+  std::shared_lock<std::shared_mutex> lock(m_optionsMutex);
+  return m_textureCache;
+}
+
+void TextureFactory::setTextureProcessor(const osg::ref_ptr<TextureProcessor>& processor)
+{
+  std::unique_lock<std::shared_mutex> lock(m_optionsMutex);
+  m_textureProcessor = processor;
+}
+
+osg::ref_ptr<TextureProcessor> TextureFactory::getTextureProcessor() const
+{
+  std::shared_lock<std::shared_mutex> lock(m_optionsMutex);
+  return m_textureProcessor;
 }
 
 }
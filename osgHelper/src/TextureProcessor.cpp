@@ -0,0 +1,940 @@
+#include <osgHelper/GameException.h>
+#include <osgHelper/TextureProcessor.h>
+#include <osgHelper/ThreadPool.h>
+
+#include "CacheUtils.h"
+
+#include <utilsLib/Utils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <osg/observer_ptr>
+
+namespace osgHelper
+{
+
+namespace
+{
+
+const char          Magic[4]      = { 'O', 'H', 'T', 'X' };
+const std::uint32_t Version       = 1;
+const char*         FileExtension = ".ohtex";
+
+const std::size_t MaxNumPixelHashes = 256;
+
+const int KaiserRadius = 3;
+const int KaiserTaps   = 2 * KaiserRadius;
+
+// written in native byte order, the cache is local to the machine that processed the images
+struct TextureEntryHeader
+{
+  char          magic[4];
+  std::uint32_t version;
+  std::int32_t  s;
+  std::int32_t  t;
+  std::uint32_t sourcePixelFormat; //!< with the size and the options, to detect hash collisions
+  std::uint32_t mipmapFilter;
+  std::uint32_t compression;
+  std::int32_t  internalFormat;
+  std::uint32_t pixelFormat;
+  std::uint32_t numMipmaps;        //!< followed by the mipmap offsets
+  std::uint64_t dataSize;          //!< followed by the data
+};
+
+static_assert(std::is_trivially_copyable<TextureEntryHeader>::value, "TextureEntryHeader is written with memcpy");
+
+// the pixel hash of an image, valid as long as the image exists and is not dirtied
+struct PixelHash
+{
+  osg::observer_ptr<const osg::Image> image;
+  unsigned int                        modifiedCount;
+  std::uint64_t                       hash;
+};
+
+struct TextureLevel
+{
+  int         width;
+  int         height;
+  std::size_t offset;
+};
+
+int getNumComponents(const osg::Image& image)
+{
+  if (image.getDataType() != GL_UNSIGNED_BYTE)
+  {
+    return 0;
+  }
+
+  switch (image.getPixelFormat())
+  {
+  case GL_RGBA:
+    return 4;
+  case GL_RGB:
+    return 3;
+  default:
+    return 0;
+  }
+}
+
+std::size_t getBlockSize(TextureProcessor::Compression compression)
+{
+  return (compression == TextureProcessor::Compression::BC1) ? 8 : 16;
+}
+
+std::size_t getLevelSize(int width, int height, int numComponents, TextureProcessor::Compression compression)
+{
+  if (compression == TextureProcessor::Compression::None)
+  {
+    return static_cast<std::size_t>(width) * height * numComponents;
+  }
+
+  return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(compression);
+}
+
+// the GL convention, each level halves the size of the previous one down to 1x1
+std::vector<TextureLevel> getLevels(int width, int height, bool mipmaps)
+{
+  std::vector<TextureLevel> levels;
+  levels.push_back({ width, height, 0 });
+
+  while (mipmaps && ((width > 1) || (height > 1)))
+  {
+    width  = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+    levels.push_back({ width, height, 0 });
+  }
+
+  return levels;
+}
+
+// the levels of a result with their offsets into the data, which is returned
+std::size_t layoutLevels(std::vector<TextureLevel>& levels, int numComponents,
+                         TextureProcessor::Compression compression)
+{
+  std::size_t dataSize = 0;
+  for (auto& level : levels)
+  {
+    level.offset = dataSize;
+    dataSize += getLevelSize(level.width, level.height, numComponents, compression);
+  }
+
+  return dataSize;
+}
+
+GLenum getCompressedFormat(TextureProcessor::Compression compression)
+{
+  return (compression == TextureProcessor::Compression::BC1) ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+                                                             : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
+
+double besselI0(double x)
+{
+  auto sum  = 1.0;
+  auto term = 1.0;
+  for (auto k = 1; k < 32; k++)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+
+  return sum;
+}
+
+// weights of the source pixels 2x-2 .. 2x+3 for the destination pixel x
+const std::vector<float>& getKaiserWeights()
+{
+  static const std::vector<float> weights = []()
+  {
+    const auto pi   = 3.14159265358979323846;
+    const auto beta = 4.0;
+
+    std::vector<float> result(KaiserTaps);
+
+    auto sum = 0.0;
+    for (auto k = 0; k < KaiserTaps; k++)
+    {
+      const auto distance = k - KaiserRadius + 0.5;
+      const auto x        = distance / 2.0;
+      const auto sinc     = std::sin(pi * x) / (pi * x);
+      const auto ratio    = distance / KaiserRadius;
+      const auto window   = besselI0(beta * std::sqrt(1.0 - ratio * ratio)) / besselI0(beta);
+
+      result[k] = static_cast<float>(sinc * window);
+      sum += result[k];
+    }
+
+    for (auto& weight : result)
+    {
+      weight = static_cast<float>(weight / sum);
+    }
+
+    return result;
+  }();
+
+  return weights;
+}
+
+unsigned char toByte(float value)
+{
+  return static_cast<unsigned char>(std::min(255.0f, std::max(0.0f, value + 0.5f)));
+}
+
+void downsampleBox(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth,
+                          int numComponents, int beginRow, int endRow)
+{
+  const auto srcRowSize = static_cast<std::size_t>(srcWidth) * numComponents;
+  const auto dstRowSize = static_cast<std::size_t>(dstWidth) * numComponents;
+
+  for (auto y = beginRow; y < endRow; y++)
+  {
+    const auto row0 = src + std::min(2 * y, srcHeight - 1) * srcRowSize;
+    const auto row1 = src + std::min(2 * y + 1, srcHeight - 1) * srcRowSize;
+    const auto out  = dst + y * dstRowSize;
+
+    for (auto x = 0; x < dstWidth; x++)
+    {
+      const auto x0 = std::min(2 * x, srcWidth - 1) * numComponents;
+      const auto x1 = std::min(2 * x + 1, srcWidth - 1) * numComponents;
+
+      for (auto c = 0; c < numComponents; c++)
+      {
+        out[x * numComponents + c] =
+          static_cast<unsigned char>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+      }
+    }
+  }
+}
+
+// separable, the rows needed by the band are filtered horizontally first
+void downsampleKaiser(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst,
+                             int dstWidth, int numComponents, int beginRow, int endRow)
+{
+  const auto& weights    = getKaiserWeights();
+  const auto  srcRowSize = static_cast<std::size_t>(srcWidth) * numComponents;
+  const auto  dstRowSize = static_cast<std::size_t>(dstWidth) * numComponents;
+  const auto  firstRow   = 2 * beginRow - KaiserRadius + 1;
+  const auto  numRows    = 2 * (endRow - beginRow) + KaiserTaps - 2;
+
+  std::vector<float> filtered(static_cast<std::size_t>(numRows) * dstRowSize);
+
+  for (auto row = 0; row < numRows; row++)
+  {
+    const auto srcRow = src + std::min(std::max(firstRow + row, 0), srcHeight - 1) * srcRowSize;
+    const auto out    = filtered.data() + row * dstRowSize;
+
+    for (auto x = 0; x < dstWidth; x++)
+    {
+      for (auto k = 0; k < KaiserTaps; k++)
+      {
+        const auto srcX = std::min(std::max(2 * x - KaiserRadius + 1 + k, 0), srcWidth - 1) * numComponents;
+        for (auto c = 0; c < numComponents; c++)
+        {
+          out[x * numComponents + c] += weights[k] * srcRow[srcX + c];
+        }
+      }
+    }
+  }
+
+  for (auto y = beginRow; y < endRow; y++)
+  {
+    const auto rows = filtered.data() + 2 * (y - beginRow) * dstRowSize;
+    const auto out  = dst + y * dstRowSize;
+
+    for (std::size_t i = 0; i < dstRowSize; i++)
+    {
+      auto value = 0.0f;
+      for (auto k = 0; k < KaiserTaps; k++)
+      {
+        value += weights[k] * rows[k * dstRowSize + i];
+      }
+
+      out[i] = toByte(value);
+    }
+  }
+}
+
+std::uint16_t toRgb565(const unsigned char* color)
+{
+  const auto r = (color[0] * 31 + 127) / 255;
+  const auto g = (color[1] * 63 + 127) / 255;
+  const auto b = (color[2] * 31 + 127) / 255;
+
+  return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void fromRgb565(std::uint16_t color, int* rgb)
+{
+  const auto r = (color >> 11) & 31;
+  const auto g = (color >> 5) & 63;
+  const auto b = color & 31;
+
+  rgb[0] = (r << 3) | (r >> 2);
+  rgb[1] = (g << 2) | (g >> 4);
+  rgb[2] = (b << 3) | (b >> 2);
+}
+
+// nearest entries of the four color palette, equal endpoints only use the first one
+// returns the squared error of the block
+int findColorIndices(const unsigned char* pixels, std::uint16_t color0, std::uint16_t color1,
+                            std::uint32_t& indices)
+{
+  int palette[4][3];
+  fromRgb565(color0, palette[0]);
+  fromRgb565(color1, palette[1]);
+  for (auto c = 0; c < 3; c++)
+  {
+    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+  }
+
+  indices    = 0;
+  auto error = 0;
+  for (auto i = 0; i < 16; i++)
+  {
+    auto bestIndex    = 0;
+    auto bestDistance = 0;
+    for (auto p = 0; p < ((color0 == color1) ? 1 : 4); p++)
+    {
+      auto distance = 0;
+      for (auto c = 0; c < 3; c++)
+      {
+        const auto delta = pixels[i * 4 + c] - palette[p][c];
+        distance += delta * delta;
+      }
+
+      if ((p == 0) || (distance < bestDistance))
+      {
+        bestIndex    = p;
+        bestDistance = distance;
+      }
+    }
+
+    indices |= static_cast<std::uint32_t>(bestIndex) << (2 * i);
+    error += bestDistance;
+  }
+
+  return error;
+}
+
+// the endpoints are the extreme pixels along the principal axis of the colors
+void encodeColorBlock(const unsigned char* pixels, unsigned char* out)
+{
+  float mean[3] = { 0.0f, 0.0f, 0.0f };
+  for (auto i = 0; i < 16; i++)
+  {
+    for (auto c = 0; c < 3; c++)
+    {
+      mean[c] += pixels[i * 4 + c] / 16.0f;
+    }
+  }
+
+  float covariance[3][3] = {};
+  for (auto i = 0; i < 16; i++)
+  {
+    for (auto row = 0; row < 3; row++)
+    {
+      for (auto column = 0; column < 3; column++)
+      {
+        covariance[row][column] += (pixels[i * 4 + row] - mean[row]) * (pixels[i * 4 + column] - mean[column]);
+      }
+    }
+  }
+
+  // power iteration, starting with the column of the channel with the largest variance, which is not
+  // orthogonal to the principal axis
+  auto maxChannel = 0;
+  for (auto c = 1; c < 3; c++)
+  {
+    if (covariance[c][c] > covariance[maxChannel][maxChannel])
+    {
+      maxChannel = c;
+    }
+  }
+
+  float axis[3] = { covariance[0][maxChannel], covariance[1][maxChannel], covariance[2][maxChannel] };
+  for (auto iteration = 0; iteration < 8; iteration++)
+  {
+    float next[3] = { 0.0f, 0.0f, 0.0f };
+    for (auto row = 0; row < 3; row++)
+    {
+      for (auto column = 0; column < 3; column++)
+      {
+        next[row] += covariance[row][column] * axis[column];
+      }
+    }
+
+    const auto length = std::max({ std::abs(next[0]), std::abs(next[1]), std::abs(next[2]) });
+    if (length < 1e-6f)
+    {
+      break;
+    }
+
+    for (auto c = 0; c < 3; c++)
+    {
+      axis[c] = next[c] / length;
+    }
+  }
+
+  auto minIndex      = 0;
+  auto maxIndex      = 0;
+  auto minProjection = 0.0f;
+  auto maxProjection = 0.0f;
+  for (auto i = 0; i < 16; i++)
+  {
+    const auto projection = pixels[i * 4] * axis[0] + pixels[i * 4 + 1] * axis[1] + pixels[i * 4 + 2] * axis[2];
+    if ((i == 0) || (projection < minProjection))
+    {
+      minIndex      = i;
+      minProjection = projection;
+    }
+
+    if ((i == 0) || (projection > maxProjection))
+    {
+      maxIndex      = i;
+      maxProjection = projection;
+    }
+  }
+
+  auto color0 = toRgb565(pixels + maxIndex * 4);
+  auto color1 = toRgb565(pixels + minIndex * 4);
+
+  std::uint32_t indices = 0;
+  auto          error   = findColorIndices(pixels, color0, color1, indices);
+
+  // one least squares fit of the endpoints to the palette entries the pixels were assigned to
+  if (color0 != color1)
+  {
+    static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+    auto  aa    = 0.0f;
+    auto  ab    = 0.0f;
+    auto  bb    = 0.0f;
+    float ax[3] = { 0.0f, 0.0f, 0.0f };
+    float bx[3] = { 0.0f, 0.0f, 0.0f };
+
+    for (auto i = 0; i < 16; i++)
+    {
+      const auto a = weights[(indices >> (2 * i)) & 3];
+      const auto b = 1.0f - a;
+
+      aa += a * a;
+      ab += a * b;
+      bb += b * b;
+      for (auto c = 0; c < 3; c++)
+      {
+        ax[c] += a * pixels[i * 4 + c];
+        bx[c] += b * pixels[i * 4 + c];
+      }
+    }
+
+    const auto determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) > 1e-6f)
+    {
+      unsigned char endpoint0[3];
+      unsigned char endpoint1[3];
+      for (auto c = 0; c < 3; c++)
+      {
+        endpoint0[c] = toByte((ax[c] * bb - bx[c] * ab) / determinant);
+        endpoint1[c] = toByte((bx[c] * aa - ax[c] * ab) / determinant);
+      }
+
+      const auto    refined0       = toRgb565(endpoint0);
+      const auto    refined1       = toRgb565(endpoint1);
+      std::uint32_t refinedIndices = 0;
+      const auto    refinedError   = findColorIndices(pixels, refined0, refined1, refinedIndices);
+
+      if (refinedError < error)
+      {
+        color0  = refined0;
+        color1  = refined1;
+        indices = refinedIndices;
+      }
+    }
+  }
+
+  // color0 > color1 selects the four color mode
+  if (color0 < color1)
+  {
+    std::swap(color0, color1);
+    indices ^= 0x55555555; // swaps 0 with 1 and 2 with 3
+  }
+
+  out[0] = static_cast<unsigned char>(color0 & 0xFF);
+  out[1] = static_cast<unsigned char>(color0 >> 8);
+  out[2] = static_cast<unsigned char>(color1 & 0xFF);
+  out[3] = static_cast<unsigned char>(color1 >> 8);
+  for (auto i = 0; i < 4; i++)
+  {
+    out[4 + i] = static_cast<unsigned char>((indices >> (8 * i)) & 0xFF);
+  }
+}
+
+// eight interpolated values between the extreme alphas
+void encodeAlphaBlock(const unsigned char* pixels, unsigned char* out)
+{
+  auto alpha0 = pixels[3];
+  auto alpha1 = pixels[3];
+  for (auto i = 1; i < 16; i++)
+  {
+    alpha0 = std::max(alpha0, pixels[i * 4 + 3]);
+    alpha1 = std::min(alpha1, pixels[i * 4 + 3]);
+  }
+
+  std::uint64_t indices = 0;
+  if (alpha0 != alpha1)
+  {
+    int palette[8] = { alpha0, alpha1 };
+    for (auto i = 1; i < 7; i++)
+    {
+      palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+    }
+
+    for (auto i = 0; i < 16; i++)
+    {
+      auto bestIndex    = 0;
+      auto bestDistance = 256;
+      for (auto p = 0; p < 8; p++)
+      {
+        const auto distance = std::abs(pixels[i * 4 + 3] - palette[p]);
+        if (distance < bestDistance)
+        {
+          bestIndex    = p;
+          bestDistance = distance;
+        }
+      }
+
+      indices |= static_cast<std::uint64_t>(bestIndex) << (3 * i);
+    }
+  }
+
+  out[0] = alpha0;
+  out[1] = alpha1;
+  for (auto i = 0; i < 6; i++)
+  {
+    out[2 + i] = static_cast<unsigned char>((indices >> (8 * i)) & 0xFF);
+  }
+}
+
+void compressBlocks(const unsigned char* src, int width, int height, int numComponents,
+                           TextureProcessor::Compression compression, unsigned char* dst, int beginBlockRow,
+                           int endBlockRow)
+{
+  const auto numBlocksX = (width + 3) / 4;
+  const auto blockSize  = getBlockSize(compression);
+  const auto rowSize    = static_cast<std::size_t>(width) * numComponents;
+
+  unsigned char pixels[16 * 4];
+
+  for (auto blockY = beginBlockRow; blockY < endBlockRow; blockY++)
+  {
+    for (auto blockX = 0; blockX < numBlocksX; blockX++)
+    {
+      // blocks at the right and top edge repeat the last pixels
+      for (auto y = 0; y < 4; y++)
+      {
+        const auto row = src + std::min(blockY * 4 + y, height - 1) * rowSize;
+        for (auto x = 0; x < 4; x++)
+        {
+          const auto pixel = row + std::min(blockX * 4 + x, width - 1) * numComponents;
+          const auto out   = pixels + (y * 4 + x) * 4;
+
+          std::memcpy(out, pixel, numComponents);
+          if (numComponents == 3)
+          {
+            out[3] = 255;
+          }
+        }
+      }
+
+      auto out = dst + (static_cast<std::size_t>(blockY) * numBlocksX + blockX) * blockSize;
+      if (compression == TextureProcessor::Compression::BC3)
+      {
+        encodeAlphaBlock(pixels, out);
+        out += 8;
+      }
+
+      encodeColorBlock(pixels, out);
+    }
+  }
+}
+
+}
+
+struct TextureProcessor::Impl
+{
+  explicit Impl(unsigned int numThreads)
+    : threadPool(numThreads)
+  {
+  }
+
+  std::string                     cacheDirectory;
+  ThreadPool                      threadPool;
+  std::atomic<unsigned long long> numProcessed{ 0 };
+  std::atomic<unsigned long long> numCacheHits{ 0 };
+
+  std::unordered_map<const osg::Image*, PixelHash> pixelHashes;
+  std::mutex                                       pixelHashesMutex;
+
+  // splits [0, numItems) into ranges of at least minItemsPerTask for the worker threads and waits for them
+  void parallelFor(int numItems, int minItemsPerTask, const std::function<void(int, int)>& func)
+  {
+    const auto numTasks = std::min(static_cast<int>(threadPool.getNumThreads()) * 4,
+                                   numItems / std::max(1, minItemsPerTask));
+
+    if (numTasks <= 1)
+    {
+      func(0, numItems);
+      return;
+    }
+
+    std::mutex              mutex;
+    std::condition_variable done;
+    auto                    numRemaining = numTasks;
+
+    for (auto i = 0; i < numTasks; i++)
+    {
+      const auto begin = numItems * i / numTasks;
+      const auto end   = numItems * (i + 1) / numTasks;
+
+      threadPool.enqueue([&, begin, end]()
+      {
+        func(begin, end);
+
+        // notified with the lock held, the waiting thread destroys the condition variable
+        std::lock_guard<std::mutex> lock(mutex);
+        numRemaining--;
+        done.notify_one();
+      });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&numRemaining]() { return numRemaining == 0; });
+  }
+
+  osg::ref_ptr<osg::Image> processImage(const osg::Image& image, int numComponents, const Options& options)
+  {
+    auto       levels      = getLevels(image.s(), image.t(), options.mipmapFilter != MipmapFilter::None);
+    const auto rowSize     = static_cast<std::size_t>(image.s()) * numComponents;
+    const auto compression = options.compression;
+
+    // uncompressed levels are generated in place of the result
+    std::vector<unsigned char> pixels(layoutLevels(levels, numComponents, Compression::None));
+    for (auto row = 0; row < image.t(); row++)
+    {
+      std::memcpy(pixels.data() + row * rowSize, image.data() + row * image.getRowStepInBytes(), rowSize);
+    }
+
+    for (std::size_t i = 1; i < levels.size(); i++)
+    {
+      const auto& src = levels[i - 1];
+      const auto& dst = levels[i];
+
+      parallelFor(dst.height, std::max(1, 16384 / dst.width), [&](int begin, int end)
+      {
+        const auto downsample = (options.mipmapFilter == MipmapFilter::Kaiser) ? downsampleKaiser : downsampleBox;
+        downsample(pixels.data() + src.offset, src.width, src.height, pixels.data() + dst.offset, dst.width,
+                   numComponents, begin, end);
+      });
+    }
+
+    numProcessed++;
+
+    if (compression == Compression::None)
+    {
+      return createImage(image.s(), image.t(), levels, pixels.data(), pixels.size(),
+                         image.getInternalTextureFormat() ? image.getInternalTextureFormat()
+                                                          : static_cast<GLint>(image.getPixelFormat()),
+                         image.getPixelFormat());
+    }
+
+    auto                       blockLevels = levels;
+    std::vector<unsigned char> blocks(layoutLevels(blockLevels, numComponents, compression));
+    for (std::size_t i = 0; i < levels.size(); i++)
+    {
+      const auto& level = levels[i];
+
+      parallelFor((level.height + 3) / 4, std::max(1, 1024 / level.width), [&](int begin, int end)
+      {
+        compressBlocks(pixels.data() + level.offset, level.width, level.height, numComponents, compression,
+                       blocks.data() + blockLevels[i].offset, begin, end);
+      });
+    }
+
+    const auto format = getCompressedFormat(compression);
+
+    return createImage(image.s(), image.t(), blockLevels, blocks.data(), blocks.size(), format, format);
+  }
+
+  static osg::ref_ptr<osg::Image> createImage(int width, int height, const std::vector<TextureLevel>& levels,
+                                              const unsigned char* data, std::size_t dataSize,
+                                              GLint internalFormat, GLenum pixelFormat)
+  {
+    const auto buffer = new unsigned char[dataSize];
+    std::memcpy(buffer, data, dataSize);
+
+    osg::Image::MipmapDataType mipmapOffsets;
+    for (std::size_t i = 1; i < levels.size(); i++)
+    {
+      mipmapOffsets.push_back(static_cast<unsigned int>(levels[i].offset));
+    }
+
+    osg::ref_ptr<osg::Image> image = new osg::Image();
+    image->setImage(width, height, 1, internalFormat, pixelFormat, GL_UNSIGNED_BYTE, buffer,
+                    osg::Image::USE_NEW_DELETE, 1);
+    image->setMipmapLevels(mipmapOffsets);
+
+    return image;
+  }
+
+  // FNV-1a of the pixels without row padding, only computed again if the image was dirtied
+  std::uint64_t getPixelHash(const osg::Image& image, int numComponents)
+  {
+    {
+      std::lock_guard<std::mutex> lock(pixelHashesMutex);
+
+      const auto it = pixelHashes.find(&image);
+      if ((it != pixelHashes.end()) && (it->second.image.get() == &image) &&
+          (it->second.modifiedCount == image.getModifiedCount()))
+      {
+        return it->second.hash;
+      }
+    }
+
+    Fnv1aHasher hasher;
+
+    const auto rowSize = static_cast<std::size_t>(image.s()) * numComponents;
+    for (auto row = 0; row < image.t(); row++)
+    {
+      hasher.addBytes(image.data() + row * image.getRowStepInBytes(), rowSize);
+    }
+
+    const auto hash = hasher.get();
+
+    std::lock_guard<std::mutex> lock(pixelHashesMutex);
+
+    // the hashes of deleted images are dropped before there are too many
+    if (pixelHashes.size() >= MaxNumPixelHashes)
+    {
+      for (auto it = pixelHashes.begin(); it != pixelHashes.end();)
+      {
+        it = it->second.image.valid() ? std::next(it) : pixelHashes.erase(it);
+      }
+
+      if (pixelHashes.size() >= MaxNumPixelHashes)
+      {
+        pixelHashes.clear();
+      }
+    }
+
+    pixelHashes[&image] = { &image, image.getModifiedCount(), hash };
+
+    return hash;
+  }
+
+  // FNV-1a of the options, the layout and the pixel hash
+  static std::string getEntryName(const osg::Image& image, std::uint64_t pixelHash, const Options& options)
+  {
+    const std::int32_t layout[5] = { image.s(), image.t(), static_cast<std::int32_t>(image.getPixelFormat()),
+                                     static_cast<std::int32_t>(options.mipmapFilter),
+                                     static_cast<std::int32_t>(options.compression) };
+
+    Fnv1aHasher hasher;
+    hasher.addBytes(layout, sizeof(layout));
+    hasher.addValue(pixelHash);
+
+    return getCacheEntryName(hasher.get(), FileExtension);
+  }
+
+  // the header is checked against the layout expected for the image, so that nothing is read past it
+  osg::ref_ptr<osg::Image> readEntry(const std::string& filename, const osg::Image& image, int numComponents,
+                                     const Options& options) const
+  {
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream.is_open())
+    {
+      return nullptr;
+    }
+
+    auto       levels   = getLevels(image.s(), image.t(), options.mipmapFilter != MipmapFilter::None);
+    const auto dataSize = layoutLevels(levels, numComponents, options.compression);
+
+    const auto internalFormat = (options.compression != Compression::None)
+                                  ? static_cast<GLint>(getCompressedFormat(options.compression))
+                                  : (image.getInternalTextureFormat() ? image.getInternalTextureFormat()
+                                                                      : static_cast<GLint>(image.getPixelFormat()));
+    const auto pixelFormat = (options.compression != Compression::None) ? getCompressedFormat(options.compression)
+                                                                        : image.getPixelFormat();
+
+    TextureEntryHeader header;
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) || (header.version != Version) ||
+        (header.s != image.s()) || (header.t != image.t()) || (header.sourcePixelFormat != image.getPixelFormat()) ||
+        (header.mipmapFilter != static_cast<std::uint32_t>(options.mipmapFilter)) ||
+        (header.compression != static_cast<std::uint32_t>(options.compression)) ||
+        (header.internalFormat != internalFormat) || (header.pixelFormat != pixelFormat) ||
+        (header.numMipmaps != levels.size() - 1) || (header.dataSize != dataSize))
+    {
+      return nullptr;
+    }
+
+    for (std::size_t i = 1; i < levels.size(); i++)
+    {
+      std::uint32_t offset;
+      if (!stream.read(reinterpret_cast<char*>(&offset), sizeof(offset)) || (offset != levels[i].offset))
+      {
+        return nullptr;
+      }
+    }
+
+    std::vector<unsigned char> data(dataSize);
+    if (!stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())))
+    {
+      return nullptr;
+    }
+
+    return createImage(header.s, header.t, levels, data.data(), data.size(), internalFormat, pixelFormat);
+  }
+
+  void writeEntry(const std::string& filename, const osg::Image& source, const Options& options,
+                  const osg::Image& image, std::size_t dataSize)
+  {
+    const auto& mipmapOffsets = image.getMipmapLevels();
+
+    TextureEntryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+
+    header.version           = Version;
+    header.s                 = image.s();
+    header.t                 = image.t();
+    header.sourcePixelFormat = source.getPixelFormat();
+    header.mipmapFilter      = static_cast<std::uint32_t>(options.mipmapFilter);
+    header.compression       = static_cast<std::uint32_t>(options.compression);
+    header.internalFormat    = image.getInternalTextureFormat();
+    header.pixelFormat       = image.getPixelFormat();
+    header.numMipmaps        = static_cast<std::uint32_t>(mipmapOffsets.size());
+    header.dataSize          = dataSize;
+
+    writeFileAtomically(filename, [&](std::ostream& stream)
+    {
+      stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      for (const auto offset : mipmapOffsets)
+      {
+        const auto value = static_cast<std::uint32_t>(offset);
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+      }
+
+      stream.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(dataSize));
+    });
+  }
+
+};
+
+TextureProcessor::TextureProcessor(const std::string& cacheDirectory, unsigned int numThreads)
+  : osg::Referenced()
+  , m(new Impl(numThreads))
+{
+  m->cacheDirectory = cacheDirectory;
+
+  if (!cacheDirectory.empty())
+  {
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    if (error)
+    {
+      throw GameException("Could not create directory '" + cacheDirectory + "'");
+    }
+  }
+}
+
+TextureProcessor::~TextureProcessor() = default;
+
+const std::string& TextureProcessor::getCacheDirectory() const
+{
+  return m->cacheDirectory;
+}
+
+osg::ref_ptr<osg::Image> TextureProcessor::process(const osg::Image& image, const Options& options)
+{
+  const auto numComponents = getNumComponents(image);
+  if ((numComponents == 0) || (image.s() <= 0) || (image.t() <= 0) || (image.r() != 1) || !image.data())
+  {
+    throw GameException("Image '" + image.getFileName() + "' must be a 2D image with RGB or RGBA bytes");
+  }
+
+  std::string entryFilename;
+  if (!m->cacheDirectory.empty())
+  {
+    const auto entryName = Impl::getEntryName(image, m->getPixelHash(image, numComponents), options);
+    entryFilename        = (std::filesystem::path(m->cacheDirectory) / entryName).string();
+
+    auto cached = m->readEntry(entryFilename, image, numComponents, options);
+    if (cached.valid())
+    {
+      m->numCacheHits++;
+      cached->setFileName(image.getFileName());
+      return cached;
+    }
+  }
+
+  auto result = m->processImage(image, numComponents, options);
+  result->setFileName(image.getFileName());
+
+  if (!entryFilename.empty())
+  {
+    auto       levels   = getLevels(image.s(), image.t(), options.mipmapFilter != MipmapFilter::None);
+    const auto dataSize = layoutLevels(levels, numComponents, options.compression);
+
+    // the result is still valid if it can not be cached
+    try
+    {
+      m->writeEntry(entryFilename, image, options, *result, dataSize);
+    }
+    catch (const GameException& e)
+    {
+      UTILS_LOG_WARN(std::string("Could not cache processed texture: ") + e.what());
+    }
+  }
+
+  return result;
+}
+
+TextureProcessor::Statistics TextureProcessor::getStatistics() const
+{
+  Statistics statistics;
+  statistics.numProcessed = m->numProcessed;
+  statistics.numCacheHits = m->numCacheHits;
+
+  return statistics;
+}
+
+void TextureProcessor::clearCache()
+{
+  if (m->cacheDirectory.empty())
+  {
+    return;
+  }
+
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(m->cacheDirectory, error))
+  {
+    if (entry.is_regular_file() && (entry.path().extension() == FileExtension))
+    {
+      std::filesystem::remove(entry.path(), error);
+    }
+  }
+}
+
+}
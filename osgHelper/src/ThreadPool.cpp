@@ -0,0 +1,127 @@
+#include <osgHelper/ThreadPool.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osgHelper
+{
+
+struct ThreadPool::Impl
+{
+  Impl()
+    : numQueuedTasks(0)
+    , numRunningTasks(0)
+    , isShuttingDown(false)
+  {}
+
+  void work()
+  {
+    while (true)
+    {
+      Task task;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        taskAvailable.wait(lock, [this]() { return isShuttingDown || (numQueuedTasks > 0); });
+
+        // queued tasks are still run on shutdown, otherwise their futures would never become ready
+        if (numQueuedTasks == 0)
+        {
+          return;
+        }
+
+        const auto queue = tasks.begin();
+        task = std::move(queue->second.front());
+        queue->second.pop_front();
+
+        if (queue->second.empty())
+        {
+          tasks.erase(queue);
+        }
+
+        numQueuedTasks--;
+        numRunningTasks++;
+      }
+
+      task();
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        numRunningTasks--;
+      }
+
+      idle.notify_all();
+    }
+  }
+
+  std::vector<std::thread> threads;
+
+  // queues by descending priority
+  std::map<int, std::deque<Task>, std::greater<int>> tasks;
+
+  std::mutex              mutex;
+  std::condition_variable taskAvailable;
+  std::condition_variable idle;
+
+  unsigned int numQueuedTasks;
+  unsigned int numRunningTasks;
+  bool         isShuttingDown;
+
+};
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+  : m(new Impl())
+{
+  if (numThreads == 0)
+  {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  for (auto i = 0U; i < numThreads; i++)
+  {
+    m->threads.emplace_back([this]() { m->work(); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m->mutex);
+    m->isShuttingDown = true;
+  }
+
+  m->taskAvailable.notify_all();
+
+  for (auto& thread : m->threads)
+  {
+    thread.join();
+  }
+}
+
+void ThreadPool::enqueue(const Task& task, int priority)
+{
+  {
+    std::lock_guard<std::mutex> lock(m->mutex);
+    m->tasks[priority].push_back(task);
+    m->numQueuedTasks++;
+  }
+
+  m->taskAvailable.notify_one();
+}
+
+void ThreadPool::waitForIdle()
+{
+  std::unique_lock<std::mutex> lock(m->mutex);
+  m->idle.wait(lock, [this]() { return (m->numQueuedTasks == 0) && (m->numRunningTasks == 0); });
+}
+
+unsigned int ThreadPool::getNumThreads() const
+{
+  return static_cast<unsigned int>(m->threads.size());
+}
+
+}
@@ -64,35 +64,23 @@ std::string getEffectNotSupportedMessage(const std::string& effectName)
   return "Post processing effect '" + effectName + "' is not supported";
 }
 
-osg::ref_ptr<osg::Texture2D> createCameraRenderTexture(const osg::ref_ptr<osgHelper::Camera>& camera,
+GLint getRenderTextureInternalFormat(osg::Camera::BufferComponent component)
+{
+  return (component == osg::Camera::BufferComponent::DEPTH_BUFFER) ? GL_DEPTH_COMPONENT : GL_RGBA16F_ARB;
+}
+
+osg::ref_ptr<osg::Texture2D> createCameraRenderTexture(const osg::ref_ptr<RenderTargetPool>& pool,
+                                                       const osg::ref_ptr<osgHelper::Camera>& camera,
                                                        const osg::Vec2i& resolution,
                                                        osg::Camera::BufferComponent component,
                                                        osg::Texture::FilterMode filterMode)
 {
-  auto texture = new osg::Texture2D();
-
-  texture->setDataVariance(osg::Texture::DataVariance::DYNAMIC);
-  texture->setTextureSize(resolution.x(), resolution.y());
-  texture->setFilter(osg::Texture2D::MIN_FILTER, filterMode);
-  texture->setFilter(osg::Texture2D::MAG_FILTER, filterMode);
-  texture->setResizeNonPowerOfTwoHint(false);
-  texture->setWrap(osg::Texture2D::WRAP_S, osg::Texture2D::CLAMP_TO_EDGE);
-  texture->setWrap(osg::Texture2D::WRAP_T, osg::Texture2D::CLAMP_TO_EDGE);
+  const auto texture = pool->acquire(resolution, getRenderTextureInternalFormat(component), filterMode);
 
-  switch (component)
+  if (component == osg::Camera::BufferComponent::COLOR_BUFFER)
   {
-  case osg::Camera::BufferComponent::COLOR_BUFFER:
-    texture->setInternalFormat(GL_RGBA16F_ARB);
     texture->setSourceFormat(GL_RGBA);
     texture->setSourceType(GL_FLOAT);
-    break;
-
-  case osg::Camera::BufferComponent::DEPTH_BUFFER:
-    texture->setInternalFormat(GL_DEPTH_COMPONENT);
-    break;
-
-  default:
-    break;
   }
 
   camera->attach(component, texture);
@@ -100,6 +88,38 @@ osg::ref_ptr<osg::Texture2D> createCameraRenderTexture(const osg::ref_ptr<osgHel
   return texture;
 }
 
+void releaseCameraRenderTexture(const osg::ref_ptr<RenderTargetPool>& pool,
+                                const osg::ref_ptr<osgHelper::Camera>& camera,
+                                osg::Camera::BufferComponent component,
+                                const osg::ref_ptr<osg::Texture2D>& texture)
+{
+  camera->detach(component);
+  pool->release(texture);
+}
+
+void releaseSlaveCameraRenderTextures(const osg::ref_ptr<RenderTargetPool>& pool, const View::RTTSlaveCameraData& data)
+{
+  for (const auto& texture : data.textures)
+  {
+    releaseCameraRenderTexture(pool, data.camera, getCameraBufferComponent(texture.first), texture.second);
+  }
+}
+
+// with a size granularity the render targets might be larger than requested, the cameras render across them
+bool isRenderTargetBucketed(const osg::ref_ptr<RenderTargetPool>& pool)
+{
+  return pool->getSizeGranularity() > 1;
+}
+
+void updateRenderTargetViewport(const osg::ref_ptr<RenderTargetPool>& pool, const View::RTTSlaveCameraData& data)
+{
+  if (isRenderTargetBucketed(pool) && !data.textures.empty())
+  {
+    const auto& texture = data.textures.begin()->second;
+    data.camera->setViewport(0, 0, texture->getTextureWidth(), texture->getTextureHeight());
+  }
+}
+
 void applyStateSetRenderTextures(const osg::ref_ptr<osg::StateSet>& stateSet, const View::SlaveRenderTextures& textures)
 {
   for (const auto& component : textures)
@@ -114,6 +134,7 @@ struct View::Impl
   Impl()
     : sceneGraph(new osg::Group())
     , cameras(utilsLib::underlying(CameraType::_Count))
+    , renderTargetPool(new RenderTargetPool())
     , isResolutionInitialized(false)
     , isPipelineDirty(false)
   {
@@ -148,6 +169,7 @@ struct View::Impl
 
   osg::ref_ptr<osg::Group> sceneGraph;
   std::vector<osg::ref_ptr<osgHelper::Camera>> cameras;
+  osg::ref_ptr<RenderTargetPool> renderTargetPool;
 
   struct SlaveCameraData
   {
@@ -215,7 +237,7 @@ struct View::Impl
   osg::ref_ptr<osg::Texture2D> createAndAttachRenderTexture(osg::Camera::BufferComponent bufferComponent)
   {
     const auto sceneCamera = cameras.at(utilsLib::underlying(CameraType::Scene));
-    return createCameraRenderTexture(sceneCamera, resolution, bufferComponent, osg::Texture::LINEAR);
+    return createCameraRenderTexture(renderTargetPool, sceneCamera, resolution, bufferComponent, osg::Texture::LINEAR);
   }
 
   RenderTexture getOrCreateRenderTexture(
@@ -229,7 +251,8 @@ struct View::Impl
 
       if (mode == UpdateMode::Recreate)
       {
-        cameras[utilsLib::underlying(CameraType::Scene)]->detach(bufferComponent);
+        releaseCameraRenderTexture(renderTargetPool, cameras[utilsLib::underlying(CameraType::Scene)],
+          bufferComponent, renderTexture.texture);
         renderTexture.texture = createAndAttachRenderTexture(bufferComponent);
       }
 
@@ -323,30 +346,41 @@ View::~View() = default;
 
 void View::updateResolution(const osg::Vec2i& resolution, float pixelRatio)
 {
-  const auto width  = resolution.x();
-  const auto height = resolution.y();
+  const auto initialResolutionUpdate = ((m->resolution.x() == 0) && (m->resolution.y() == 0));
 
-  updateCameraViewports(0, 0, width, height, pixelRatio);
+  // the render textures are recreated with the new resolution
+  m->resolution = resolution;
+
+  updateCameraViewports(0, 0, resolution.x(), resolution.y(), pixelRatio);
   updateCameraRenderTextures(UpdateMode::Recreate);
 
   if (m->processor.valid())
   {
-    osgPPU::Camera::resizeViewport(0, 0, width, height, getCamera(CameraType::Scene));
+    // bucketed cameras keep their viewports, which already have the size of their render targets
+    const auto isBucketed     = isRenderTargetBucketed(m->renderTargetPool);
+    const auto resizeViewport = [&resolution, isBucketed](const osg::ref_ptr<osgHelper::Camera>& camera)
+    {
+      const auto viewport = camera->getViewport();
+      const auto size     = isBucketed ? osg::Vec2i(static_cast<int>(viewport->width()),
+                                                    static_cast<int>(viewport->height()))
+                                       : resolution;
+
+      osgPPU::Camera::resizeViewport(0, 0, size.x(), size.y(), camera);
+    };
+
+    resizeViewport(getCamera(CameraType::Scene));
 
     for (const auto& data : m->rttSlaveCameraData)
     {
       if (data.camera->getRenderer() != nullptr)
       {
-        osgPPU::Camera::resizeViewport(0, 0, width, height, data.camera);
+        resizeViewport(data.camera);
       }
     }
 
     m->processor->onViewportChange();
   }
 
-  const auto initialResolutionUpdate = ((m->resolution.x() == 0) && (m->resolution.y() == 0));
-
-  m->resolution              = resolution;
   m->isResolutionInitialized = true;
 
   if (m->isPipelineDirty || initialResolutionUpdate)
@@ -374,6 +408,9 @@ void View::updateResolution(const osg::Vec2i& resolution, float pixelRatio)
       it = m->resizeCallbacks.erase(it);
     }
   }
+
+  // released render textures of previous resolutions are not acquired again once the resize settled
+  m->renderTargetPool->clearUnusedSizes();
 }
 
 void View::updateCameraViewports(int x, int y, int width, int height, float pixelRatio) const
@@ -384,9 +421,22 @@ void View::updateCameraViewports(int x, int y, int width, int height, float pixe
   const auto viewport = new osg::Viewport(x, y, scaledWidth, scaledHeight);
   const osg::Vec2i resolution(width, height);
 
+  // a bucketed scene camera renders across its whole render targets, the screen camera stretches them over the
+  // window
+  const auto isBucketed       = isRenderTargetBucketed(m->renderTargetPool);
+  const auto renderTargetSize = m->renderTargetPool->getBucketSize(resolution);
+
   for (const auto& camera : m->cameras)
   {
-    camera->setViewport(viewport);
+    if (isBucketed && (camera == getCamera(CameraType::Scene)))
+    {
+      camera->setViewport(0, 0, renderTargetSize.x(), renderTargetSize.y());
+    }
+    else
+    {
+      camera->setViewport(viewport);
+    }
+
     camera->updateResolution(resolution);
   }
 
@@ -402,10 +452,26 @@ void View::updateCameraViewports(int x, int y, int width, int height, float pixe
   for (const auto& data : m->rttSlaveCameraData)
   {
     data.camera->setViewport(viewport);
+    updateRenderTargetViewport(m->renderTargetPool, data);
     data.camera->updateResolution(resolution);
   }
 }
 
+void View::scaleRenderTargets(const osg::Vec2i& resolution, float pixelRatio)
+{
+  if (!m->isResolutionInitialized)
+  {
+    updateResolution(resolution, pixelRatio);
+    return;
+  }
+
+  // only the screen camera, which draws the final render target as a quad, renders at the new resolution
+  const auto scaledWidth  = static_cast<int>(pixelRatio * static_cast<float>(resolution.x()));
+  const auto scaledHeight = static_cast<int>(pixelRatio * static_cast<float>(resolution.y()));
+
+  getCamera(CameraType::Screen)->setViewport(new osg::Viewport(0, 0, scaledWidth, scaledHeight));
+}
+
 void View::setClampColorEnabled(bool enabled)
 {
   if (!m->clampColor.valid())
@@ -523,6 +589,11 @@ osg::Vec2i View::getResolution() const
   return m->resolution;
 }
 
+osg::ref_ptr<RenderTargetPool> View::getRenderTargetPool() const
+{
+  return m->renderTargetPool;
+}
+
 bool View::isResolutionInitialized() const
 {
   return m->isResolutionInitialized;
@@ -574,7 +645,7 @@ View::RTTSlaveCameraData View::createRenderToTextureSlaveCamera(
     if (utilsLib::bitmask_has(components, component))
     {
       data.textures[component] = createCameraRenderTexture(
-        data.camera, resolution, osgComponent, osg::Texture::NEAREST);
+        m->renderTargetPool, data.camera, resolution, osgComponent, osg::Texture::NEAREST);
     }
     else
     {
@@ -584,6 +655,7 @@ View::RTTSlaveCameraData View::createRenderToTextureSlaveCamera(
 
   addCameraRenderTextureComponentIfInMask(TextureComponent::ColorBuffer);
   addCameraRenderTextureComponentIfInMask(TextureComponent::DepthBuffer);
+  updateRenderTargetViewport(m->renderTargetPool, data);
 
   m->rttSlaveCameraData.emplace_back(data);
   return data;
@@ -595,6 +667,7 @@ void View::removeRenderToTextureSlaveCamera(const osg::ref_ptr<osgHelper::Camera
   {
     if (it->camera == camera)
     {
+      releaseSlaveCameraRenderTextures(m->renderTargetPool, *it);
       m->rttSlaveCameraData.erase(it);
       removeSlaveCamera(camera);
       return;
@@ -658,6 +731,7 @@ void View::removeRenderToTextureSlaveCameraToUnitSink(const osg::ref_ptr<osgHelp
         m->processor->removeChild(it->unitCamera);
       }
 
+      releaseSlaveCameraRenderTextures(m->renderTargetPool, it->screenBoundData.rttData);
       m->renderTextureUnitSinks.erase(it);
       removeSlaveCamera(camera);
       return;
@@ -702,6 +776,7 @@ void View::removeRenderToTextureSlaveCameraToScreenQuad(const osg::ref_ptr<osgHe
   {
     if (it->screenBoundData.rttData.camera == camera)
     {
+      releaseSlaveCameraRenderTextures(m->renderTargetPool, it->screenBoundData.rttData);
       m->rttScreenQuadData.erase(it);
       removeSlaveCamera(camera);
       return;
@@ -720,7 +795,9 @@ void View::initializePipelineProcessor()
 
   m->sceneGraph->addChild(m->processor);
 
-  osgPPU::Camera::resizeViewport(0, 0, m->resolution.x(), m->resolution.y(), sceneCamera);
+  const auto size = isRenderTargetBucketed(m->renderTargetPool) ? m->renderTargetPool->getBucketSize(m->resolution)
+                                                                 : m->resolution;
+  osgPPU::Camera::resizeViewport(0, 0, size.x(), size.y(), sceneCamera);
   m->processor->onViewportChange();
 }
 
@@ -872,11 +949,22 @@ void View::updateCameraRenderTextures(UpdateMode mode)
       for (auto& texture : data.rttData.textures)
       {
         const auto component = getCameraBufferComponent(texture.first);
-        camera->detach(component);
+        releaseCameraRenderTexture(m->renderTargetPool, camera, component, texture.second);
 
-        texture.second = createCameraRenderTexture(
+        texture.second = createCameraRenderTexture(m->renderTargetPool,
           camera, scaledVec2i(m->resolution, data.textureScale), component, osg::Texture::NEAREST);
       }
+
+      updateRenderTargetViewport(m->renderTargetPool, data.rttData);
+
+      // the released textures are only recycled once no copy of the camera data references them anymore
+      for (auto& rttData : m->rttSlaveCameraData)
+      {
+        if (rttData.camera == camera)
+        {
+          rttData.textures = data.rttData.textures;
+        }
+      }
     };
 
     for (auto& data : m->renderTextureUnitSinks)
@@ -107,6 +107,7 @@ namespace osgHelper::ppu
     m->shaderBlend = new osgPPU::ShaderAttribute();
     m->shaderBlend->addShader(shaderVert);
     m->shaderBlend->addShader(shaderFrag);
+    m->shaderFactory->prepareProgram(m->shaderBlend);
 
     //updateResolutionUniforms();
 
@@ -216,6 +216,7 @@ namespace ppu
     {
       m->shaderGaussX->addShader(shaderGaussConvolutionVp);
       m->shaderGaussX->addShader(shaderGaussConvolution1dxFp);
+      m->shaderFactory->prepareProgram(m->shaderGaussX);
 
       m->shaderGaussX->add("sigma", osg::Uniform::FLOAT);
       m->shaderGaussX->add("radius", osg::Uniform::FLOAT);
@@ -227,6 +228,7 @@ namespace ppu
 
       m->shaderGaussY->addShader(shaderGaussConvolutionVp);
       m->shaderGaussY->addShader(shaderGaussConvolution1dyFp);
+      m->shaderFactory->prepareProgram(m->shaderGaussY);
 
       m->shaderGaussY->add("sigma", osg::Uniform::FLOAT);
       m->shaderGaussY->add("radius", osg::Uniform::FLOAT);
@@ -266,6 +268,7 @@ namespace ppu
     {
       m->shaderDof = new osgPPU::ShaderAttribute();
       m->shaderDof->addShader(shaderDepthOfFieldFp);
+      m->shaderFactory->prepareProgram(m->shaderDof);
 
       m->shaderDof->add("focalLength", osg::Uniform::FLOAT);
       m->shaderDof->add("focalRange", osg::Uniform::FLOAT);
@@ -87,6 +87,7 @@ Effect::Status FXAA::initializeUnits(const osg::GL2Extensions* extensions)
     m->shaderFxaa = new osgPPU::ShaderAttribute();
     m->shaderFxaa->addShader(shaderFxaaFp);
     m->shaderFxaa->addShader(shaderFxaaVp);
+    m->shaderFactory->prepareProgram(m->shaderFxaa);
 
     m->shaderFxaa->add("rt_w", osg::Uniform::FLOAT);
     m->shaderFxaa->add("rt_h", osg::Uniform::FLOAT);
@@ -271,6 +271,7 @@ Effect::Status HDR::initializeUnits(const osg::GL2Extensions* extensions)
     lumShader->set("texUnit0", 0);
 
     pixelLuminance->getOrCreateStateSet()->setAttributeAndModes(lumShader);
+    m->shaderFactory->prepareProgram(lumShader);
   }
   m->unitResample->addChild(pixelLuminance);
 
@@ -283,6 +284,7 @@ Effect::Status HDR::initializeUnits(const osg::GL2Extensions* extensions)
     lumShaderMipmap->set("texUnit0", 0);
 
     sceneLuminance->getOrCreateStateSet()->setAttributeAndModes(lumShaderMipmap);
+    m->shaderFactory->prepareProgram(lumShaderMipmap);
     sceneLuminance->setGenerateMipmapForInputTexture(0);
   }
   pixelLuminance->addChild(sceneLuminance);
@@ -291,6 +293,7 @@ Effect::Status HDR::initializeUnits(const osg::GL2Extensions* extensions)
   {
     m->shaderBrightpass = new osgPPU::ShaderAttribute();
     m->shaderBrightpass->addShader(shaderBrightpassFp);
+    m->shaderFactory->prepareProgram(m->shaderBrightpass);
 
     m->shaderBrightpass->add("g_fMiddleGray", osg::Uniform::FLOAT);
     m->shaderBrightpass->set("g_fMiddleGray", m->midGrey);
@@ -306,6 +309,7 @@ Effect::Status HDR::initializeUnits(const osg::GL2Extensions* extensions)
     m->shaderGaussX = new osgPPU::ShaderAttribute();
     m->shaderGaussX->addShader(shaderGaussConvolutionVp);
     m->shaderGaussX->addShader(shaderGaussConvolution1dxFp);
+    m->shaderFactory->prepareProgram(m->shaderGaussX);
     m->shaderGaussX->add("sigma", osg::Uniform::FLOAT);
     m->shaderGaussX->add("radius", osg::Uniform::FLOAT);
     m->shaderGaussX->add("texUnit0", osg::Uniform::SAMPLER_2D);
@@ -319,6 +323,7 @@ Effect::Status HDR::initializeUnits(const osg::GL2Extensions* extensions)
     m->shaderGaussY = new osgPPU::ShaderAttribute();
     m->shaderGaussY->addShader(shaderGaussConvolutionVp);
     m->shaderGaussY->addShader(shaderGaussConvolution1dyFp);
+    m->shaderFactory->prepareProgram(m->shaderGaussY);
     m->shaderGaussY->add("sigma", osg::Uniform::FLOAT);
     m->shaderGaussY->add("radius", osg::Uniform::FLOAT);
     m->shaderGaussY->add("texUnit0", osg::Uniform::SAMPLER_2D);
@@ -337,6 +342,7 @@ Effect::Status HDR::initializeUnits(const osg::GL2Extensions* extensions)
   {
     m->shaderHdr = new osgPPU::ShaderAttribute();
     m->shaderHdr->addShader(shaderTonemapHdrFp);
+    m->shaderFactory->prepareProgram(m->shaderHdr);
 
     m->shaderHdr->add("fBlurFactor", osg::Uniform::FLOAT);
     m->shaderHdr->add("g_fMiddleGray", osg::Uniform::FLOAT);
@@ -355,6 +361,7 @@ Effect::Status HDR::initializeUnits(const osg::GL2Extensions* extensions)
   {
     m->shaderAdapted = new osgPPU::ShaderAttribute();
     m->shaderAdapted->addShader(shaderLuminanceAdaptedFp);
+    m->shaderFactory->prepareProgram(m->shaderAdapted);
     m->shaderAdapted->add("texLuminance", osg::Uniform::SAMPLER_2D);
     m->shaderAdapted->set("texLuminance", 0);
     m->shaderAdapted->add("texAdaptedLuminance", osg::Uniform::SAMPLER_2D);
@@ -372,5 +372,22 @@ const std::string Shaders::ShaderTonemapHdrFp =
 	"	gl_FragColor.a = 1.0;" \
 	"}";
 
+std::vector<Shaders::Entry> Shaders::getAll()
+{
+	return {
+		{ "ShaderBrightpassFp",          &ShaderBrightpassFp,          osg::Shader::FRAGMENT },
+		{ "ShaderDepthOfFieldFp",        &ShaderDepthOfFieldFp,        osg::Shader::FRAGMENT },
+		{ "ShaderFxaaFp",                &ShaderFxaaFp,                osg::Shader::FRAGMENT },
+		{ "ShaderFxaaVp",                &ShaderFxaaVp,                osg::Shader::VERTEX },
+		{ "ShaderGaussConvolution1dxFp", &ShaderGaussConvolution1dxFp, osg::Shader::FRAGMENT },
+		{ "ShaderGaussConvolution1dyFp", &ShaderGaussConvolution1dyFp, osg::Shader::FRAGMENT },
+		{ "ShaderGaussConvolutionVp",    &ShaderGaussConvolutionVp,    osg::Shader::VERTEX },
+		{ "ShaderLuminanceAdaptedFp",    &ShaderLuminanceAdaptedFp,    osg::Shader::FRAGMENT },
+		{ "ShaderLuminanceFp",           &ShaderLuminanceFp,           osg::Shader::FRAGMENT },
+		{ "ShaderLuminanceMipmapFp",     &ShaderLuminanceMipmapFp,     osg::Shader::FRAGMENT },
+		{ "ShaderTonemapHdrFp",          &ShaderTonemapHdrFp,          osg::Shader::FRAGMENT }
+	};
+}
+
 }
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include <osgHelper/PackArchiveWriter.h>
+#include <osgHelper/GameException.h>
+
+#include <iostream>
+#include <string>
+
+static void printUsage()
+{
+  std::cerr << "Usage: osgHelperPack <output.pack> <directory> [--prefix <key prefix>] [--compress]" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 3)
+  {
+    printUsage();
+    return 1;
+  }
+
+  std::string keyPrefix;
+  auto        compress = false;
+
+  for (auto i = 3; i < argc; i++)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "--prefix" && i + 1 < argc)
+    {
+      keyPrefix = argv[++i];
+    }
+    else if (arg == "--compress")
+    {
+      compress = true;
+    }
+    else
+    {
+      printUsage();
+      return 1;
+    }
+  }
+
+  try
+  {
+    osgHelper::PackArchiveWriter writer;
+    writer.setCompressionEnabled(compress);
+    writer.addDirectory(argv[2], keyPrefix);
+    writer.write(argv[1]);
+
+    std::cout << "Packed " << writer.getNumEntries() << " resources into '" << argv[1] << "'" << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
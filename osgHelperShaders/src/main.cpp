@@ -0,0 +1,347 @@
+#include <osgHelper/FileResourceLoader.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/LayeredResourceLoader.h>
+#include <osgHelper/ResourceManager.h>
+#include <osgHelper/ShaderFactory.h>
+#include <osgHelper/ShaderMinifier.h>
+#include <osgHelper/ShaderPreprocessor.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+#include <osgHelper/ppu/Shaders.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ShaderSource
+{
+  std::string       name;
+  std::string       source;
+  osg::Shader::Type type;
+};
+
+static void printUsage()
+{
+  std::cerr << "Usage: osgHelperShaders <output directory> [--directory <shader directory>]... "
+               "[--glslang <glslangValidator>] [--no-glslang]\n"
+               "Load the written shaders at runtime with ShaderFactory::setShaderDirectory(<output directory>)"
+            << std::endl;
+}
+
+static bool getStageType(const std::string& extension, osg::Shader::Type& type)
+{
+  for (const auto candidate : { osg::Shader::VERTEX, osg::Shader::TESSCONTROL, osg::Shader::TESSEVALUATION,
+                                osg::Shader::GEOMETRY, osg::Shader::FRAGMENT, osg::Shader::COMPUTE })
+  {
+    if (extension == osgHelper::ShaderFactory::getShaderFilename("", candidate))
+    {
+      type = candidate;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static std::string findGlslang()
+{
+#ifdef _WIN32
+  const auto separator = ';';
+  const auto filename  = "glslangValidator.exe";
+#else
+  const auto separator = ':';
+  const auto filename  = "glslangValidator";
+#endif
+
+  const auto path = std::getenv("PATH");
+  if (!path)
+  {
+    return "";
+  }
+
+  std::stringstream stream(path);
+  std::string       directory;
+  while (std::getline(stream, directory, separator))
+  {
+    std::error_code error;
+    const auto      candidate = std::filesystem::path(directory) / filename;
+    if (!directory.empty() && std::filesystem::is_regular_file(candidate, error))
+    {
+      return candidate.string();
+    }
+  }
+
+  return "";
+}
+
+static std::string readFile(const std::filesystem::path& filename)
+{
+  std::ifstream     stream(filename, std::ios::binary);
+  std::stringstream text;
+  text << stream.rdbuf();
+
+  return text.str();
+}
+
+static void writeFile(const std::filesystem::path& filename, const std::string& text)
+{
+  std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+  stream << text;
+
+  if (!stream.good())
+  {
+    throw osgHelper::GameException("Could not write file '" + filename.string() + "'");
+  }
+}
+
+// problems the GL compiler would report as well, found without a compiler
+static std::vector<std::string> checkStructure(const std::string& minified)
+{
+  std::vector<std::string> errors;
+  std::string              brackets;
+
+  std::istringstream stream(minified);
+  std::string        line;
+  while (std::getline(stream, line))
+  {
+    if (!line.empty() && (line[0] == '#'))
+    {
+      continue;
+    }
+
+    for (const auto c : line)
+    {
+      if ((c == '(') || (c == '[') || (c == '{'))
+      {
+        brackets += c;
+      }
+      else if ((c == ')') || (c == ']') || (c == '}'))
+      {
+        const auto opening = (c == ')') ? '(' : (c == ']') ? '[' : '{';
+        if (brackets.empty() || (brackets.back() != opening))
+        {
+          errors.push_back(std::string("Unexpected '") + c + "'");
+          return errors;
+        }
+
+        brackets.pop_back();
+      }
+    }
+  }
+
+  if (!brackets.empty())
+  {
+    errors.push_back(std::string("Unclosed '") + brackets.back() + "'");
+  }
+
+  if (minified.find("void main(") == std::string::npos)
+  {
+    errors.push_back("No main function");
+  }
+
+  return errors;
+}
+
+// the version of a #version directive, 110 if there is none, as for the GL compiler
+static int getVersion(const std::string& source)
+{
+  std::istringstream stream(source);
+  std::string        line;
+  while (std::getline(stream, line))
+  {
+    std::istringstream words(line);
+    std::string        directive;
+    int                version;
+
+    if ((words >> directive) && (directive == "#version") && (words >> version))
+    {
+      return version;
+    }
+  }
+
+  return 110;
+}
+
+static bool runGlslang(const std::string& glslang, const std::filesystem::path& filename, std::string& log)
+{
+  // -d validates shaders without a #version directive as desktop GLSL 110 instead of GLSL ES 100
+  const auto logFilename = filename.string() + ".log";
+  const auto command     = "\"" + glslang + "\" -d \"" + filename.string() + "\" > \"" + logFilename + "\" 2>&1";
+
+  const auto result = std::system(command.c_str());
+  log               = readFile(logFilename);
+
+  std::error_code error;
+  std::filesystem::remove(logFilename, error);
+
+  return result == 0;
+}
+
+static std::vector<ShaderSource> collectShaders(const std::vector<std::string>& directories)
+{
+  std::vector<ShaderSource> shaders;
+  for (const auto& shader : osgHelper::ppu::Shaders::getAll())
+  {
+    shaders.push_back({ shader.name, *shader.source, shader.type });
+  }
+
+  if (directories.empty())
+  {
+    return shaders;
+  }
+
+  // includes are resolved relative to the shader directories, .glsl files are only included
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector           injector(container);
+
+  osg::ref_ptr<osgHelper::LayeredResourceLoader> loader = new osgHelper::LayeredResourceLoader();
+  for (const auto& directory : directories)
+  {
+    loader->addLayer(new osgHelper::FileResourceLoader(), (std::filesystem::path(directory) / "").string());
+  }
+
+  osg::ref_ptr<osgHelper::ResourceManager> resourceManager = new osgHelper::ResourceManager(injector);
+  resourceManager->setResourceLoader(loader);
+
+  osg::ref_ptr<osgHelper::ShaderPreprocessor> preprocessor = new osgHelper::ShaderPreprocessor(resourceManager);
+
+  for (const auto& directory : directories)
+  {
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory))
+    {
+      osg::Shader::Type type;
+      if (!entry.is_regular_file() || !getStageType(entry.path().extension().string(), type))
+      {
+        continue;
+      }
+
+      const auto name   = std::filesystem::relative(entry.path(), directory).replace_extension().generic_string();
+      const auto source = readFile(entry.path());
+      shaders.push_back({ name, preprocessor->process(source, {}, getVersion(source)), type });
+    }
+  }
+
+  return shaders;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    printUsage();
+    return 1;
+  }
+
+  const std::filesystem::path outputDirectory(argv[1]);
+  std::vector<std::string>    directories;
+  auto                        glslang = findGlslang();
+
+  for (auto i = 2; i < argc; i++)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "--directory" && i + 1 < argc)
+    {
+      directories.push_back(argv[++i]);
+    }
+    else if (arg == "--glslang" && i + 1 < argc)
+    {
+      glslang = argv[++i];
+    }
+    else if (arg == "--no-glslang")
+    {
+      glslang.clear();
+    }
+    else
+    {
+      printUsage();
+      return 1;
+    }
+  }
+
+  try
+  {
+    const auto shaders             = collectShaders(directories);
+    const auto validationDirectory = outputDirectory / ".validation";
+
+    std::filesystem::create_directories(validationDirectory);
+
+    if (glslang.empty())
+    {
+      std::cerr << "Warning: glslangValidator not found, full validation is disabled and only the structure of "
+                   "the shaders is checked"
+                << std::endl;
+    }
+
+    auto        numErrors        = 0;
+    std::size_t numSourceBytes   = 0;
+    std::size_t numMinifiedBytes = 0;
+
+    for (const auto& shader : shaders)
+    {
+      const auto filename =
+        std::filesystem::path(osgHelper::ShaderFactory::getShaderFilename(shader.name, shader.type));
+      const auto minified = osgHelper::ShaderMinifier::minify(shader.source);
+
+      std::vector<std::string> errors = checkStructure(minified);
+
+      if (errors.empty() && !glslang.empty())
+      {
+        // the minified source is checked as well, in case minifying changed its meaning
+        for (const auto& variant : { std::make_pair("source", &shader.source), std::make_pair("minified", &minified) })
+        {
+          const auto validationFilename = validationDirectory / filename.filename();
+          writeFile(validationFilename, *variant.second);
+
+          std::string log;
+          if (!runGlslang(glslang, validationFilename, log))
+          {
+            errors.push_back(std::string("glslang failed for the ") + variant.first + ":\n" + log);
+            break;
+          }
+        }
+      }
+
+      if (!errors.empty())
+      {
+        for (const auto& error : errors)
+        {
+          std::cerr << shader.name << ": " << error << std::endl;
+        }
+
+        numErrors++;
+        continue;
+      }
+
+      const auto outputFilename = outputDirectory / filename;
+      std::filesystem::create_directories(outputFilename.parent_path());
+      // ShaderFactory ignores the file once the source it was made from changes
+      writeFile(outputFilename, osgHelper::ShaderFactory::getSourceStamp(shader.source) + minified);
+
+      numSourceBytes += shader.source.size();
+      numMinifiedBytes += minified.size();
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(validationDirectory, error);
+
+    if (numErrors > 0)
+    {
+      std::cerr << numErrors << " of " << shaders.size() << " shaders are invalid" << std::endl;
+      return 1;
+    }
+
+    std::cout << "Validated " << shaders.size() << " shaders, minified " << numSourceBytes << " bytes to "
+              << numMinifiedBytes << " bytes into '" << outputDirectory.string() << "'" << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/BinaryResource.h>
+#include <osgHelper/ByteStream.h>
+
+#include <osg/Array>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+std::vector<char> createData()
+{
+  std::vector<char> data(14);
+
+  const std::int32_t  i = -42;
+  const float         f = 1.5f;
+  const std::uint16_t s = 3;
+
+  std::memcpy(&data[0], &i, 4);
+  std::memcpy(&data[4], &f, 4);
+  std::memcpy(&data[8], &s, 2);
+  std::memcpy(&data[10], "abcd", 4);
+
+  return data;
+}
+
+}
+
+TEST(ByteStreamTest, ReadsValuesAndStringViews)
+{
+  const auto data = createData();
+
+  osgHelper::ByteStream stream(data.data(), data.size());
+  EXPECT_EQ(stream.getSize(), data.size());
+
+  EXPECT_EQ(stream.read<std::int32_t>(), -42);
+  EXPECT_EQ(stream.read<float>(), 1.5f);
+
+  const auto length = stream.read<std::uint16_t>();
+  const auto view   = stream.readStringView(length);
+  EXPECT_EQ(view, "abc");
+  EXPECT_EQ(view.data(), &data[10]);
+
+  EXPECT_EQ(stream.getRemaining(), 1U);
+  EXPECT_FALSE(stream.isEnd());
+
+  stream.skip(1);
+  EXPECT_TRUE(stream.isEnd());
+  EXPECT_EQ(stream.getPos(), 14);
+}
+
+TEST(ByteStreamTest, ReadsFromBinaryResource)
+{
+  const auto data = createData();
+
+  auto bytes = new char[data.size()];
+  std::memcpy(bytes, data.data(), data.size());
+
+  osg::ref_ptr<osgHelper::BinaryResource> resource = new osgHelper::BinaryResource();
+  resource->setBytes(bytes, data.size());
+
+  osgHelper::ByteStream stream(*resource);
+  EXPECT_EQ(stream.getSize(), data.size());
+  EXPECT_EQ(stream.read<std::int32_t>(), -42);
+
+  stream.skip(6);
+
+  const auto s = stream.readString(4);
+  EXPECT_STREQ(s, "abcd");
+  delete[] s;
+}
+
+#ifndef NDEBUG
+TEST(ByteStreamTest, ThrowsWhenReadingPastTheEnd)
+{
+  const auto data = createData();
+
+  osgHelper::ByteStream stream(data.data(), data.size());
+  stream.skip(12);
+
+  EXPECT_THROW(stream.read<std::int32_t>(), std::exception);
+  EXPECT_THROW(stream.readStringView(3), std::exception);
+  EXPECT_THROW(stream.skip(3), std::exception);
+
+  EXPECT_EQ(stream.getPos(), 12);
+  EXPECT_EQ(stream.read<char>(), 'c');
+}
+#endif
+
+TEST(ByteStreamTest, BulkReads)
+{
+  std::vector<float> values(3 * 100);
+  for (auto i = 0U; i < values.size(); i++)
+  {
+    values[i] = static_cast<float>(i) * 0.5f;
+  }
+
+  const auto data = reinterpret_cast<const char*>(values.data());
+  const auto size = values.size() * sizeof(float);
+
+  osgHelper::ByteStream stream(data, size);
+
+  osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array();
+  stream.readInto(*vertices, 90);
+
+  ASSERT_EQ(vertices->size(), 90U);
+  EXPECT_EQ((*vertices)[10].x(), values[30]);
+  EXPECT_EQ((*vertices)[89][2], values[269]);
+
+  std::vector<float> rest;
+  stream.readInto(rest, 30);
+  EXPECT_EQ(rest.back(), values.back());
+  EXPECT_TRUE(stream.isEnd());
+
+#ifndef NDEBUG
+  osgHelper::ByteStream shortStream(data, size);
+  EXPECT_THROW(shortStream.readInto(*vertices, 101), std::exception);
+#endif
+}
+
+TEST(ByteStreamTest, SwappedReads)
+{
+  const char data[] = { 0x01, 0x02, 0x03, 0x04, 0x3f, static_cast<char>(0x80), 0x00, 0x00, 0x0a, 0x0b };
+
+  osgHelper::ByteStream stream(data, sizeof(data));
+  EXPECT_EQ(stream.readSwapped<std::uint32_t>(), 0x01020304U);
+  EXPECT_EQ(stream.readSwapped<float>(), 1.0f);
+
+  std::vector<std::uint16_t> shorts;
+  stream.readIntoSwapped(shorts, 1);
+  EXPECT_EQ(shorts[0], 0x0a0bU);
+
+  std::vector<float> bigEndian(3 * 64);
+  for (auto i = 0U; i < bigEndian.size(); i++)
+  {
+    bigEndian[i] = static_cast<float>(i);
+    osgHelper::ByteStream::swapBytes(&bigEndian[i], 1, sizeof(float));
+  }
+
+  osgHelper::ByteStream vecStream(reinterpret_cast<const char*>(bigEndian.data()), bigEndian.size() * sizeof(float));
+
+  osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array();
+  vecStream.readIntoSwapped(*vertices, 64);
+
+  EXPECT_EQ((*vertices)[0].x(), 0.0f);
+  EXPECT_EQ((*vertices)[7][1], 22.0f);
+  EXPECT_EQ((*vertices)[63][2], 191.0f);
+}
+
+TEST(ByteStreamTest, VariableLengthIntegers)
+{
+  const unsigned char data[] = {
+    0x00,                                                       // 0
+    0x7f,                                                       // 127
+    0xac, 0x02,                                                 // 300
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01, // uint64 max
+    0x01,                                                       // zigzag -1
+    0x04,                                                       // zigzag 2
+    0xd7, 0x04                                                  // zigzag -300
+  };
+
+  osgHelper::ByteStream stream(reinterpret_cast<const char*>(data), sizeof(data));
+  EXPECT_EQ(stream.readVarUInt(), 0U);
+  EXPECT_EQ(stream.readVarUInt(), 127U);
+  EXPECT_EQ(stream.readVarUInt(), 300U);
+  EXPECT_EQ(stream.readVarUInt(), std::numeric_limits<std::uint64_t>::max());
+  EXPECT_EQ(stream.readVarInt(), -1);
+  EXPECT_EQ(stream.readVarInt(), 2);
+  EXPECT_EQ(stream.readVarInt(), -300);
+  EXPECT_TRUE(stream.isEnd());
+
+  const std::vector<char> overlong(11, static_cast<char>(0x80));
+  osgHelper::ByteStream overlongStream(overlong.data(), overlong.size());
+  EXPECT_THROW(overlongStream.readVarUInt(), std::exception);
+
+  // more than 64 bits
+  const unsigned char overflow[] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x02 };
+  osgHelper::ByteStream overflowStream(reinterpret_cast<const char*>(overflow), sizeof(overflow));
+  EXPECT_THROW(overflowStream.readVarUInt(), std::exception);
+}
+
+TEST(ByteStreamTest, BulkReadsMatchPerElementReads)
+{
+  const auto numVertices = 4096U;
+
+  std::vector<char> data(numVertices * sizeof(osg::Vec3f));
+  for (auto i = 0U; i < data.size(); i++)
+  {
+    data[i] = static_cast<char>(i % 127);
+  }
+
+  osg::ref_ptr<osg::Vec3Array> perElement = new osg::Vec3Array(numVertices);
+  osg::ref_ptr<osg::Vec3Array> swapped    = new osg::Vec3Array(numVertices);
+
+  osgHelper::ByteStream perElementStream(data.data(), data.size());
+  osgHelper::ByteStream swappedStream(data.data(), data.size());
+  for (auto i = 0U; i < numVertices; i++)
+  {
+    for (auto c = 0; c < 3; c++)
+    {
+      (*perElement)[i][c] = perElementStream.read<float>();
+      (*swapped)[i][c]    = swappedStream.readSwapped<float>();
+    }
+  }
+
+  osg::ref_ptr<osg::Vec3Array> bulk = new osg::Vec3Array();
+  osgHelper::ByteStream bulkStream(data.data(), data.size());
+  bulkStream.readInto(*bulk, numVertices);
+
+  osg::ref_ptr<osg::Vec3Array> bulkSwapped = new osg::Vec3Array();
+  osgHelper::ByteStream bulkSwappedStream(data.data(), data.size());
+  bulkSwappedStream.readIntoSwapped(*bulkSwapped, numVertices);
+
+  ASSERT_EQ(bulk->size(), perElement->size());
+  ASSERT_EQ(bulkSwapped->size(), swapped->size());
+  EXPECT_EQ(std::memcmp(&(*bulk)[0], &(*perElement)[0], data.size()), 0);
+  EXPECT_EQ(std::memcmp(&(*bulkSwapped)[0], &(*swapped)[0], data.size()), 0);
+  EXPECT_TRUE(bulkStream.isEnd());
+  EXPECT_TRUE(bulkSwappedStream.isEnd());
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/DecodedImageCache.h>
+#include <osgHelper/ResourceManager.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <osgDB/ReaderWriter>
+#include <osgDB/Registry>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// "decodes" files containing "<width> <height>" into a gradient image
+class TestImageReaderWriter : public osgDB::ReaderWriter
+{
+public:
+  TestImageReaderWriter()
+  {
+    supportsExtension("testimg", "osgHelper test image");
+  }
+
+  const char* className() const override
+  {
+    return "TestImageReaderWriter";
+  }
+
+  ReadResult readObject(std::istream& stream, const osgDB::ReaderWriter::Options* options = nullptr) const override
+  {
+    numDecodes++;
+
+    int width  = 0;
+    int height = 0;
+    stream >> width >> height;
+
+    return createImage(width, height).release();
+  }
+
+  static osg::ref_ptr<osg::Image> createImage(int width, int height)
+  {
+    osg::ref_ptr<osg::Image> image = new osg::Image();
+    image->allocateImage(width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+
+    for (auto i = 0U; i < image->getImageSizeInBytes(); i++)
+    {
+      image->data()[i] = static_cast<unsigned char>((i * 31) ^ (i >> 8));
+    }
+
+    return image;
+  }
+
+  mutable std::atomic<int> numDecodes{ 0 };
+};
+
+void writeFile(const std::filesystem::path& filename, const std::string& content)
+{
+  std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+  stream << content;
+}
+
+bool haveEqualPixels(const osg::Image& lhs, const osg::Image& rhs)
+{
+  return (lhs.s() == rhs.s()) && (lhs.t() == rhs.t()) && (lhs.r() == rhs.r()) &&
+         (lhs.getPixelFormat() == rhs.getPixelFormat()) && (lhs.getDataType() == rhs.getDataType()) &&
+         (lhs.getTotalSizeInBytesIncludingMipmaps() == rhs.getTotalSizeInBytesIncludingMipmaps()) &&
+         (std::memcmp(lhs.data(), rhs.data(), lhs.getTotalSizeInBytesIncludingMipmaps()) == 0);
+}
+
+}
+
+TEST(DecodedImageCacheTest, ReadsWrittenImages)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_decodedImageCache";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  const auto sourceFilename = (directory / "image.testimg").string();
+  writeFile(sourceFilename, "64 32");
+
+  osg::ref_ptr<osgHelper::DecodedImageCache> cache = new osgHelper::DecodedImageCache((directory / "cache").string());
+  EXPECT_FALSE(cache->read(sourceFilename).valid());
+
+  const auto image = TestImageReaderWriter::createImage(64, 32);
+  cache->write(sourceFilename, *image);
+
+  const auto cachedImage = cache->read(sourceFilename);
+  ASSERT_TRUE(cachedImage.valid());
+  EXPECT_TRUE(haveEqualPixels(*cachedImage, *image));
+
+  // the pixels are mapped at a page-aligned offset
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(cachedImage->data()) % 4096, 0U);
+
+  // modifying the mapped pixels leaves the entry unchanged
+  cachedImage->data()[0] ^= 0xff;
+  EXPECT_FALSE(haveEqualPixels(*cachedImage, *image));
+  EXPECT_TRUE(haveEqualPixels(*cache->read(sourceFilename), *image));
+
+  // any change of the source file invalidates the entry
+  writeFile(sourceFilename, "64 32 ");
+  EXPECT_FALSE(cache->read(sourceFilename).valid());
+
+  cache->write(sourceFilename, *image);
+  EXPECT_TRUE(cache->read(sourceFilename).valid());
+
+  cache->clear();
+  EXPECT_FALSE(cache->read(sourceFilename).valid());
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(DecodedImageCacheTest, ResourceManagerDecodesOnce)
+{
+  const auto numImages = 8;
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_decodedImageCacheManager";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  std::vector<osgHelper::ResourceKey> resourceKeys;
+  for (auto i = 0; i < numImages; i++)
+  {
+    const auto filename = (directory / ("image" + std::to_string(i) + ".testimg")).string();
+    writeFile(filename, std::to_string(256 + i) + " 256");
+
+    resourceKeys.push_back(filename);
+  }
+
+  osg::ref_ptr<TestImageReaderWriter> readerWriter = new TestImageReaderWriter();
+  osgDB::Registry::instance()->addReaderWriter(readerWriter.get());
+
+  osg::ref_ptr<osgHelper::DecodedImageCache> cache = new osgHelper::DecodedImageCache((directory / "cache").string());
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  std::vector<osg::ref_ptr<osg::Image>> decodedImages;
+  {
+    osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+    manager->setDecodedImageCache(cache);
+
+    decodedImages = manager->loadImages(resourceKeys);
+    EXPECT_EQ(readerWriter->numDecodes, numImages);
+    EXPECT_EQ(manager->getLoadStatistics().numLoadsPerReaderWriter["TestImageReaderWriter"],
+              static_cast<unsigned long long>(numImages));
+  }
+
+  // a later session maps the decoded pixels
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setDecodedImageCache(cache);
+
+  const auto cachedImages = manager->loadImages(resourceKeys);
+  EXPECT_EQ(readerWriter->numDecodes, numImages);
+  EXPECT_EQ(manager->getLoadStatistics().numLoadsPerReaderWriter["DecodedImageCache"],
+            static_cast<unsigned long long>(numImages));
+
+  ASSERT_EQ(cachedImages.size(), decodedImages.size());
+  for (auto i = 0U; i < cachedImages.size(); i++)
+  {
+    ASSERT_TRUE(decodedImages[i].valid());
+    ASSERT_TRUE(cachedImages[i].valid());
+    EXPECT_TRUE(haveEqualPixels(*cachedImages[i], *decodedImages[i]));
+  }
+
+  osgDB::Registry::instance()->removeReaderWriter(readerWriter.get());
+  std::filesystem::remove_all(directory);
+}
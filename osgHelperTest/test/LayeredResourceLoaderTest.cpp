@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/FileResourceLoader.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/LayeredResourceLoader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+class MemoryResourceLoader : public osgHelper::IResourceLoader
+{
+public:
+  void getResourceStream(const std::string&, std::ifstream&, long long&) override
+  {
+    throw osgHelper::GameException("Not supported");
+  }
+
+  osg::ref_ptr<osgHelper::ResourceData> getResourceData(const std::string& resourceKey) override
+  {
+    const auto it = resources.find(resourceKey);
+    if (it == resources.end())
+    {
+      throw osgHelper::GameException("Could not find resource '" + resourceKey + "'");
+    }
+
+    osg::ref_ptr<osgHelper::ResourceBuffer> buffer = new osgHelper::ResourceBuffer(it->second.size());
+    std::copy(it->second.begin(), it->second.end(), buffer->getBuffer());
+
+    return buffer;
+  }
+
+  bool hasResource(const std::string& resourceKey) override
+  {
+    numQueries++;
+    return resources.count(resourceKey) > 0;
+  }
+
+  std::map<std::string, std::string> resources;
+  std::atomic<int>                   numQueries{ 0 };
+};
+
+std::string toString(const osg::ref_ptr<osgHelper::ResourceData>& data)
+{
+  return std::string(data->getData(), data->getSize());
+}
+
+void writeFile(const std::filesystem::path& filename, const std::string& content)
+{
+  std::filesystem::create_directories(filename.parent_path());
+
+  std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+  stream << content;
+}
+
+}
+
+TEST(LayeredResourceLoaderTest, ServesResourcesFromTopmostLayer)
+{
+  osg::ref_ptr<MemoryResourceLoader> mod   = new MemoryResourceLoader();
+  osg::ref_ptr<MemoryResourceLoader> patch = new MemoryResourceLoader();
+  osg::ref_ptr<MemoryResourceLoader> base  = new MemoryResourceLoader();
+
+  mod->resources["mods/test/a"] = "mod a";
+  patch->resources["a"]         = "patch a";
+  patch->resources["b"]         = "patch b";
+  base->resources["a"]          = "base a";
+  base->resources["b"]          = "base b";
+  base->resources["c"]          = "base c";
+
+  osg::ref_ptr<osgHelper::LayeredResourceLoader> loader = new osgHelper::LayeredResourceLoader();
+  loader->addLayer(mod, "mods/test/");
+  loader->addLayer(patch);
+  loader->addLayer(base);
+
+  EXPECT_EQ(loader->getNumLayers(), 3U);
+  EXPECT_EQ(toString(loader->getResourceData("a")), "mod a");
+  EXPECT_EQ(toString(loader->getResourceData("b")), "patch b");
+  EXPECT_EQ(toString(loader->getResourceData("c")), "base c");
+  EXPECT_EQ(loader->findLayer("c"), 2);
+  EXPECT_FALSE(loader->hasResource("d"));
+  EXPECT_THROW(loader->getResourceData("d"), osgHelper::GameException);
+
+  // the misses of the overlay layers are remembered
+  const auto numModQueries   = mod->numQueries.load();
+  const auto numPatchQueries = patch->numQueries.load();
+  const auto numBaseQueries  = base->numQueries.load();
+
+  for (auto i = 0; i < 10; i++)
+  {
+    EXPECT_EQ(toString(loader->getResourceData("c")), "base c");
+    EXPECT_FALSE(loader->hasResource("d"));
+  }
+
+  EXPECT_EQ(mod->numQueries, numModQueries);
+  EXPECT_EQ(patch->numQueries, numPatchQueries);
+  EXPECT_EQ(base->numQueries, numBaseQueries + 10);
+
+  // resources added at runtime are found after clearing the cache
+  patch->resources["c"] = "patch c";
+  EXPECT_EQ(toString(loader->getResourceData("c")), "base c");
+
+  loader->clearNegativeCache();
+  EXPECT_EQ(toString(loader->getResourceData("c")), "patch c");
+}
+
+TEST(LayeredResourceLoaderTest, LimitsNegativeCacheSize)
+{
+  osg::ref_ptr<MemoryResourceLoader> overlay = new MemoryResourceLoader();
+  osg::ref_ptr<MemoryResourceLoader> base    = new MemoryResourceLoader();
+
+  osg::ref_ptr<osgHelper::LayeredResourceLoader> loader = new osgHelper::LayeredResourceLoader();
+  loader->addLayer(overlay);
+  loader->addLayer(base);
+  loader->setMaxNegativeCacheSize(4);
+
+  EXPECT_EQ(loader->getMaxNegativeCacheSize(), 4U);
+
+  for (auto i = 0; i < 4; i++)
+  {
+    EXPECT_FALSE(loader->hasResource("missing" + std::to_string(i)));
+  }
+
+  // the four misses are remembered
+  const auto numQueries = overlay->numQueries.load();
+  for (auto i = 0; i < 4; i++)
+  {
+    EXPECT_FALSE(loader->hasResource("missing" + std::to_string(i)));
+  }
+
+  EXPECT_EQ(overlay->numQueries, numQueries);
+
+  // a fifth miss makes the layer forget the previous ones
+  EXPECT_FALSE(loader->hasResource("missing4"));
+  EXPECT_FALSE(loader->hasResource("missing0"));
+  EXPECT_EQ(overlay->numQueries, numQueries + 2);
+}
+
+TEST(LayeredResourceLoaderTest, FindsSameLayersWithAndWithoutNegativeCache)
+{
+  const auto numFiles  = 100;
+  const auto numLayers = 4;
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_layered";
+
+  std::filesystem::remove_all(directory);
+
+  std::vector<std::string> resourceKeys;
+  for (auto i = 0; i < numFiles; i++)
+  {
+    resourceKeys.push_back("textures/texture" + std::to_string(i) + ".png");
+    writeFile(directory / "base" / resourceKeys.back(), "base");
+  }
+
+  // each overlay replaces a few resources
+  for (auto layer = 0; layer < numLayers - 1; layer++)
+  {
+    for (auto i = layer; i < numFiles; i += 10)
+    {
+      writeFile(directory / ("overlay" + std::to_string(layer)) / resourceKeys[i], "overlay");
+    }
+  }
+
+  std::vector<osg::ref_ptr<osgHelper::LayeredResourceLoader>> loaders;
+  for (auto i = 0; i < 2; i++)
+  {
+    loaders.push_back(new osgHelper::LayeredResourceLoader());
+    for (auto layer = 0; layer < numLayers - 1; layer++)
+    {
+      loaders.back()->addLayer(new osgHelper::FileResourceLoader(),
+                               (directory / ("overlay" + std::to_string(layer))).generic_string() + "/");
+    }
+
+    loaders.back()->addLayer(new osgHelper::FileResourceLoader(), (directory / "base").generic_string() + "/");
+  }
+
+  loaders[0]->setNegativeCacheEnabled(false);
+
+  for (auto round = 0; round < 2; round++)
+  {
+    for (auto i = 0; i < numFiles; i++)
+    {
+      const auto layer = loaders[1]->findLayer(resourceKeys[i]);
+      EXPECT_EQ(loaders[0]->findLayer(resourceKeys[i]), layer);
+      EXPECT_EQ(layer, ((i % 10) < numLayers - 1) ? (i % 10) : (numLayers - 1));
+    }
+  }
+
+  // the file of a resource is the one of the layer that serves it
+  EXPECT_EQ(loaders[1]->getResourceFilename(resourceKeys[0]),
+            (directory / "overlay0").generic_string() + "/" + resourceKeys[0]);
+  EXPECT_EQ(loaders[1]->getResourceFilename(resourceKeys[5]),
+            (directory / "base").generic_string() + "/" + resourceKeys[5]);
+  EXPECT_TRUE(loaders[1]->getResourceFilename("missing").empty());
+
+  std::filesystem::remove_all(directory);
+}
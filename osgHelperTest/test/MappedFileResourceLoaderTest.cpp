@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/FileResourceLoader.h>
+#include <osgHelper/MappedFileResourceLoader.h>
+#include <osgHelper/ResourceManager.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+
+std::vector<char> createFile(const std::string& filename, std::size_t size)
+{
+  std::vector<char> content(size);
+  for (auto i = 0U; i < size; i++)
+  {
+    content[i] = static_cast<char>((i * 31) % 251);
+  }
+
+  std::ofstream stream(filename, std::ios::binary);
+  stream.write(content.data(), static_cast<std::streamsize>(size));
+
+  return content;
+}
+
+}
+
+TEST(MappedFileResourceLoaderTest, ServesFileContent)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_mapped";
+  std::filesystem::create_directories(directory);
+
+  const auto filename = (directory / "data.bin").string();
+  const auto content  = createFile(filename, 4096);
+
+  osg::ref_ptr<osgHelper::MappedFileResourceLoader> loader = new osgHelper::MappedFileResourceLoader();
+
+  const auto data = loader->getResourceData(filename);
+  ASSERT_EQ(data->getSize(), content.size());
+  EXPECT_EQ(std::memcmp(data->getData(), content.data(), content.size()), 0);
+
+  osgHelper::ResourceDataStream stream(data);
+  stream.seekg(100);
+
+  char c = 0;
+  stream.read(&c, 1);
+  EXPECT_EQ(c, content[100]);
+
+  stream.seekg(0, std::ios::end);
+  EXPECT_EQ(static_cast<std::size_t>(stream.tellg()), content.size());
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setResourceLoader(loader);
+
+  const auto binary = manager->loadBinary(filename);
+  ASSERT_TRUE(binary.valid());
+  ASSERT_EQ(binary->getSize(), content.size());
+  EXPECT_EQ(std::memcmp(binary->getBytes(), content.data(), content.size()), 0);
+
+  EXPECT_THROW(loader->getResourceData((directory / "missing.bin").string()), std::exception);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(MappedFileResourceLoaderTest, MatchesStreamedReads)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_mappedSizes";
+  std::filesystem::create_directories(directory);
+
+  osg::ref_ptr<osgHelper::FileResourceLoader>       fileLoader   = new osgHelper::FileResourceLoader();
+  osg::ref_ptr<osgHelper::MappedFileResourceLoader> mappedLoader = new osgHelper::MappedFileResourceLoader();
+
+  // sizes around page boundaries
+  for (const std::size_t size : { 1U, 4095U, 4096U, 4097U, 1024U * 1024U + 3U })
+  {
+    const auto filename = (directory / ("data" + std::to_string(size) + ".bin")).string();
+    const auto content  = createFile(filename, size);
+
+    const auto streamed = fileLoader->getResourceData(filename);
+    const auto mapped   = mappedLoader->getResourceData(filename);
+
+    ASSERT_EQ(streamed->getSize(), size);
+    ASSERT_EQ(mapped->getSize(), size);
+    EXPECT_EQ(std::memcmp(streamed->getData(), content.data(), size), 0);
+    EXPECT_EQ(std::memcmp(mapped->getData(), content.data(), size), 0);
+  }
+
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/PackArchive.h>
+#include <osgHelper/PackArchiveWriter.h>
+#include <osgHelper/PackResourceLoader.h>
+#include <osgHelper/ResourceManager.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+
+namespace
+{
+
+void writeFile(const std::filesystem::path& filename, const std::string& content)
+{
+  std::filesystem::create_directories(filename.parent_path());
+
+  std::ofstream stream(filename, std::ios::binary);
+  stream.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+}
+
+TEST(PackResourceLoaderTest, RoundTrip)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_pack";
+  std::filesystem::remove_all(directory);
+
+  std::map<std::string, std::string> files;
+  files["shaders/Default.vert"]  = "void main() {}";
+  files["shaders/Default.frag"]  = "void main() { gl_FragColor = vec4(1.0); }";
+  files["textures/sub/a.raw"]    = std::string(1000, '\x7f');
+  files["empty.txt"]             = "";
+  for (auto i = 0; i < 50; i++)
+  {
+    files["many/file" + std::to_string(i) + ".txt"] = "content " + std::to_string(i);
+  }
+
+  for (const auto& file : files)
+  {
+    writeFile(directory / "input" / file.first, file.second);
+  }
+
+  const auto packFilename = (directory / "resources.pack").string();
+
+  osgHelper::PackArchiveWriter writer;
+  writer.addDirectory((directory / "input").string(), "Resources/");
+  writer.write(packFilename);
+
+  ASSERT_EQ(writer.getNumEntries(), files.size());
+
+  osg::ref_ptr<osgHelper::PackResourceLoader> loader = new osgHelper::PackResourceLoader(packFilename);
+  ASSERT_EQ(loader->getArchive()->getNumEntries(), files.size());
+
+  for (const auto& file : files)
+  {
+    const auto data = loader->getResourceData("resources/" + file.first);
+    ASSERT_EQ(data->getSize(), file.second.size()) << file.first;
+    EXPECT_EQ(std::string(data->getData(), data->getSize()), file.second);
+
+    std::size_t offset, size;
+    ASSERT_TRUE(loader->getArchive()->find("resources/" + file.first, offset, size));
+    EXPECT_EQ(offset % osgHelper::PackArchive::Alignment, 0U);
+
+    std::ifstream stream;
+    long long     length = 0;
+    loader->getResourceStream("resources/" + file.first, stream, length);
+
+    std::string streamed(static_cast<std::size_t>(length), '\0');
+    stream.read(&streamed[0], length);
+    EXPECT_EQ(streamed, file.second);
+  }
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setResourceLoader(loader);
+
+  EXPECT_EQ(manager->loadText("Resources\\Shaders\\Default.FRAG"), files["shaders/Default.frag"]);
+  EXPECT_EQ(manager->loadText("resources/many/FILE7.txt"), "content 7");
+
+  EXPECT_THROW(loader->getResourceData("resources/missing.txt"), std::exception);
+  EXPECT_THROW(manager->loadText("resources/missing.txt"), std::exception);
+
+  loader = nullptr;
+  manager = nullptr;
+  std::filesystem::remove_all(directory);
+}
+
+TEST(PackResourceLoaderTest, RejectsInvalidFiles)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_pack_invalid";
+  std::filesystem::create_directories(directory);
+
+  writeFile(directory / "invalid.pack", "definitely not a pack file");
+  EXPECT_THROW(osgHelper::PackArchive((directory / "invalid.pack").string()), std::exception);
+
+  osgHelper::PackArchiveWriter writer;
+  writer.addData("a", std::vector<char>(100, 'a'));
+  writer.write((directory / "valid.pack").string());
+
+  std::filesystem::resize_file(directory / "valid.pack", 80);
+  EXPECT_THROW(osgHelper::PackArchive((directory / "valid.pack").string()), std::exception);
+
+  std::filesystem::remove_all(directory);
+}
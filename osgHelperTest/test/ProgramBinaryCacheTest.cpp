@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/ProgramBinaryCache.h>
+#include <osgHelper/ShaderFactory.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const std::string LlvmpipeDriver = "Mesa / llvmpipe (LLVM 15.0.7, 256 bits) / 4.5 (Compatibility Profile) Mesa 23.2.1";
+
+osg::ref_ptr<osg::Program> createProgram(const std::string& fragmentSource)
+{
+  osg::ref_ptr<osg::Program> program = new osg::Program();
+  program->addShader(new osg::Shader(osg::Shader::VERTEX, "void main() { gl_Position = ftransform(); }"));
+  program->addShader(new osg::Shader(osg::Shader::FRAGMENT, fragmentSource));
+
+  return program;
+}
+
+osg::ref_ptr<osg::Program::ProgramBinary> createBinary(unsigned int size)
+{
+  std::vector<unsigned char> data(size);
+  for (auto i = 0U; i < size; i++)
+  {
+    data[i] = static_cast<unsigned char>(i * 13);
+  }
+
+  osg::ref_ptr<osg::Program::ProgramBinary> binary = new osg::Program::ProgramBinary();
+  binary->assign(size, data.data());
+  binary->setFormat(0x8740);
+
+  return binary;
+}
+
+std::string createDirectory(const std::string& name)
+{
+  const auto directory = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(directory);
+
+  return directory.string();
+}
+
+}
+
+TEST(ProgramBinaryCacheTest, StoresBinariesPerSourceAndDriver)
+{
+  const auto directory = createDirectory("osgHelperTest_programBinaries");
+  const auto source    = "void main() { gl_FragColor = vec4(1.0); }";
+
+  {
+    osg::ref_ptr<osgHelper::ProgramBinaryCache> cache = new osgHelper::ProgramBinaryCache(directory);
+    EXPECT_TRUE(cache->getDriverString().empty());
+
+    // the driver is unknown until the first frame, programs are compiled from source
+    EXPECT_FALSE(cache->prepare(createProgram(source)));
+
+    cache->setDriverString(LlvmpipeDriver);
+    EXPECT_FALSE(cache->read(*createProgram(source)).valid());
+
+    cache->write(*createProgram(source), *createBinary(1000));
+  }
+
+  // the driver string of the previous run is used before the context is current
+  osg::ref_ptr<osgHelper::ProgramBinaryCache> cache = new osgHelper::ProgramBinaryCache(directory);
+  EXPECT_EQ(cache->getDriverString(), LlvmpipeDriver);
+
+  const auto program = createProgram(source);
+  EXPECT_TRUE(cache->prepare(program));
+
+  const auto binary = program->getProgramBinary();
+  ASSERT_NE(binary, nullptr);
+  EXPECT_EQ(binary->getFormat(), 0x8740U);
+  ASSERT_EQ(binary->getSize(), 1000U);
+
+  const auto expectedBinary = createBinary(1000);
+  EXPECT_EQ(std::vector<unsigned char>(binary->getData(), binary->getData() + binary->getSize()),
+            std::vector<unsigned char>(expectedBinary->getData(), expectedBinary->getData() + 1000));
+
+  EXPECT_FALSE(cache->prepare(createProgram("void main() { gl_FragColor = vec4(0.5); }")));
+
+  cache->setDriverString("Mesa / softpipe / 3.3 (Core Profile) Mesa 23.2.1");
+  EXPECT_FALSE(cache->prepare(createProgram(source)));
+
+  cache->setDriverString(LlvmpipeDriver);
+  EXPECT_TRUE(cache->read(*createProgram(source)).valid());
+
+  const auto statistics = cache->getStatistics();
+  EXPECT_EQ(statistics.numLoaded, 1U);
+  EXPECT_EQ(statistics.numStored, 0U);
+  EXPECT_EQ(statistics.numRejected, 0U);
+
+  cache->clear();
+  EXPECT_FALSE(cache->read(*createProgram(source)).valid());
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ProgramBinaryCacheTest, IgnoresTruncatedEntries)
+{
+  const auto directory = createDirectory("osgHelperTest_truncatedProgramBinaries");
+  const auto program   = createProgram("void main() { gl_FragColor = vec4(1.0); }");
+
+  osg::ref_ptr<osgHelper::ProgramBinaryCache> cache = new osgHelper::ProgramBinaryCache(directory);
+  cache->setDriverString(LlvmpipeDriver);
+  cache->write(*program, *createBinary(4096));
+
+  for (const auto& entry : std::filesystem::directory_iterator(directory))
+  {
+    if (entry.path().extension() == ".ohprog")
+    {
+      std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) - 1);
+    }
+  }
+
+  EXPECT_FALSE(cache->read(*program).valid());
+  EXPECT_FALSE(cache->prepare(program));
+  EXPECT_EQ(program->getProgramBinary(), nullptr);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ProgramBinaryCacheTest, ShaderFactoryPreparesProgramsOptIn)
+{
+  const auto directory = createDirectory("osgHelperTest_factoryProgramBinaries");
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector           injector(container);
+
+  osg::ref_ptr<osgHelper::ShaderFactory> factory = new osgHelper::ShaderFactory(injector);
+  EXPECT_FALSE(factory->getProgramBinaryCache().valid());
+
+  const auto program = createProgram("void main() { gl_FragColor = vec4(1.0); }");
+
+  osg::ref_ptr<osgHelper::ProgramBinaryCache> cache = new osgHelper::ProgramBinaryCache(directory);
+  cache->setDriverString(LlvmpipeDriver);
+  cache->write(*program, *createBinary(64));
+
+  factory->prepareProgram(program);
+  EXPECT_EQ(program->getProgramBinary(), nullptr);
+
+  factory->setProgramBinaryCache(cache);
+  factory->prepareProgram(program);
+  EXPECT_NE(program->getProgramBinary(), nullptr);
+  EXPECT_EQ(cache->getStatistics().numLoaded, 1U);
+
+  std::filesystem::remove_all(directory);
+}
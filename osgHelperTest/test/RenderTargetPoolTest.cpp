@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/RenderTargetPool.h>
+
+#include <vector>
+
+TEST(RenderTargetPoolTest, ReusesReleasedTextures)
+{
+  osg::ref_ptr<osgHelper::RenderTargetPool> pool = new osgHelper::RenderTargetPool();
+
+  auto texture = pool->acquire(osg::Vec2i(640, 480), GL_RGBA16F_ARB, osg::Texture::LINEAR);
+  ASSERT_TRUE(texture.valid());
+  EXPECT_EQ(texture->getTextureWidth(), 640);
+  EXPECT_EQ(texture->getTextureHeight(), 480);
+  EXPECT_EQ(texture->getInternalFormat(), GL_RGBA16F_ARB);
+
+  auto* rawTexture = texture.get();
+  pool->release(texture);
+  texture = nullptr;
+
+  EXPECT_EQ(pool->acquire(osg::Vec2i(640, 480), GL_RGBA16F_ARB, osg::Texture::LINEAR).get(), rawTexture);
+
+  const auto statistics = pool->getStatistics();
+  EXPECT_EQ(statistics.numAcquires, 2U);
+  EXPECT_EQ(statistics.numAllocations, 1U);
+  EXPECT_EQ(statistics.numReuses, 1U);
+  EXPECT_EQ(statistics.numInUse, 1U);
+  EXPECT_EQ(statistics.numFree, 0U);
+}
+
+TEST(RenderTargetPoolTest, SeparatesKeys)
+{
+  osg::ref_ptr<osgHelper::RenderTargetPool> pool = new osgHelper::RenderTargetPool();
+
+  const osg::Vec2i size(256, 256);
+
+  pool->release(pool->acquire(size, GL_RGBA16F_ARB, osg::Texture::LINEAR));
+
+  EXPECT_TRUE(pool->acquire(osg::Vec2i(256, 128), GL_RGBA16F_ARB, osg::Texture::LINEAR).valid());
+  EXPECT_TRUE(pool->acquire(size, GL_DEPTH_COMPONENT, osg::Texture::LINEAR).valid());
+  EXPECT_TRUE(pool->acquire(size, GL_RGBA16F_ARB, osg::Texture::NEAREST).valid());
+
+  const auto statistics = pool->getStatistics();
+  EXPECT_EQ(statistics.numAllocations, 4U);
+  EXPECT_EQ(statistics.numReuses, 0U);
+  EXPECT_EQ(statistics.numFree, 1U);
+
+  // textures that were not acquired from the pool are ignored
+  pool->release(new osg::Texture2D());
+  EXPECT_EQ(pool->getStatistics().numFree, 1U);
+}
+
+TEST(RenderTargetPoolTest, KeepsReferencedTexturesExclusive)
+{
+  osg::ref_ptr<osgHelper::RenderTargetPool> pool = new osgHelper::RenderTargetPool();
+
+  const osg::Vec2i size(128, 128);
+
+  const auto texture = pool->acquire(size, GL_RGBA16F_ARB, osg::Texture::LINEAR);
+  pool->release(texture);
+
+  // e.g. a state set still uses the released texture
+  const auto other = pool->acquire(size, GL_RGBA16F_ARB, osg::Texture::LINEAR);
+  EXPECT_NE(other, texture);
+  EXPECT_EQ(pool->getStatistics().numReuses, 0U);
+}
+
+TEST(RenderTargetPoolTest, LimitsFreeTexturesPerKey)
+{
+  osg::ref_ptr<osgHelper::RenderTargetPool> pool = new osgHelper::RenderTargetPool(1, 2);
+
+  const osg::Vec2i size(64, 64);
+
+  std::vector<osg::ref_ptr<osg::Texture2D>> textures;
+  for (auto i = 0; i < 4; i++)
+  {
+    textures.push_back(pool->acquire(size, GL_RGBA16F_ARB, osg::Texture::LINEAR));
+  }
+
+  for (const auto& texture : textures)
+  {
+    pool->release(texture);
+  }
+
+  EXPECT_EQ(pool->getStatistics().numFree, 2U);
+
+  pool->clear();
+  EXPECT_EQ(pool->getStatistics().numFree, 0U);
+}
+
+TEST(RenderTargetPoolTest, LimitsFreeTexturesAcrossKeys)
+{
+  osg::ref_ptr<osgHelper::RenderTargetPool> pool = new osgHelper::RenderTargetPool(1, 2, 3);
+
+  const osg::Vec2i oldSize(64, 64);
+  const osg::Vec2i newSize(128, 128);
+
+  std::vector<osg::ref_ptr<osg::Texture2D>> textures;
+  for (const auto& size : { oldSize, oldSize, newSize, newSize })
+  {
+    textures.push_back(pool->acquire(size, GL_RGBA16F_ARB, osg::Texture::LINEAR));
+  }
+
+  for (const auto& texture : textures)
+  {
+    pool->release(texture);
+  }
+
+  textures.clear();
+
+  // the textures of the least recently used size are dropped first
+  EXPECT_EQ(pool->getStatistics().numFree, 3U);
+  pool->acquire(newSize, GL_RGBA16F_ARB, osg::Texture::LINEAR);
+  pool->acquire(newSize, GL_RGBA16F_ARB, osg::Texture::LINEAR);
+  pool->acquire(oldSize, GL_RGBA16F_ARB, osg::Texture::LINEAR);
+
+  const auto statistics = pool->getStatistics();
+  EXPECT_EQ(statistics.numReuses, 3U);
+  EXPECT_EQ(statistics.numFree, 0U);
+}
+
+TEST(RenderTargetPoolTest, ClearsUnusedSizes)
+{
+  osg::ref_ptr<osgHelper::RenderTargetPool> pool = new osgHelper::RenderTargetPool();
+
+  // a resize settles at 128x128, the depth texture of the same size is kept
+  auto texture = pool->acquire(osg::Vec2i(64, 64), GL_RGBA16F_ARB, osg::Texture::LINEAR);
+  pool->release(pool->acquire(osg::Vec2i(128, 128), GL_DEPTH_COMPONENT, osg::Texture::LINEAR));
+  pool->release(texture);
+  texture = pool->acquire(osg::Vec2i(128, 128), GL_RGBA16F_ARB, osg::Texture::LINEAR);
+
+  EXPECT_EQ(pool->getStatistics().numFree, 2U);
+
+  pool->clearUnusedSizes();
+  EXPECT_EQ(pool->getStatistics().numFree, 1U);
+  EXPECT_EQ(pool->getStatistics().numInUse, 1U);
+
+  // textures resized while in use are not recycled
+  texture->setTextureSize(256, 256);
+  pool->release(texture);
+
+  EXPECT_EQ(pool->getStatistics().numFree, 1U);
+  EXPECT_EQ(pool->getStatistics().numInUse, 0U);
+}
+
+TEST(RenderTargetPoolTest, BucketsContinuousResizes)
+{
+  const auto numResizes = 1000;
+
+  const auto resize = [numResizes](int sizeGranularity)
+  {
+    osg::ref_ptr<osgHelper::RenderTargetPool> pool = new osgHelper::RenderTargetPool(sizeGranularity);
+
+    // dragging a window edge, the consumer keeps using the previous texture until the new one is attached
+    osg::ref_ptr<osg::Texture2D> attached;
+    for (auto i = 0; i < numResizes; i++)
+    {
+      const osg::Vec2i size(400 + i, 300 + i / 2);
+
+      const auto texture = pool->acquire(size, GL_RGBA16F_ARB, osg::Texture::LINEAR);
+      EXPECT_GE(texture->getTextureWidth(), size.x());
+      EXPECT_GE(texture->getTextureHeight(), size.y());
+
+      if (attached.valid())
+      {
+        pool->release(attached);
+      }
+
+      attached = texture;
+    }
+
+    return pool->getStatistics();
+  };
+
+  const auto exact    = resize(1);
+  const auto bucketed = resize(64);
+
+  EXPECT_EQ(exact.numAllocations, static_cast<unsigned long long>(numResizes));
+  EXPECT_EQ(bucketed.numAllocations + bucketed.numReuses, static_cast<unsigned long long>(numResizes));
+  EXPECT_LT(bucketed.numAllocations, static_cast<unsigned long long>(numResizes / 10));
+
+  osg::ref_ptr<osgHelper::RenderTargetPool> pool = new osgHelper::RenderTargetPool(64);
+  EXPECT_EQ(pool->getBucketSize(osg::Vec2i(800, 601)), osg::Vec2i(832, 640));
+  EXPECT_EQ(pool->getBucketSize(osg::Vec2i(0, 64)), osg::Vec2i(64, 64));
+}
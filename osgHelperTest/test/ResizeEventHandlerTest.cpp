@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/ResizeEventCallback.h>
+
+namespace
+{
+
+class ActionAdapter : public osgGA::GUIActionAdapter
+{
+public:
+  void requestRedraw() override {}
+  void requestContinuousUpdate(bool) override {}
+  void requestWarpPointer(float, float) override {}
+};
+
+struct ResizeDriver
+{
+  explicit ResizeDriver(osgHelper::ResizeEventHandler::Mode mode)
+    : handler(new osgHelper::ResizeEventHandler([this](int width, int height)
+      {
+        numRebuilds++;
+        lastSize = osg::Vec2i(width, height);
+        return true;
+      }, mode))
+    , time(0.0)
+    , numRebuilds(0)
+    , numScales(0)
+  {
+    handler->setPendingResizeCallback([this](int, int)
+    {
+      numScales++;
+      return true;
+    });
+  }
+
+  void resize(int width, int height)
+  {
+    osg::ref_ptr<osgGA::GUIEventAdapter> ea = new osgGA::GUIEventAdapter();
+    ea->setEventType(osgGA::GUIEventAdapter::RESIZE);
+    ea->setWindowRectangle(0, 0, width, height);
+    ea->setTime(time);
+
+    handler->handle(*ea, actionAdapter);
+  }
+
+  void frame(double deltaTime = 1.0 / 60.0)
+  {
+    time += deltaTime;
+
+    osg::ref_ptr<osgGA::GUIEventAdapter> ea = new osgGA::GUIEventAdapter();
+    ea->setEventType(osgGA::GUIEventAdapter::FRAME);
+    ea->setTime(time);
+
+    handler->handle(*ea, actionAdapter);
+  }
+
+  // dragging a window edge for a while, with several RESIZE events per frame
+  void drag(int numResizes, int resizesPerFrame)
+  {
+    for (auto i = 0; i < numResizes; i++)
+    {
+      resize(800 + i, 600 + i / 2);
+      if ((i + 1) % resizesPerFrame == 0)
+      {
+        frame();
+      }
+    }
+  }
+
+  osg::ref_ptr<osgHelper::ResizeEventHandler> handler;
+  ActionAdapter                               actionAdapter;
+
+  double     time;
+  int        numRebuilds;
+  int        numScales;
+  osg::Vec2i lastSize;
+};
+
+}
+
+TEST(ResizeEventHandlerTest, CoalescesResizes)
+{
+  const auto numResizes      = 1000;
+  const auto resizesPerFrame = 4;
+  const osg::Vec2i finalSize(800 + numResizes - 1, 600 + (numResizes - 1) / 2);
+
+  ResizeDriver immediate(osgHelper::ResizeEventHandler::Mode::Immediate);
+  immediate.drag(numResizes, resizesPerFrame);
+
+  ResizeDriver perFrame(osgHelper::ResizeEventHandler::Mode::PerFrame);
+  perFrame.drag(numResizes, resizesPerFrame);
+
+  ResizeDriver debounced(osgHelper::ResizeEventHandler::Mode::Debounced);
+  debounced.drag(numResizes, resizesPerFrame);
+
+  EXPECT_EQ(debounced.numRebuilds, 0);
+  EXPECT_TRUE(debounced.handler->hasPendingResize());
+
+  // the window edge is released
+  for (auto i = 0; i < 60; i++)
+  {
+    debounced.frame();
+  }
+
+  EXPECT_EQ(immediate.numRebuilds, numResizes);
+  EXPECT_EQ(immediate.numScales, 0);
+
+  EXPECT_EQ(perFrame.numRebuilds, numResizes / resizesPerFrame);
+  EXPECT_EQ(perFrame.numScales, numResizes);
+
+  EXPECT_EQ(debounced.numRebuilds, 1);
+  EXPECT_EQ(debounced.numScales, numResizes);
+  EXPECT_FALSE(debounced.handler->hasPendingResize());
+
+  for (const auto* driver : { &immediate, &perFrame, &debounced })
+  {
+    EXPECT_EQ(driver->lastSize, finalSize);
+    EXPECT_EQ(driver->handler->getStatistics().numResizeEvents, static_cast<unsigned long long>(numResizes));
+    EXPECT_EQ(driver->handler->getStatistics().numCallbacks, static_cast<unsigned long long>(driver->numRebuilds));
+  }
+}
+
+TEST(ResizeEventHandlerTest, DebouncesAfterQuietPeriod)
+{
+  ResizeDriver driver(osgHelper::ResizeEventHandler::Mode::Debounced);
+
+  driver.resize(640, 480);
+  driver.frame(0.1);
+  EXPECT_EQ(driver.numRebuilds, 0);
+
+  driver.frame(0.15);
+  EXPECT_EQ(driver.numRebuilds, 1);
+  EXPECT_EQ(driver.lastSize, osg::Vec2i(640, 480));
+
+  // a pause while dragging rebuilds once more
+  driver.drag(100, 2);
+  driver.frame(0.5);
+  driver.drag(100, 2);
+  driver.frame(0.5);
+  EXPECT_EQ(driver.numRebuilds, 3);
+
+  driver.frame(0.5);
+  EXPECT_EQ(driver.numRebuilds, 3);
+
+  driver.resize(1024, 768);
+  EXPECT_TRUE(driver.handler->flush());
+  EXPECT_EQ(driver.numRebuilds, 4);
+  EXPECT_FALSE(driver.handler->flush());
+}
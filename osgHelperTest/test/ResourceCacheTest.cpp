@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/ResourceCache.h>
+#include <osgHelper/TextResource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+osg::ref_ptr<osgHelper::TextResource> createTextResource(const std::string& text)
+{
+  osg::ref_ptr<osgHelper::TextResource> res = new osgHelper::TextResource();
+  res->text = text;
+
+  return res;
+}
+
+std::string keyForIndex(int index)
+{
+  return "resources/key" + std::to_string(index);
+}
+
+std::string toLower(std::string str)
+{
+  std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+  return str;
+}
+
+}
+
+TEST(ResourceCacheTest, StoreAndLookup)
+{
+  osgHelper::ResourceCache cache(4);
+
+  const auto first  = createTextResource("first");
+  const auto second = createTextResource("second");
+
+  EXPECT_FALSE(cache.get("key").valid());
+  EXPECT_EQ(cache.store("key", first), first);
+  EXPECT_EQ(cache.store("key", second), first) << "an existing entry should not be replaced";
+  EXPECT_EQ(cache.get("key"), first);
+
+  EXPECT_TRUE(cache.remove("key"));
+  EXPECT_FALSE(cache.remove("key"));
+  EXPECT_FALSE(cache.get("key").valid());
+
+  const auto stats = cache.getStatistics();
+  EXPECT_EQ(stats.numLookups, 3U);
+  EXPECT_EQ(stats.numHits, 1U);
+  EXPECT_EQ(stats.numStores, 2U);
+}
+
+TEST(ResourceCacheTest, MemoryBudgetEviction)
+{
+  osgHelper::ResourceCache cache(1);
+  cache.setMemoryBudget(300);
+
+  // still referenced outside of the cache, must never be evicted
+  const auto pinned = createTextResource(std::string(100, 'p'));
+  cache.store("pinned", pinned);
+
+  cache.store("a", createTextResource(std::string(100, 'a')));
+  cache.store("b", createTextResource(std::string(100, 'b')));
+
+  EXPECT_EQ(cache.getStatistics().numBytes, 300U);
+  EXPECT_EQ(cache.getStatistics().numEvictions, 0U);
+
+  // recently used entries get a second chance
+  EXPECT_TRUE(cache.get("b").valid());
+
+  cache.store("c", createTextResource(std::string(100, 'c')));
+
+  auto stats = cache.getStatistics();
+  EXPECT_EQ(stats.numEvictions, 1U);
+  EXPECT_EQ(stats.numBytes, 300U);
+  EXPECT_TRUE(cache.get("pinned").valid());
+  EXPECT_FALSE(cache.get("a").valid());
+  EXPECT_TRUE(cache.get("b").valid());
+  EXPECT_TRUE(cache.get("c").valid());
+
+  cache.setMemoryBudget(100);
+
+  stats = cache.getStatistics();
+  EXPECT_EQ(stats.numEvictions, 3U);
+  EXPECT_EQ(stats.numBytes, 100U);
+  EXPECT_EQ(cache.get("pinned"), pinned);
+
+  cache.clear();
+  EXPECT_EQ(cache.getStatistics().numBytes, 0U);
+}
+
+TEST(ResourceCacheTest, ConcurrentStress)
+{
+  const auto numKeys    = 1000;
+  const auto numThreads = 8;
+
+  osgHelper::ResourceCache cache;
+
+  std::vector<std::thread> threads;
+  for (auto t = 0; t < numThreads; t++)
+  {
+    threads.emplace_back([&cache, t]()
+    {
+      for (auto i = 0; i < numKeys; i++)
+      {
+        const auto index = (i + t * 37) % numKeys;
+        const auto key   = keyForIndex(index);
+
+        auto obj = cache.get(key);
+        if (!obj.valid())
+        {
+          obj = cache.store(key, createTextResource(key));
+        }
+
+        const auto textRes = dynamic_cast<osgHelper::TextResource*>(obj.get());
+        ASSERT_NE(textRes, nullptr);
+        ASSERT_EQ(textRes->text, key);
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (auto i = 0; i < numKeys; i++)
+  {
+    EXPECT_TRUE(cache.get(keyForIndex(i)).valid());
+  }
+
+  const auto stats = cache.getStatistics();
+  EXPECT_EQ(stats.numLookups, static_cast<unsigned long long>(numKeys * numThreads + numKeys));
+}
+
+TEST(ResourceCacheTest, ConcurrentLookups)
+{
+  const auto numKeys          = 1000;
+  const auto numThreads       = 4;
+  const auto lookupsPerThread = 20000;
+
+  osgHelper::ResourceCache cache;
+  for (auto i = 0; i < numKeys; i++)
+  {
+    cache.store(keyForIndex(i), createTextResource(keyForIndex(i)));
+  }
+
+  std::vector<std::string> keys;
+  for (auto i = 0; i < numKeys; i++)
+  {
+    keys.push_back(keyForIndex(i));
+  }
+
+  std::atomic<int>         numMismatches(0);
+  std::vector<std::thread> threads;
+
+  for (auto t = 0; t < numThreads; t++)
+  {
+    threads.emplace_back([&cache, &keys, &numMismatches, t]()
+    {
+      for (auto i = 0; i < lookupsPerThread; i++)
+      {
+        const auto& key     = keys[(i * 7 + t) % keys.size()];
+        const auto  textRes = dynamic_cast<osgHelper::TextResource*>(cache.get(key).get());
+
+        if (!textRes || (textRes->text != key))
+        {
+          numMismatches++;
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(numMismatches, 0);
+
+  const auto stats = cache.getStatistics();
+  EXPECT_EQ(stats.numLookups, static_cast<unsigned long long>(numThreads * lookupsPerThread));
+  EXPECT_EQ(stats.numHits, stats.numLookups);
+  EXPECT_EQ(stats.numMisses, 0U);
+  EXPECT_DOUBLE_EQ(stats.getHitRatio(), 1.0);
+}
+
+TEST(ResourceCacheTest, CaseInsensitiveKeys)
+{
+  const osgHelper::ResourceKey key("Shaders/Default.VERT");
+  EXPECT_EQ(key, osgHelper::ResourceKey("shaders/default.vert"));
+  EXPECT_NE(key, osgHelper::ResourceKey("shaders/default.frag"));
+  EXPECT_EQ(key.getHash(), osgHelper::ResourceKey("SHADERS/DEFAULT.VERT").getHash());
+  EXPECT_EQ(key.str(), "Shaders/Default.VERT");
+
+  osgHelper::ResourceCache cache;
+  cache.store(key, createTextResource("a"));
+
+  EXPECT_TRUE(cache.get("shaders/default.vert").valid());
+  EXPECT_TRUE(cache.remove("SHADERS/Default.vert"));
+  EXPECT_FALSE(cache.get(key).valid());
+}
+
+TEST(ResourceCacheTest, LookupsByNameAndKeyAgree)
+{
+  const auto numKeys = 1000;
+
+  osgHelper::ResourceCache            cache;
+  std::vector<std::string>            names;
+  std::vector<osgHelper::ResourceKey> keys;
+
+  for (auto i = 0; i < numKeys; i++)
+  {
+    names.push_back("Resources/Textures/Tile" + std::to_string(i) + ".png");
+    keys.emplace_back(names.back());
+
+    cache.store(keys.back(), createTextResource(names.back()));
+  }
+
+  for (auto i = 0; i < numKeys; i++)
+  {
+    const auto obj = cache.get(keys[i]);
+    ASSERT_TRUE(obj.valid());
+
+    EXPECT_EQ(static_cast<osgHelper::TextResource*>(obj.get())->text, names[i]);
+    EXPECT_EQ(cache.get(names[i]), obj);
+    EXPECT_EQ(cache.get(toLower(names[i])), obj);
+    EXPECT_EQ(osgHelper::ResourceKey(toLower(names[i])).getHash(), keys[i].getHash());
+  }
+
+  EXPECT_FALSE(cache.get("Resources/Textures/Tile" + std::to_string(numKeys) + ".png").valid());
+
+  const auto stats = cache.getStatistics();
+  EXPECT_EQ(stats.numLookups, static_cast<unsigned long long>(3 * numKeys + 1));
+  EXPECT_EQ(stats.numHits, static_cast<unsigned long long>(3 * numKeys));
+  EXPECT_EQ(stats.numMisses, 1U);
+}
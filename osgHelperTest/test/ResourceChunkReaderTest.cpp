@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/ByteStream.h>
+#include <osgHelper/FileResourceLoader.h>
+#include <osgHelper/ResourceChunkReader.h>
+#include <osgHelper/ResourceCodec.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+
+std::string writeFile(const std::string& name, const std::vector<char>& data)
+{
+  const auto filename = (std::filesystem::temp_directory_path() / name).string();
+
+  std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+  stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+  return filename;
+}
+
+std::vector<char> createData(std::size_t size)
+{
+  std::vector<char> data(size);
+  for (std::size_t i = 0; i < size; i++)
+  {
+    data[i] = static_cast<char>((i * 7) ^ (i >> 10));
+  }
+
+  return data;
+}
+
+template <typename T>
+void append(std::vector<char>& data, const T& value)
+{
+  const auto bytes = reinterpret_cast<const char*>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+void appendVarUInt(std::vector<char>& data, std::uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    data.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+
+  data.push_back(static_cast<char>(value));
+}
+
+std::vector<char> readAllChunks(osgHelper::ResourceChunkReader& reader, std::size_t& maxChunkSize)
+{
+  std::vector<char> data;
+  maxChunkSize = 0;
+
+  while (const auto chunk = reader.readChunk())
+  {
+    data.insert(data.end(), chunk->getData(), chunk->getData() + chunk->getSize());
+    maxChunkSize = std::max(maxChunkSize, chunk->getSize());
+  }
+
+  return data;
+}
+
+}
+
+TEST(ResourceChunkReaderTest, ReadsChunksWithReadAhead)
+{
+  const auto data     = createData(1024 * 1024 + 123);
+  const auto filename = writeFile("osgHelperTest_chunks.bin", data);
+
+  osg::ref_ptr<osgHelper::FileResourceLoader> loader = new osgHelper::FileResourceLoader();
+
+  for (auto numReadAheadChunks = 0U; numReadAheadChunks <= 2; numReadAheadChunks++)
+  {
+    const auto reader = loader->openResourceChunks(filename, 64 * 1024, numReadAheadChunks);
+    EXPECT_EQ(reader->getSize(), data.size());
+    EXPECT_FALSE(reader->isCompressed());
+
+    std::size_t maxChunkSize;
+    EXPECT_EQ(readAllChunks(*reader, maxChunkSize), data);
+    EXPECT_EQ(maxChunkSize, 64U * 1024U);
+    EXPECT_FALSE(reader->readChunk().valid());
+  }
+
+  // readers that are not read to the end stop reading ahead when they are destroyed
+  loader->openResourceChunks(filename, 1024, 4)->readChunk();
+
+  std::filesystem::remove(filename);
+}
+
+TEST(ResourceChunkReaderTest, DecompressesBlockByBlock)
+{
+  const auto data     = createData(100 * 1000);
+  const auto filename = writeFile("osgHelperTest_chunks.ohz",
+                                  osgHelper::ResourceCodec::compress(data.data(), data.size(), 4096));
+
+  osg::ref_ptr<osgHelper::FileResourceLoader> loader = new osgHelper::FileResourceLoader();
+
+  const auto reader = loader->openResourceChunks(filename, 64 * 1024, 2);
+  EXPECT_TRUE(reader->isCompressed());
+  EXPECT_EQ(reader->getSize(), data.size());
+  EXPECT_EQ(reader->getChunkSize(), 4096U);
+
+  std::size_t maxChunkSize;
+  EXPECT_EQ(readAllChunks(*reader, maxChunkSize), data);
+  EXPECT_EQ(maxChunkSize, 4096U);
+
+  std::filesystem::remove(filename);
+}
+
+TEST(ResourceChunkReaderTest, ValidatesBlockSizesAgainstResourceSize)
+{
+  const auto data       = createData(100 * 1000);
+  const auto compressed = osgHelper::ResourceCodec::compress(data.data(), data.size(), 4096);
+
+  // e.g. a pack entry, the stream continues with the next resource
+  const auto readTruncated = [&compressed](std::size_t size, unsigned int numReadAheadChunks)
+  {
+    auto stream = std::make_unique<std::istringstream>(std::string(compressed.begin(), compressed.end()) +
+                                                       std::string(compressed.begin(), compressed.end()));
+
+    osg::ref_ptr<osgHelper::ResourceChunkReader> reader =
+      new osgHelper::ResourceChunkReader(std::move(stream), size, 4096, numReadAheadChunks, true);
+
+    std::size_t maxChunkSize;
+    readAllChunks(*reader, maxChunkSize);
+  };
+
+  for (auto numReadAheadChunks = 0U; numReadAheadChunks <= 2; numReadAheadChunks++)
+  {
+    EXPECT_NO_THROW(readTruncated(compressed.size(), numReadAheadChunks));
+    EXPECT_THROW(readTruncated(compressed.size() - 1, numReadAheadChunks), std::exception);
+  }
+}
+
+TEST(ResourceChunkReaderTest, ByteStreamReadsAcrossChunkBoundaries)
+{
+  const auto numRecords = 200;
+
+  std::vector<char> data;
+  for (auto i = 0; i < numRecords; i++)
+  {
+    append<std::int32_t>(data, -i);
+    append<double>(data, i * 0.5);
+    appendVarUInt(data, static_cast<std::uint64_t>(i) * 1000);
+    data.insert(data.end(), { 'r', 'e', 'c', static_cast<char>('0' + i % 10) });
+
+    for (auto j = 0; j < 25; j++)
+    {
+      append<float>(data, static_cast<float>(i + j));
+    }
+
+    append<std::uint16_t>(data, 0xbeef);
+  }
+
+  const auto filename = writeFile("osgHelperTest_chunkedStream.bin", data);
+
+  osg::ref_ptr<osgHelper::FileResourceLoader> loader = new osgHelper::FileResourceLoader();
+
+  // odd chunk sizes, so that values, views and arrays span chunk boundaries
+  for (const auto chunkSize : { 1U, 7U, 64U, 4096U })
+  {
+    osgHelper::ByteStream stream(loader->openResourceChunks(filename, chunkSize, 2));
+    EXPECT_EQ(stream.getSize(), data.size());
+
+    for (auto i = 0; i < numRecords; i++)
+    {
+      EXPECT_EQ(stream.read<std::int32_t>(), -i);
+      EXPECT_EQ(stream.read<double>(), i * 0.5);
+      EXPECT_EQ(stream.readVarUInt(), static_cast<std::uint64_t>(i) * 1000);
+      EXPECT_EQ(stream.readStringView(4), std::string("rec") + static_cast<char>('0' + i % 10));
+
+      if (i % 2 == 0)
+      {
+        std::vector<float> values;
+        stream.readInto(values, 25);
+
+        ASSERT_EQ(values.size(), 25U);
+        EXPECT_EQ(values[0], static_cast<float>(i));
+        EXPECT_EQ(values[24], static_cast<float>(i + 24));
+      }
+      else
+      {
+        stream.skip(25 * sizeof(float));
+      }
+
+      EXPECT_EQ(stream.read<std::uint16_t>(), 0xbeef);
+    }
+
+    EXPECT_EQ(stream.getPos(), static_cast<int>(data.size()));
+    EXPECT_EQ(stream.getRemaining(), 0U);
+    EXPECT_TRUE(stream.isEnd());
+    EXPECT_THROW(stream.read<char>(), std::exception);
+  }
+
+  // moved streams continue where the previous one stopped, copies would share the position in the reader
+  static_assert(!std::is_copy_constructible<osgHelper::ByteStream>::value, "ByteStream must not be copyable");
+
+  osgHelper::ByteStream stream(loader->openResourceChunks(filename, 7, 2));
+  EXPECT_EQ(stream.read<std::int32_t>(), 0);
+  EXPECT_EQ(stream.read<std::int8_t>(), 0);
+
+  auto moved = std::move(stream);
+  EXPECT_EQ(moved.getPos(), 5);
+  EXPECT_EQ(moved.readStringView(7), std::string(data.data() + 5, 7));
+  EXPECT_EQ(moved.getRemaining(), data.size() - 12);
+
+  std::filesystem::remove(filename);
+}
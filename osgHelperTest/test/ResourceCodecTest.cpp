@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/FileResourceLoader.h>
+#include <osgHelper/MappedFileResourceLoader.h>
+#include <osgHelper/PackArchiveWriter.h>
+#include <osgHelper/PackResourceLoader.h>
+#include <osgHelper/ResourceCodec.h>
+#include <osgHelper/ResourceManager.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::string createShaderLikeText(std::size_t size)
+{
+  std::mt19937 random(7);
+
+  std::string text;
+  while (text.size() < size)
+  {
+    text += "uniform vec4 color" + std::to_string(random() % 100) + ";\n";
+    text += "vec3 light = normalize(lightPosition - position) * " + std::to_string(random() % 1000) + ".0;\n";
+  }
+
+  text.resize(size);
+  return text;
+}
+
+std::string roundTrip(const std::string& data, std::size_t blockSize = osgHelper::ResourceCodec::DefaultBlockSize)
+{
+  const auto compressed = osgHelper::ResourceCodec::compress(data.data(), data.size(), blockSize);
+  EXPECT_TRUE(osgHelper::ResourceCodec::isCompressed(compressed.data(), compressed.size()));
+
+  const auto size = osgHelper::ResourceCodec::getDecompressedSize(compressed.data(), compressed.size());
+  EXPECT_EQ(size, data.size());
+
+  std::string result(size, '\0');
+  osgHelper::ResourceCodec::decompress(compressed.data(), compressed.size(), &result[0], size);
+
+  std::istringstream stream(std::string(compressed.begin(), compressed.end()));
+  stream.seekg(static_cast<std::streamoff>(osgHelper::ResourceCodec::HeaderSize));
+
+  auto inSize = compressed.size() - osgHelper::ResourceCodec::HeaderSize;
+
+  std::string streamed(size, '\0');
+  osgHelper::ResourceCodec::decompress(stream, inSize, osgHelper::ResourceCodec::getBlockSize(compressed.data()),
+                                       &streamed[0], size);
+  EXPECT_EQ(streamed, result);
+  EXPECT_EQ(inSize, 0U);
+
+  return result;
+}
+
+void writeFile(const std::filesystem::path& filename, const char* data, std::size_t size)
+{
+  std::ofstream stream(filename, std::ios::binary);
+  stream.write(data, static_cast<std::streamsize>(size));
+}
+
+}
+
+TEST(ResourceCodecTest, RoundTrip)
+{
+  EXPECT_EQ(roundTrip(""), "");
+  EXPECT_EQ(roundTrip("a"), "a");
+  EXPECT_EQ(roundTrip(std::string(100000, 'x')), std::string(100000, 'x'));
+
+  const auto text = createShaderLikeText(1000000);
+  EXPECT_EQ(roundTrip(text), text);
+  EXPECT_EQ(roundTrip(text, 1000), text);
+
+  std::mt19937 random(3);
+  std::string  noise(300000, '\0');
+  for (auto& c : noise)
+  {
+    c = static_cast<char>(random());
+  }
+
+  EXPECT_EQ(roundTrip(noise), noise);
+
+  const auto compressed = osgHelper::ResourceCodec::compress(text.data(), text.size());
+  EXPECT_LT(compressed.size() * 4, text.size());
+}
+
+TEST(ResourceCodecTest, DetectsCorruptData)
+{
+  const auto text = createShaderLikeText(10000);
+  auto compressed = osgHelper::ResourceCodec::compress(text.data(), text.size());
+
+  std::string result(text.size(), '\0');
+
+  auto truncated = compressed;
+  truncated.resize(truncated.size() / 2);
+  EXPECT_THROW(osgHelper::ResourceCodec::decompress(truncated.data(), truncated.size(), &result[0], result.size()),
+               std::exception);
+
+  std::mt19937 random(5);
+  for (auto i = 0; i < 100; i++)
+  {
+    auto damaged = compressed;
+    damaged[osgHelper::ResourceCodec::HeaderSize + 4 + random() % (damaged.size() - 20)] ^= 0x5a;
+
+    // damaged literals decode to wrong content, damaged sequences must not read or write out of bounds
+    try
+    {
+      osgHelper::ResourceCodec::decompress(damaged.data(), damaged.size(), &result[0], result.size());
+    }
+    catch (const std::exception&)
+    {
+    }
+  }
+
+  EXPECT_FALSE(osgHelper::ResourceCodec::isCompressed(text.data(), text.size()));
+
+  // a header must not claim more than the compressed bytes can expand to
+  auto oversized = compressed;
+  oversized[15] = static_cast<char>(0x7f);
+  EXPECT_THROW(osgHelper::ResourceCodec::getDecompressedSize(oversized.data(), oversized.size()), std::exception);
+  EXPECT_THROW(osgHelper::ResourceCodec::getDecompressedSize(compressed.data(), osgHelper::ResourceCodec::HeaderSize),
+               std::exception);
+  EXPECT_EQ(osgHelper::ResourceCodec::getDecompressedSize(compressed.data(), osgHelper::ResourceCodec::HeaderSize,
+                                                          compressed.size()), text.size());
+}
+
+TEST(ResourceCodecTest, Extension)
+{
+  EXPECT_TRUE(osgHelper::ResourceCodec::hasExtension("shaders/light.frag.ohz"));
+  EXPECT_TRUE(osgHelper::ResourceCodec::hasExtension("MODEL.OSGB.OHZ"));
+  EXPECT_FALSE(osgHelper::ResourceCodec::hasExtension("shaders/light.frag"));
+  EXPECT_FALSE(osgHelper::ResourceCodec::hasExtension(".ohz"));
+
+  EXPECT_EQ(osgHelper::ResourceCodec::stripExtension("shaders/light.frag.ohz"), "shaders/light.frag");
+  EXPECT_EQ(osgHelper::ResourceCodec::stripExtension("shaders/light.frag"), "shaders/light.frag");
+}
+
+TEST(ResourceCodecTest, ResourceManagerDecompressesTransparently)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_codec";
+  std::filesystem::create_directories(directory);
+
+  const auto text       = createShaderLikeText(50000);
+  const auto compressed = osgHelper::ResourceCodec::compress(text.data(), text.size());
+
+  const auto filename = (directory / "shader.glsl.ohz").string();
+  writeFile(filename, compressed.data(), compressed.size());
+
+  // resources without the extension are never decoded, even if they start with the magic
+  const auto plainFilename = (directory / "shader.bin").string();
+  writeFile(plainFilename, compressed.data(), compressed.size());
+
+  const auto corruptFilename = (directory / "corrupt.txt.ohz").string();
+  writeFile(corruptFilename, text.data(), text.size());
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+
+  const std::vector<osg::ref_ptr<osgHelper::IResourceLoader>> loaders = {
+    new osgHelper::FileResourceLoader(), new osgHelper::MappedFileResourceLoader()
+  };
+
+  for (const auto& loader : loaders)
+  {
+    manager->setResourceLoader(loader);
+    manager->clearCache();
+    manager->resetLoadStatistics();
+
+    EXPECT_EQ(manager->loadText(filename), text);
+    EXPECT_EQ(manager->getLoadStatistics().numBytesRead, text.size());
+
+    manager->clearCache();
+
+    const auto binary = manager->loadBinary(filename);
+    ASSERT_EQ(binary->getSize(), text.size());
+    EXPECT_EQ(std::string(binary->getBytes(), binary->getSize()), text);
+
+    const auto plainBinary = manager->loadBinary(plainFilename);
+    EXPECT_EQ(std::vector<char>(plainBinary->getBytes(), plainBinary->getBytes() + plainBinary->getSize()),
+              compressed);
+
+    EXPECT_THROW(manager->loadText(corruptFilename), std::exception);
+  }
+
+  manager = nullptr;
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResourceCodecTest, LoadsSameContentWithAndWithoutCompression)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_codec_files";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  const auto numFiles = 4;
+  const auto fileSize = 256U * 1024U + 17U;
+
+  std::size_t plainBytes = 0, compressedBytes = 0;
+  std::vector<std::string> texts;
+  for (auto i = 0; i < numFiles; i++)
+  {
+    const auto text       = createShaderLikeText(fileSize) + std::to_string(i);
+    const auto compressed = osgHelper::ResourceCodec::compress(text.data(), text.size());
+    const auto name       = "file" + std::to_string(i) + ".txt";
+
+    writeFile(directory / name, text.data(), text.size());
+    writeFile(directory / (name + osgHelper::ResourceCodec::Extension), compressed.data(), compressed.size());
+
+    plainBytes += text.size();
+    compressedBytes += compressed.size();
+    texts.push_back(text);
+  }
+
+  EXPECT_LT(compressedBytes * 4, plainBytes);
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  for (const auto& loader : std::vector<osg::ref_ptr<osgHelper::IResourceLoader>>{
+         new osgHelper::FileResourceLoader(), new osgHelper::MappedFileResourceLoader() })
+  {
+    osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+    manager->setResourceLoader(loader);
+
+    for (auto i = 0; i < numFiles; i++)
+    {
+      const auto filename = (directory / ("file" + std::to_string(i) + ".txt")).string();
+
+      EXPECT_EQ(manager->loadText(filename), texts[i]);
+      EXPECT_EQ(manager->loadText(filename + osgHelper::ResourceCodec::Extension), texts[i]);
+    }
+  }
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResourceCodecTest, CompressedPack)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_codec_pack";
+  std::filesystem::create_directories(directory);
+
+  const auto text = createShaderLikeText(20000);
+
+  osgHelper::PackArchiveWriter writer;
+  writer.setCompressionEnabled(true);
+  writer.addData("shaders/large.frag", std::vector<char>(text.begin(), text.end()));
+  writer.addData("tiny.txt", std::vector<char>{ 'a', 'b' });
+
+  // incompressible entries are stored as they are, their bytes are never decoded
+  std::mt19937 random(11);
+  std::string  noise(1000, '\0');
+  for (auto& c : noise)
+  {
+    c = static_cast<char>(random());
+  }
+
+  const auto compressed = osgHelper::ResourceCodec::compress(noise.data(), noise.size());
+  writer.addData("compressed.bin", compressed);
+  writer.write((directory / "compressed.pack").string());
+
+  EXPECT_LT(std::filesystem::file_size(directory / "compressed.pack"), text.size() / 2);
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::PackResourceLoader> loader =
+    new osgHelper::PackResourceLoader((directory / "compressed.pack").string());
+
+  EXPECT_TRUE(loader->isCompressedResource("shaders/large.frag"));
+  EXPECT_FALSE(loader->isCompressedResource("tiny.txt"));
+  EXPECT_FALSE(loader->isCompressedResource("compressed.bin"));
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setResourceLoader(loader);
+
+  EXPECT_EQ(manager->loadText("shaders/large.frag"), text);
+  EXPECT_EQ(manager->loadText("tiny.txt"), "ab");
+
+  const auto binary = manager->loadBinary("compressed.bin");
+  EXPECT_EQ(std::vector<char>(binary->getBytes(), binary->getBytes() + binary->getSize()), compressed);
+
+  const auto reader = loader->openResourceChunks("shaders/large.frag", 4096, 0);
+  EXPECT_TRUE(reader->isCompressed());
+  EXPECT_EQ(reader->getSize(), text.size());
+
+  manager = nullptr;
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/FileResourceLoader.h>
+#include <osgHelper/LayeredResourceLoader.h>
+#include <osgHelper/MappedFileResourceLoader.h>
+#include <osgHelper/ResourceFileWatcher.h>
+#include <osgHelper/ResourceManager.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// the modification time is advanced explicitly, it may not change on file systems with a coarse resolution
+void writeFile(const std::filesystem::path& filename, const std::string& content)
+{
+  const auto existed       = std::filesystem::exists(filename);
+  const auto lastWriteTime = existed ? std::filesystem::last_write_time(filename) : std::filesystem::file_time_type();
+
+  {
+    std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+    stream << content;
+  }
+
+  if (existed)
+  {
+    std::filesystem::last_write_time(filename, lastWriteTime + std::chrono::seconds(1));
+  }
+}
+
+// editors usually save to a temporary file and rename it
+void replaceFile(const std::filesystem::path& filename, const std::string& content)
+{
+  const auto tempFilename = filename.string() + ".tmp";
+  writeFile(tempFilename, content);
+  std::filesystem::rename(tempFilename, filename);
+}
+
+// applies reloads as they finish until the expected number of resources has been reloaded
+bool applyReloads(osgHelper::ResourceManager& manager, const std::vector<std::string>& reloadedKeys,
+                  std::size_t numExpectedReloads)
+{
+  manager.applyPendingReloads();
+  while (reloadedKeys.size() < numExpectedReloads)
+  {
+    if (!manager.waitForPendingReloads(std::chrono::seconds(30)))
+    {
+      return false;
+    }
+
+    manager.applyPendingReloads();
+  }
+
+  return true;
+}
+
+}
+
+TEST(ResourceFileWatcherTest, DetectsChanges)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_watcher";
+  std::filesystem::create_directories(directory);
+
+  const auto watched   = (directory / "watched.txt").string();
+  const auto unwatched = (directory / "unwatched.txt").string();
+  writeFile(watched, "a");
+  writeFile(unwatched, "a");
+
+  osg::ref_ptr<osgHelper::ResourceFileWatcher> watcher = new osgHelper::ResourceFileWatcher();
+  watcher->watch(watched);
+  watcher->watch((directory / "missing.txt").string());
+
+  EXPECT_TRUE(watcher->isWatching(watched));
+  EXPECT_FALSE(watcher->isWatching(unwatched));
+  EXPECT_FALSE(watcher->isWatching((directory / "missing.txt").string()));
+  EXPECT_TRUE(watcher->pollChanges().empty());
+
+  // changes are queued by the time the write returns, polling does not have to wait for them
+  writeFile(unwatched, "b");
+  writeFile(watched, "b");
+
+  const auto changes = watcher->pollChanges();
+  ASSERT_EQ(changes.size(), 1U);
+  EXPECT_EQ(changes[0], watched);
+  EXPECT_TRUE(watcher->pollChanges().empty());
+
+  replaceFile(watched, "c");
+  EXPECT_EQ(watcher->pollChanges(), std::vector<std::string>{ watched });
+
+  watcher->unwatch(watched);
+  writeFile(watched, "d");
+  EXPECT_TRUE(watcher->pollChanges().empty());
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResourceFileWatcherTest, HotReloadUpdatesShadersInPlace)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_hotreload";
+  std::filesystem::create_directories(directory);
+
+  const auto shaderFilename = (directory / "shader.frag").string();
+  const auto textFilename   = (directory / "config.txt").string();
+  writeFile(shaderFilename, "void main() {}");
+  writeFile(textFilename, "version 1");
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setHotReloadEnabled(true);
+
+  const auto shader = manager->loadShader(shaderFilename, osg::Shader::FRAGMENT);
+  EXPECT_EQ(manager->loadText(textFilename), "version 1");
+
+  std::vector<std::string> reloadedKeys;
+  const auto observer = manager->getResourceReloadedObservable()->connect([&](const std::string& resourceKey)
+  {
+    reloadedKeys.push_back(resourceKey);
+  });
+
+  replaceFile(shaderFilename, "void main() { discard; }");
+  writeFile(textFilename, "version 2");
+
+  ASSERT_TRUE(applyReloads(*manager, reloadedKeys, 2));
+
+  EXPECT_EQ(shader->getShaderSource(), "void main() { discard; }");
+  EXPECT_EQ(manager->loadShader(shaderFilename, osg::Shader::FRAGMENT), shader);
+  EXPECT_EQ(manager->loadText(textFilename), "version 2");
+
+  // without hot reload the cached resources stay untouched
+  manager->setHotReloadEnabled(false);
+  writeFile(textFilename, "version 3");
+  manager->applyPendingReloads();
+  EXPECT_FALSE(manager->waitForPendingReloads(std::chrono::milliseconds(0)));
+  EXPECT_EQ(manager->loadText(textFilename), "version 2");
+
+  manager = nullptr;
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResourceFileWatcherTest, HotReloadReplacesBinaryResources)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_hotreload_binary";
+  std::filesystem::create_directories(directory);
+
+  const auto filename = (directory / "data.bin").string();
+  writeFile(filename, "version 1");
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setResourceLoader(new osgHelper::MappedFileResourceLoader());
+  manager->setHotReloadEnabled(true);
+
+  const auto binary = manager->loadBinary(filename);
+
+  std::vector<std::string> reloadedKeys;
+  const auto observer = manager->getResourceReloadedObservable()->connect([&](const std::string& resourceKey)
+  {
+    reloadedKeys.push_back(resourceKey);
+  });
+
+  // the file is truncated in place, the loaded resource does not refer to the mapping
+  writeFile(filename, "version 2, longer");
+  ASSERT_TRUE(applyReloads(*manager, reloadedKeys, 1));
+
+  EXPECT_EQ(std::string(binary->getBytes(), binary->getSize()), "version 1");
+
+  const auto reloaded = manager->loadBinary(filename);
+  EXPECT_NE(reloaded, binary);
+  EXPECT_EQ(std::string(reloaded->getBytes(), reloaded->getSize()), "version 2, longer");
+
+  manager = nullptr;
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResourceFileWatcherTest, HotReloadWatchesLayeredResources)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_hotreload_layered";
+  std::filesystem::create_directories(directory / "overlay");
+  std::filesystem::create_directories(directory / "base");
+
+  writeFile(directory / "base" / "a.txt", "base a");
+  writeFile(directory / "base" / "b.txt", "base b");
+
+  osg::ref_ptr<osgHelper::LayeredResourceLoader> loader = new osgHelper::LayeredResourceLoader();
+  loader->addLayer(new osgHelper::FileResourceLoader(), (directory / "overlay").generic_string() + "/");
+  loader->addLayer(new osgHelper::FileResourceLoader(), (directory / "base").generic_string() + "/");
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setResourceLoader(loader);
+  manager->setHotReloadEnabled(true);
+
+  EXPECT_EQ(manager->loadText("a.txt"), "base a");
+  EXPECT_EQ(manager->loadText("b.txt"), "base b");
+
+  std::vector<std::string> reloadedKeys;
+  const auto observer = manager->getResourceReloadedObservable()->connect([&](const std::string& resourceKey)
+  {
+    reloadedKeys.push_back(resourceKey);
+  });
+
+  // an overlay file is added meanwhile, the reload of another resource makes it visible
+  writeFile(directory / "overlay" / "b.txt", "overlay b");
+  writeFile(directory / "base" / "a.txt", "base a, version 2");
+  ASSERT_TRUE(applyReloads(*manager, reloadedKeys, 1));
+
+  ASSERT_EQ(reloadedKeys.size(), 1U);
+  EXPECT_EQ(reloadedKeys[0], "a.txt");
+  EXPECT_EQ(manager->loadText("a.txt"), "base a, version 2");
+  EXPECT_EQ(loader->findLayer("b.txt"), 0);
+
+  manager = nullptr;
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/ResourceManager.h>
+#include <osgHelper/FileResourceLoader.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+class CountingResourceLoader : public osgHelper::FileResourceLoader
+{
+public:
+  void getResourceStream(const std::string& resourceKey, std::ifstream& stream, long long& length) override
+  {
+    numRequests++;
+    osgHelper::FileResourceLoader::getResourceStream(resourceKey, stream, length);
+  }
+
+  std::atomic<int> numRequests{ 0 };
+};
+
+std::vector<std::string> createTextFiles(const std::filesystem::path& directory, int numFiles, int fileSize)
+{
+  std::filesystem::create_directories(directory);
+
+  std::vector<std::string> filenames;
+  for (auto i = 0; i < numFiles; i++)
+  {
+    const auto filename = (directory / ("file" + std::to_string(i) + ".txt")).string();
+
+    std::ofstream stream(filename, std::ios::binary);
+    stream << std::string(fileSize, static_cast<char>('a' + (i % 26)));
+
+    filenames.push_back(filename);
+  }
+
+  return filenames;
+}
+
+}
+
+TEST(ResourceManagerTest, AsyncLoadDeduplicatesRequests)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_async";
+  const auto filenames = createTextFiles(directory, 4, 1024);
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<CountingResourceLoader>      loader  = new CountingResourceLoader();
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setResourceLoader(loader);
+
+  std::vector<std::future<std::string>> futures;
+  for (auto i = 0; i < 10; i++)
+  {
+    for (const auto& filename : filenames)
+    {
+      futures.push_back(manager->loadTextAsync(filename));
+    }
+  }
+
+  for (auto i = 0U; i < futures.size(); i++)
+  {
+    const auto text = futures[i].get();
+    EXPECT_EQ(text.size(), 1024U);
+    EXPECT_EQ(text[0], static_cast<char>('a' + (i % filenames.size())));
+  }
+
+  EXPECT_EQ(loader->numRequests, static_cast<int>(filenames.size()));
+  EXPECT_EQ(manager->loadText(filenames[0]), std::string(1024, 'a'));
+  EXPECT_EQ(loader->numRequests, static_cast<int>(filenames.size()));
+
+  EXPECT_THROW(manager->loadTextAsync((directory / "missing.txt").string()).get(), std::exception);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResourceManagerTest, StringAndKeyOverloadsShareCache)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_overloads";
+  const auto filenames = createTextFiles(directory, 1, 16);
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<CountingResourceLoader>      loader  = new CountingResourceLoader();
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setResourceLoader(loader);
+
+  const osgHelper::ResourceKey key(filenames[0]);
+  osgHelper::IResourceManager& resourceManager = *manager;
+
+  EXPECT_EQ(manager->loadText(key), std::string(16, 'a'));
+  EXPECT_EQ(manager->loadText(filenames[0]), std::string(16, 'a'));
+  EXPECT_EQ(manager->loadText(filenames[0].c_str()), std::string(16, 'a'));
+  EXPECT_EQ(resourceManager.loadText(filenames[0]), std::string(16, 'a'));
+  EXPECT_EQ(resourceManager.loadTextAsync(filenames[0]).get(), std::string(16, 'a'));
+  EXPECT_EQ(loader->numRequests, 1);
+
+  resourceManager.clearCacheResource(filenames[0]);
+  EXPECT_EQ(manager->loadText(key), std::string(16, 'a'));
+  EXPECT_EQ(loader->numRequests, 2);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResourceManagerTest, PooledLoadingMatchesSerialLoading)
+{
+  const auto numFiles  = 16;
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_pooled";
+  const auto filenames = createTextFiles(directory, numFiles, 4096);
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::ResourceManager> serialManager = new osgHelper::ResourceManager(injector);
+  osg::ref_ptr<osgHelper::ResourceManager> pooledManager = new osgHelper::ResourceManager(injector);
+  pooledManager->setNumLoaderThreads(4);
+
+  std::vector<std::future<std::string>> futures;
+  for (const auto& filename : filenames)
+  {
+    futures.push_back(pooledManager->loadTextAsync(filename));
+  }
+
+  for (auto i = 0U; i < futures.size(); i++)
+  {
+    EXPECT_EQ(futures[i].get(), serialManager->loadText(filenames[i]));
+  }
+
+  EXPECT_EQ(serialManager->getLoadStatistics().numLoads, static_cast<unsigned long long>(numFiles));
+  EXPECT_EQ(pooledManager->getLoadStatistics().numLoads, static_cast<unsigned long long>(numFiles));
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResourceManagerTest, PendingLoadsCompleteOnDestruction)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_destruction";
+  const auto filenames = createTextFiles(directory, 16, 1024);
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  std::vector<std::future<std::string>> futures;
+  {
+    osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+    manager->setNumLoaderThreads(1);
+
+    for (const auto& filename : filenames)
+    {
+      futures.push_back(manager->loadTextAsync(filename));
+    }
+  }
+
+  for (auto& future : futures)
+  {
+    EXPECT_EQ(future.get().size(), 1024U);
+  }
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResourceManagerTest, LoadStatisticsAndTrace)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_statistics";
+  const auto filenames = createTextFiles(directory, 3, 1000);
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setLoadTracingEnabled(true);
+
+  for (auto i = 0; i < 2; i++)
+  {
+    for (const auto& filename : filenames)
+    {
+      manager->loadText(filename);
+    }
+  }
+
+  EXPECT_THROW(manager->loadText((directory / "missing.txt").string()), std::exception);
+
+  const auto statistics = manager->getLoadStatistics();
+  EXPECT_EQ(statistics.numLoads, 3U);
+  EXPECT_EQ(statistics.numFailedLoads, 1U);
+  EXPECT_EQ(statistics.numBytesRead, 3000U);
+  EXPECT_EQ(statistics.cache.numHits, 3U);
+  EXPECT_EQ(statistics.cache.numLookups, 7U);
+  EXPECT_NEAR(statistics.cache.getHitRatio(), 3.0 / 7.0, 1e-9);
+  EXPECT_TRUE(statistics.numLoadsPerReaderWriter.empty());
+
+  const auto events = manager->getLoadTrace()->getEvents();
+  ASSERT_EQ(events.size(), 3U);
+  EXPECT_EQ(events[0].resourceKey, filenames[0]);
+  EXPECT_EQ(events[0].type, "text");
+  EXPECT_EQ(events[0].numBytes, 1000U);
+  EXPECT_EQ(events[0].threadId, std::this_thread::get_id());
+
+  std::ostringstream trace;
+  manager->getLoadTrace()->writeChromeTrace(trace);
+
+  const auto json = trace.str();
+  EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0U);
+  EXPECT_NE(json.find("\"cat\":\"read\""), std::string::npos);
+  EXPECT_NE(json.find("\"cat\":\"decode\""), std::string::npos);
+  EXPECT_NE(json.find("\"bytes\":1000"), std::string::npos);
+
+  manager->resetLoadStatistics();
+  EXPECT_EQ(manager->getLoadStatistics().numLoads, 0U);
+  EXPECT_EQ(manager->getLoadStatistics().cache.numLookups, 0U);
+
+  std::filesystem::remove_all(directory);
+}
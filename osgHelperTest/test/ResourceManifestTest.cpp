@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/GameException.h>
+#include <osgHelper/ResourceManager.h>
+#include <osgHelper/ResourceManifest.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+class MemoryResourceLoader : public osgHelper::IResourceLoader
+{
+public:
+  void getResourceStream(const std::string&, std::ifstream&, long long&) override
+  {
+    throw osgHelper::GameException("Not supported");
+  }
+
+  osg::ref_ptr<osgHelper::ResourceData> getResourceData(const std::string& resourceKey) override
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    loadOrder.push_back(resourceKey);
+
+    if (resourceKey == blockingKey)
+    {
+      released.wait(lock, [this]() { return !isBlocking; });
+    }
+
+    const auto it = resources.find(resourceKey);
+    if (it == resources.end())
+    {
+      throw osgHelper::GameException("Could not find resource '" + resourceKey + "'");
+    }
+
+    osg::ref_ptr<osgHelper::ResourceBuffer> buffer = new osgHelper::ResourceBuffer(it->second.size());
+    std::copy(it->second.begin(), it->second.end(), buffer->getBuffer());
+
+    return buffer;
+  }
+
+  void release()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      isBlocking = false;
+    }
+
+    released.notify_all();
+  }
+
+  std::map<std::string, std::string> resources;
+  std::vector<std::string>           loadOrder;
+  std::string                        blockingKey;
+  bool                               isBlocking = true;
+
+  std::mutex              mutex;
+  std::condition_variable released;
+
+};
+
+}
+
+TEST(ResourceManifestTest, ReadAndWrite)
+{
+  osgHelper::ResourceManifest manifest;
+  EXPECT_TRUE(manifest.add("shaders/Default.vert", osgHelper::ResourceManager::ResourceType::Shader,
+                           osg::Shader::VERTEX, 10));
+  EXPECT_TRUE(manifest.add("textures/grass tile.png", osgHelper::ResourceManager::ResourceType::Detect));
+  EXPECT_TRUE(manifest.add("data/terrain.bin", osgHelper::ResourceManager::ResourceType::Binary, osg::Shader::FRAGMENT,
+                           -5));
+  EXPECT_FALSE(manifest.add("SHADERS/default.vert", osgHelper::ResourceManager::ResourceType::Text));
+
+  std::stringstream stream;
+  manifest.write(stream);
+
+  osgHelper::ResourceManifest readManifest;
+  std::istringstream          input("# comment\n\n" + stream.str());
+  readManifest.read(input);
+
+  ASSERT_EQ(readManifest.getNumEntries(), 3U);
+
+  const auto& entries = readManifest.getEntries();
+  EXPECT_EQ(entries[0].resourceKey, "shaders/Default.vert");
+  EXPECT_EQ(entries[0].type, osgHelper::ResourceManager::ResourceType::Shader);
+  EXPECT_EQ(entries[0].shaderType, osg::Shader::VERTEX);
+  EXPECT_EQ(entries[0].priority, 10);
+  EXPECT_EQ(entries[1].resourceKey, "textures/grass tile.png");
+  EXPECT_EQ(entries[1].type, osgHelper::ResourceManager::ResourceType::Detect);
+  EXPECT_EQ(entries[2].type, osgHelper::ResourceManager::ResourceType::Binary);
+  EXPECT_EQ(entries[2].priority, -5);
+
+  std::istringstream invalid("1 unknown key\n");
+  EXPECT_THROW(readManifest.read(invalid), std::exception);
+
+  std::istringstream missingKey("1 text\n");
+  EXPECT_THROW(readManifest.read(missingKey), std::exception);
+}
+
+TEST(ResourceManifestTest, PrefetchByPriority)
+{
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<MemoryResourceLoader> loader = new MemoryResourceLoader();
+  loader->blockingKey = "blocking";
+  loader->resources["blocking"] = "b";
+
+  osgHelper::ResourceManifest manifest;
+  for (auto i = 0; i < 20; i++)
+  {
+    const auto key = "resource" + std::to_string(i);
+    loader->resources[key] = std::to_string(i);
+
+    manifest.add(key, osgHelper::ResourceManager::ResourceType::Text, osg::Shader::FRAGMENT, i % 5);
+  }
+
+  manifest.add("missing", osgHelper::ResourceManager::ResourceType::Text);
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setResourceLoader(loader);
+  manager->setNumLoaderThreads(1);
+
+  // occupy the only loader thread until everything is queued
+  auto blocking = manager->loadTextAsync("blocking");
+  auto prefetched = manager->prefetch(manifest);
+
+  auto requested = manager->loadTextAsync("resource0");
+
+  loader->release();
+  prefetched.get();
+
+  EXPECT_EQ(requested.get(), "0");
+  EXPECT_EQ(blocking.get(), "b");
+
+  // the request raises the priority of the queued prefetch, which is still loaded only once
+  ASSERT_EQ(loader->loadOrder.size(), 22U);
+  EXPECT_EQ(loader->loadOrder[0], "blocking");
+  EXPECT_EQ(loader->loadOrder[1], "resource0");
+  EXPECT_EQ(loader->loadOrder[2], "resource4");
+  EXPECT_EQ(loader->loadOrder[3], "resource9");
+  EXPECT_EQ(loader->loadOrder[20], "resource15");
+  EXPECT_EQ(loader->loadOrder[21], "missing");
+
+  const auto numLoads = loader->loadOrder.size();
+  EXPECT_EQ(manager->loadText("resource7"), "7");
+  EXPECT_EQ(loader->loadOrder.size(), numLoads);
+}
+
+TEST(ResourceManifestTest, RecordsRequestedResources)
+{
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<MemoryResourceLoader> loader = new MemoryResourceLoader();
+  loader->isBlocking = false;
+  loader->resources["a.txt"] = "a";
+  loader->resources["b.bin"] = "b";
+  loader->resources["c.frag"] = "c";
+
+  osg::ref_ptr<osgHelper::ResourceManager> manager = new osgHelper::ResourceManager(injector);
+  manager->setResourceLoader(loader);
+
+  manager->loadText("a.txt");
+  manager->setManifestRecordingEnabled(true);
+
+  manager->loadBinary("b.bin");
+  manager->loadShaderAsync("c.frag", osg::Shader::FRAGMENT).get();
+  manager->loadBinary("B.bin");
+
+  manager->setManifestRecordingEnabled(false);
+  manager->loadText("a.txt");
+
+  const auto manifest = manager->getRecordedManifest();
+  ASSERT_EQ(manifest->getNumEntries(), 2U);
+  EXPECT_EQ(manifest->getEntries()[0].resourceKey, "b.bin");
+  EXPECT_EQ(manifest->getEntries()[0].type, osgHelper::ResourceManager::ResourceType::Binary);
+  EXPECT_EQ(manifest->getEntries()[1].resourceKey, "c.frag");
+  EXPECT_EQ(manifest->getEntries()[1].type, osgHelper::ResourceManager::ResourceType::Shader);
+
+  // prefetching the recorded manifest on the next start loads everything up front
+  osg::ref_ptr<osgHelper::ResourceManager> nextManager = new osgHelper::ResourceManager(injector);
+  nextManager->setResourceLoader(loader);
+  nextManager->setManifestRecordingEnabled(true);
+  nextManager->prefetch(*manifest).get();
+
+  // the prefetched resources are only recorded again once they are requested
+  EXPECT_EQ(nextManager->getRecordedManifest()->getNumEntries(), 0U);
+
+  const auto numLoads = loader->loadOrder.size();
+  nextManager->loadBinary("b.bin");
+  nextManager->loadShader("c.frag", osg::Shader::FRAGMENT);
+  EXPECT_EQ(loader->loadOrder.size(), numLoads);
+  EXPECT_EQ(nextManager->getRecordedManifest()->getNumEntries(), 2U);
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/ShaderBlueprint.h>
+#include <osgHelper/ShaderFactory.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::vector<std::string> createModules(int numModules, int moduleSize)
+{
+  std::vector<std::string> modules;
+  for (auto i = 0; i < numModules; i++)
+  {
+    std::string module = "// module " + std::to_string(i) + "\n";
+    while (static_cast<int>(module.size()) < moduleSize)
+    {
+      module += "vec4 function" + std::to_string(module.size()) + "(vec4 v) { return v * 0.5; }\n";
+    }
+
+    modules.push_back(module);
+  }
+
+  return modules;
+}
+
+osg::ref_ptr<osg::Shader> buildVariant(const osg::ref_ptr<osgHelper::IShaderBlueprint>& blueprint,
+                                       const std::vector<std::string>& modules, int variant)
+{
+  blueprint->version(330)->type(osg::Shader::FRAGMENT)->extension("GL_ARB_explicit_attrib_location");
+  blueprint->define("NUM_LIGHTS", std::to_string(variant % 10));
+
+  if ((variant / 10) % 2 == 0)
+  {
+    blueprint->define("USE_SHADOWS");
+  }
+
+  if ((variant / 20) % 5 != 0)
+  {
+    blueprint->define("QUALITY", std::to_string((variant / 20) % 5));
+  }
+
+  for (const auto& module : modules)
+  {
+    blueprint->module(module);
+  }
+
+  return blueprint->build();
+}
+
+}
+
+TEST(ShaderBlueprintTest, InjectsDefines)
+{
+  osg::ref_ptr<osgHelper::ShaderBlueprint> blueprint = new osgHelper::ShaderBlueprint();
+  blueprint->version(330)->extension("GL_ARB_gpu_shader5")->define("B", "2")->define("A")->module("void main() {}");
+
+  const auto shader = blueprint->build();
+  ASSERT_TRUE(shader.valid());
+  EXPECT_EQ(shader->getType(), osg::Shader::FRAGMENT);
+  EXPECT_EQ(shader->getShaderSource(),
+            "#version 330\n#extension GL_ARB_gpu_shader5 : enable\n#define A\n#define B 2\nvoid main() {}\n");
+}
+
+TEST(ShaderBlueprintTest, SharesIdenticalPermutations)
+{
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector injector(container);
+
+  osg::ref_ptr<osgHelper::ShaderFactory> factory = new osgHelper::ShaderFactory(injector);
+
+  // sharing is opt-in
+  EXPECT_FALSE(factory->getPermutationCache().valid());
+  EXPECT_NE(factory->make()->module("void main() {}")->build(), factory->make()->module("void main() {}")->build());
+
+  factory->setPermutationCache(new osgHelper::ShaderPermutationCache());
+
+  const auto build = [&factory](const std::string& defineOrder, osg::Shader::Type type)
+  {
+    auto blueprint = factory->make();
+    blueprint->type(type)->module("void main() {}");
+
+    for (const auto name : defineOrder)
+    {
+      blueprint->define(std::string(1, name), "1");
+    }
+
+    return blueprint->build();
+  };
+
+  const auto shader = build("AB", osg::Shader::VERTEX);
+  EXPECT_EQ(build("AB", osg::Shader::VERTEX), shader);
+  EXPECT_EQ(build("BA", osg::Shader::VERTEX), shader);
+  EXPECT_NE(build("AB", osg::Shader::FRAGMENT), shader);
+  EXPECT_NE(build("A", osg::Shader::VERTEX), shader);
+
+  const auto statistics = factory->getPermutationCache()->getStatistics();
+  EXPECT_EQ(statistics.numLookups, 5U);
+  EXPECT_EQ(statistics.numHits, 2U);
+  EXPECT_EQ(statistics.numShaders, 3U);
+}
+
+TEST(ShaderBlueprintTest, BuildVariants)
+{
+  const auto numBuilds   = 1000;
+  const auto numVariants = 100;
+  const auto modules     = createModules(8, 4096);
+
+  osg::ref_ptr<osgHelper::ShaderPermutationCache> cache = new osgHelper::ShaderPermutationCache();
+
+  std::vector<osg::ref_ptr<osg::Shader>> uncachedShaders;
+  std::vector<osg::ref_ptr<osg::Shader>> cachedShaders;
+
+  for (auto i = 0; i < numBuilds; i++)
+  {
+    uncachedShaders.push_back(buildVariant(new osgHelper::ShaderBlueprint(), modules, i % numVariants));
+    cachedShaders.push_back(buildVariant(new osgHelper::ShaderBlueprint(cache), modules, i % numVariants));
+  }
+
+  for (auto i = 0; i < numBuilds; i++)
+  {
+    EXPECT_EQ(cachedShaders[i]->getShaderSource(), uncachedShaders[i]->getShaderSource());
+    EXPECT_EQ(cachedShaders[i], cachedShaders[i % numVariants]);
+  }
+
+  const auto statistics = cache->getStatistics();
+  EXPECT_EQ(statistics.numLookups, static_cast<unsigned long long>(numBuilds));
+  EXPECT_EQ(statistics.numHits, static_cast<unsigned long long>(numBuilds - numVariants));
+  EXPECT_EQ(statistics.numShaders, static_cast<std::size_t>(numVariants));
+}
+
+TEST(ShaderBlueprintTest, EvictsShaders)
+{
+  const auto modules = createModules(1, 64);
+
+  osg::ref_ptr<osgHelper::ShaderPermutationCache> cache = new osgHelper::ShaderPermutationCache(4);
+  EXPECT_EQ(cache->getMaxNumShaders(), 4U);
+
+  // shaders that are no longer used are evicted first
+  std::vector<osg::ref_ptr<osg::Shader>> shaders;
+  for (auto i = 0; i < 4; i++)
+  {
+    shaders.push_back(buildVariant(new osgHelper::ShaderBlueprint(cache), modules, i));
+  }
+
+  shaders[1] = nullptr;
+  shaders[2] = nullptr;
+
+  shaders.push_back(buildVariant(new osgHelper::ShaderBlueprint(cache), modules, 4));
+  EXPECT_EQ(cache->getStatistics().numShaders, 3U);
+  EXPECT_EQ(cache->getStatistics().numEvictions, 2U);
+  EXPECT_EQ(buildVariant(new osgHelper::ShaderBlueprint(cache), modules, 0), shaders[0]);
+
+  // then the least recently used one, which only stops sharing it
+  shaders.push_back(buildVariant(new osgHelper::ShaderBlueprint(cache), modules, 5));
+  shaders.push_back(buildVariant(new osgHelper::ShaderBlueprint(cache), modules, 6));
+  EXPECT_EQ(cache->getStatistics().numShaders, 4U);
+  EXPECT_EQ(cache->getStatistics().numEvictions, 3U);
+  EXPECT_NE(buildVariant(new osgHelper::ShaderBlueprint(cache), modules, 3), shaders[3]);
+  EXPECT_EQ(buildVariant(new osgHelper::ShaderBlueprint(cache), modules, 0), shaders[0]);
+
+  cache->setMaxNumShaders(1);
+  EXPECT_EQ(cache->getStatistics().numShaders, 1U);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/ShaderFactory.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ShaderFactoryTest, SharesShadersBySource)
+{
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector           injector(container);
+
+  osg::ref_ptr<osgHelper::ShaderFactory> factory = new osgHelper::ShaderFactory(injector);
+
+  const auto shader = factory->fromSourceText("Blur", "void main() {}", osg::Shader::FRAGMENT);
+  EXPECT_EQ(shader->getShaderSource(), "void main() {}");
+  EXPECT_EQ(shader->getType(), osg::Shader::FRAGMENT);
+
+  EXPECT_EQ(factory->fromSourceText("Blur", "void main() {}", osg::Shader::FRAGMENT), shader);
+  EXPECT_EQ(factory->fromSourceText("Copy", "void main() {}", osg::Shader::FRAGMENT), shader);
+  EXPECT_NE(factory->fromSourceText("Vertex", "void main() {}", osg::Shader::VERTEX), shader);
+
+  EXPECT_EQ(factory->getNumShaders(), 2U);
+  EXPECT_EQ(factory->getNumKeyMismatches(), 0U);
+}
+
+TEST(ShaderFactoryTest, DetectsKeyMismatches)
+{
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector           injector(container);
+
+  osg::ref_ptr<osgHelper::ShaderFactory> factory = new osgHelper::ShaderFactory(injector);
+
+  const auto shader = factory->fromSourceText("Blur", "void main() { /* x */ }", osg::Shader::FRAGMENT);
+
+  // the same key for a different source does not return the first shader
+  const auto otherShader = factory->fromSourceText("Blur", "void main() { /* y */ }", osg::Shader::FRAGMENT);
+  EXPECT_NE(otherShader, shader);
+  EXPECT_EQ(otherShader->getShaderSource(), "void main() { /* y */ }");
+  EXPECT_EQ(factory->getNumKeyMismatches(), 1U);
+
+  // each mismatch is reported once
+  EXPECT_EQ(factory->fromSourceText("Blur", "void main() { /* x */ }", osg::Shader::FRAGMENT), shader);
+  EXPECT_EQ(factory->fromSourceText("Blur", "void main() { /* y */ }", osg::Shader::FRAGMENT), otherShader);
+  EXPECT_EQ(factory->getNumKeyMismatches(), 1U);
+
+  factory->fromSourceText("Blur", "void main() { /* x */ }", osg::Shader::VERTEX);
+  EXPECT_EQ(factory->getNumKeyMismatches(), 2U);
+}
+
+TEST(ShaderFactoryTest, CreatesShadersConcurrently)
+{
+  const auto numThreads = 8;
+  const auto numSources = 50;
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector           injector(container);
+
+  osg::ref_ptr<osgHelper::ShaderFactory> factory = new osgHelper::ShaderFactory(injector);
+
+  std::vector<std::vector<osg::ref_ptr<osg::Shader>>> shaders(numThreads);
+  std::vector<std::thread>                            threads;
+
+  for (auto i = 0; i < numThreads; i++)
+  {
+    threads.emplace_back([&factory, &shaders, i]()
+    {
+      for (auto j = 0; j < numSources; j++)
+      {
+        const auto index = (i + j) % numSources;
+        shaders[i].push_back(factory->fromSourceText("Shader" + std::to_string(index),
+                                                     "// " + std::to_string(index) + "\nvoid main() {}",
+                                                     osg::Shader::FRAGMENT));
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (auto i = 1; i < numThreads; i++)
+  {
+    for (auto j = 0; j < numSources; j++)
+    {
+      EXPECT_EQ(shaders[i][(numSources + j - i) % numSources], shaders[0][j]);
+    }
+  }
+
+  EXPECT_EQ(factory->getNumShaders(), static_cast<std::size_t>(numSources));
+  EXPECT_EQ(factory->getNumKeyMismatches(), 0U);
+}
+
+TEST(ShaderFactoryTest, LoadsShadersFromDirectory)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "osgHelperTest_shaderDirectory";
+  std::filesystem::create_directories(directory);
+
+  {
+    std::ofstream stream(directory / osgHelper::ShaderFactory::getShaderFilename("Blur", osg::Shader::FRAGMENT));
+    stream << osgHelper::ShaderFactory::getSourceStamp("void main() {}") << "void main(){}";
+  }
+
+  {
+    std::ofstream stream(directory / osgHelper::ShaderFactory::getShaderFilename("Copy", osg::Shader::FRAGMENT));
+    stream << osgHelper::ShaderFactory::getSourceStamp("void main() { }") << "void main(){}";
+  }
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector           injector(container);
+
+  osg::ref_ptr<osgHelper::ShaderFactory> factory = new osgHelper::ShaderFactory(injector);
+  factory->setShaderDirectory(directory.string());
+
+  EXPECT_EQ(osgHelper::ShaderFactory::getShaderFilename("Blur", osg::Shader::FRAGMENT), "Blur.frag");
+  EXPECT_EQ(factory->fromSourceText("Blur", "void main() {}", osg::Shader::FRAGMENT)->getShaderSource(),
+            "void main(){}");
+
+  // the file is read once
+  std::filesystem::remove(directory / "Blur.frag");
+  EXPECT_EQ(factory->fromSourceText("Blur", "void main() {}", osg::Shader::FRAGMENT)->getShaderSource(),
+            "void main(){}");
+
+  // shaders without a file or with a file of another source use the passed source
+  EXPECT_EQ(factory->fromSourceText("Blur", "void main() {}", osg::Shader::VERTEX)->getShaderSource(),
+            "void main() {}");
+  EXPECT_EQ(factory->fromSourceText("Copy", "void main() {}", osg::Shader::FRAGMENT)->getShaderSource(),
+            "void main() {}");
+  EXPECT_EQ(factory->fromSourceText("Blur", "void main() {  }", osg::Shader::FRAGMENT)->getShaderSource(),
+            "void main() {  }");
+
+  std::filesystem::remove_all(directory);
+}
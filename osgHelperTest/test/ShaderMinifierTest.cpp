@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/ShaderMinifier.h>
+#include <osgHelper/ppu/Shaders.h>
+
+#include <string>
+
+TEST(ShaderMinifierTest, RemovesCommentsAndWhitespace)
+{
+  const std::string source = "#version 120\n"
+                             "// lighting\n"
+                             "uniform   sampler2D  tex; /* the input */\n"
+                             "\n"
+                             "void main(void)\n"
+                             "{\n"
+                             "\tvec4 color = texture2D(tex, gl_TexCoord[0].st) * 0.5;\n"
+                             "\tfloat x = 1.0 - -color.r;\n"
+                             "\tx = x + +1.0;\n"
+                             "\tgl_FragColor = color / x;\n"
+                             "}\n";
+
+  EXPECT_EQ(osgHelper::ShaderMinifier::minify(source),
+            "#version 120\n"
+            "uniform sampler2D tex;void main(void){vec4 color=texture2D(tex,gl_TexCoord[0].st)*0.5;"
+            "float x=1.0- -color.r;x=x+ +1.0;gl_FragColor=color/x;}");
+}
+
+TEST(ShaderMinifierTest, KeepsDirectivesOnTheirOwnLines)
+{
+  const std::string source = "float a;\n"
+                             "  #define   F(x)   (x * 2.0)   // doubles\n"
+                             "#define G (x)\n"
+                             "#define LONG 1 + \\\n"
+                             "             2\n"
+                             "/* spans\n"
+                             "   lines */ #ifdef LONG\n"
+                             "float b = F(1.0);\n"
+                             "#endif";
+
+  EXPECT_EQ(osgHelper::ShaderMinifier::minify(source),
+            "float a;\n"
+            "#define F(x) (x * 2.0)\n"
+            "#define G (x)\n"
+            "#define LONG 1 + 2\n"
+            "#ifdef LONG\n"
+            "float b=F(1.0);\n"
+            "#endif\n");
+}
+
+TEST(ShaderMinifierTest, ShrinksEffectShaders)
+{
+  for (const auto& shader : osgHelper::ppu::Shaders::getAll())
+  {
+    const auto minified = osgHelper::ShaderMinifier::minify(*shader.source);
+
+    EXPECT_LE(minified.size(), shader.source->size()) << shader.name;
+    EXPECT_EQ(osgHelper::ShaderMinifier::minify(minified), minified) << shader.name;
+  }
+}
@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/FileResourceLoader.h>
+#include <osgHelper/GameException.h>
+#include <osgHelper/ResourceManager.h>
+#include <osgHelper/ShaderFactory.h>
+#include <osgHelper/ShaderPreprocessor.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace
+{
+
+class ShaderPreprocessorTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = std::filesystem::temp_directory_path() / "osgHelperTest_shaderIncludes";
+    std::filesystem::create_directories(m_directory);
+
+    m_resourceManager = new osgHelper::ResourceManager(m_injector);
+    m_resourceManager->setResourceLoader(new osgHelper::FileResourceLoader());
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(m_directory);
+  }
+
+  std::string writeInclude(const std::string& name, const std::string& text)
+  {
+    const auto filename = (m_directory / name).string();
+
+    std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+    stream << text;
+
+    return filename;
+  }
+
+  static std::string include(const std::string& filename)
+  {
+    return "#include \"" + filename + "\"";
+  }
+
+  osgHelper::ioc::InjectionContainer       m_container;
+  osgHelper::ioc::Injector                 m_injector{ m_container };
+  osg::ref_ptr<osgHelper::ResourceManager> m_resourceManager;
+  std::filesystem::path                    m_directory;
+
+};
+
+}
+
+TEST_F(ShaderPreprocessorTest, IncludesFilesOnce)
+{
+  const auto common   = writeInclude("common.glsl", "#pragma once\nconst float PI = 3.14159;\n");
+  const auto lighting = writeInclude("lighting.glsl", include(common) + "\nvec3 light() { return vec3(PI); }\n");
+  const auto shadows  = writeInclude("shadows.glsl", include(common) + "\nfloat shadow() { return PI; }\n");
+
+  osg::ref_ptr<osgHelper::ShaderPreprocessor> preprocessor = new osgHelper::ShaderPreprocessor(m_resourceManager);
+  preprocessor->setLineDirectivesEnabled(false);
+
+  EXPECT_EQ(preprocessor->process(include(lighting) + "\n" + include(shadows) + "\n" + include(lighting) +
+                                  "\nvoid main() {}"),
+            "const float PI = 3.14159;\n"
+            "vec3 light() { return vec3(PI); }\n"
+            "float shadow() { return PI; }\n"
+            "void main() {}");
+
+  EXPECT_EQ(preprocessor->getStatistics().numParsedFiles, 3U);
+}
+
+TEST_F(ShaderPreprocessorTest, StripsResolvedConditionals)
+{
+  const auto guarded = writeInclude("guarded.glsl", "#ifndef GUARDED_GLSL\n"
+                                                    "#define GUARDED_GLSL\n"
+                                                    "float guarded() { return 1.0; }\n"
+                                                    "#endif\n");
+
+  const std::string source = include(guarded) + "\n" +
+                             "#ifdef USE_SHADOWS\n"
+                             "  float shadows = 1.0;\n"
+                             "#else\n"
+                             "  float shadows = 0.0;\n"
+                             "#endif\n"
+                             "#ifndef QUALITY\n"
+                             "  #define QUALITY 1\n"
+                             "#endif\n"
+                             "#ifdef QUALITY\n"
+                             "  float quality = float(QUALITY);\n"
+                             "#endif\n"
+                             "#ifdef GL_ARB_gpu_shader5\n"
+                             "  float fma5 = 1.0;\n"
+                             "#endif\n"
+                             "#ifdef UNUSED\n"
+                             "  float unused = 1.0;\n"
+                             "#elif NUM_LIGHTS > 2\n"
+                             "  float manyLights = 1.0;\n"
+                             "#endif\n"
+                             "#if __VERSION__ >= 130\n"
+                             "  #define MODERN\n"
+                             "#endif\n"
+                             "#ifdef MODERN\n"
+                             "  float modern = 1.0;\n"
+                             "#endif";
+
+  osg::ref_ptr<osgHelper::ShaderPreprocessor> preprocessor = new osgHelper::ShaderPreprocessor(m_resourceManager);
+  preprocessor->setLineDirectivesEnabled(false);
+
+  EXPECT_EQ(preprocessor->process(source, { { "USE_SHADOWS", "" } }),
+            "#define GUARDED_GLSL\n"
+            "float guarded() { return 1.0; }\n"
+            "  float shadows = 1.0;\n"
+            "  #define QUALITY 1\n"
+            "  float quality = float(QUALITY);\n"
+            "#ifdef GL_ARB_gpu_shader5\n"
+            "  float fma5 = 1.0;\n"
+            "#endif\n"
+            "#if NUM_LIGHTS > 2\n"
+            "  float manyLights = 1.0;\n"
+            "#endif\n"
+            "#if __VERSION__ >= 130\n"
+            "  #define MODERN\n"
+            "#endif\n"
+            "#ifdef MODERN\n"
+            "  float modern = 1.0;\n"
+            "#endif");
+
+  EXPECT_EQ(preprocessor->process(source, { { "QUALITY", "3" }, { "UNUSED", "" } }),
+            "#define GUARDED_GLSL\n"
+            "float guarded() { return 1.0; }\n"
+            "  float shadows = 0.0;\n"
+            "  float quality = float(QUALITY);\n"
+            "#ifdef GL_ARB_gpu_shader5\n"
+            "  float fma5 = 1.0;\n"
+            "#endif\n"
+            "  float unused = 1.0;\n"
+            "#if __VERSION__ >= 130\n"
+            "  #define MODERN\n"
+            "#endif\n"
+            "#ifdef MODERN\n"
+            "  float modern = 1.0;\n"
+            "#endif");
+
+  EXPECT_THROW(preprocessor->process("#ifdef A\nfloat a;"), osgHelper::GameException);
+  EXPECT_THROW(preprocessor->process("float a;\n#endif"), osgHelper::GameException);
+}
+
+TEST_F(ShaderPreprocessorTest, InvalidatesOnlyDependents)
+{
+  const auto common   = writeInclude("common.glsl", "const float SCALE = 1.0;\n");
+  const auto lighting = writeInclude("lighting.glsl", include(common) + "\nvec3 light() { return vec3(SCALE); }\n");
+  const auto noise    = writeInclude("noise.glsl", "float noise() { return 0.5; }\n");
+
+  const auto lightingShader = include(lighting) + "\nvoid main() {}";
+  const auto noiseShader    = include(noise) + "\nvoid main() {}";
+
+  osg::ref_ptr<osgHelper::ShaderPreprocessor> preprocessor = new osgHelper::ShaderPreprocessor(m_resourceManager);
+  preprocessor->setLineDirectivesEnabled(false);
+
+  EXPECT_EQ(preprocessor->process(lightingShader),
+            "const float SCALE = 1.0;\nvec3 light() { return vec3(SCALE); }\nvoid main() {}");
+  EXPECT_EQ(preprocessor->process(noiseShader), "float noise() { return 0.5; }\nvoid main() {}");
+  EXPECT_EQ(preprocessor->process(lightingShader, { { "A", "" } }),
+            "const float SCALE = 1.0;\nvec3 light() { return vec3(SCALE); }\nvoid main() {}");
+
+  writeInclude("common.glsl", "const float SCALE = 2.0;\n");
+  preprocessor->invalidate(common);
+
+  EXPECT_EQ(preprocessor->process(noiseShader), "float noise() { return 0.5; }\nvoid main() {}");
+  EXPECT_EQ(preprocessor->process(lightingShader),
+            "const float SCALE = 2.0;\nvec3 light() { return vec3(SCALE); }\nvoid main() {}");
+  EXPECT_EQ(preprocessor->process(lightingShader, { { "A", "" } }),
+            "const float SCALE = 2.0;\nvec3 light() { return vec3(SCALE); }\nvoid main() {}");
+
+  // only common.glsl is parsed again, the expansions of the noise shader are kept
+  const auto statistics = preprocessor->getStatistics();
+  EXPECT_EQ(statistics.numParsedFiles, 4U);
+  EXPECT_EQ(statistics.numExpansions, 5U);
+  EXPECT_EQ(statistics.numCacheHits, 1U);
+}
+
+TEST_F(ShaderPreprocessorTest, ExpandsBlueprintModules)
+{
+  const auto common = writeInclude("common.glsl", "const float PI = 3.14159;\n");
+
+  osg::ref_ptr<osgHelper::ShaderFactory> factory = new osgHelper::ShaderFactory(m_injector);
+  factory->setShaderPreprocessor(new osgHelper::ShaderPreprocessor(m_resourceManager));
+
+  const auto shader = factory->make()
+                        ->version(330)
+                        ->define("USE_PI")
+                        ->module(include(common) + "\nfloat half() { return 0.5; }")
+                        ->module(include(common) + "\n#ifdef USE_PI\nvoid main() { gl_FragColor = vec4(PI); }\n#endif")
+                        ->build();
+
+  // the lines of the modules are counted as one source
+  EXPECT_EQ(shader->getShaderSource(), "#version 330\n"
+                                       "#define USE_PI\n"
+                                       "#line 1 1 // " + common + "\n"
+                                       "const float PI = 3.14159;\n"
+                                       "#line 2 0 // shader source\n"
+                                       "float half() { return 0.5; }\n"
+                                       "#line 5 0 // shader source\n"
+                                       "void main() { gl_FragColor = vec4(PI); }\n");
+}
+
+TEST_F(ShaderPreprocessorTest, InsertsLineDirectives)
+{
+  const auto common = writeInclude("common.glsl", "const float PI = 3.14159;\nconst float TAU = 2.0 * PI;\n");
+
+  const std::string source = "#version 120\n" +
+                             include(common) + "\n"
+                             "#ifdef USE_SHADOWS\n"
+                             "float shadow() { return 1.0; }\n"
+                             "#endif\n"
+                             "void main() {}";
+
+  osg::ref_ptr<osgHelper::ShaderPreprocessor> preprocessor = new osgHelper::ShaderPreprocessor(m_resourceManager);
+
+  // before version 330, #line sets the number of the directive itself
+  EXPECT_EQ(preprocessor->process(source, {}, 120), "#version 120\n"
+                                                    "#line 0 1 // " + common + "\n"
+                                                    "const float PI = 3.14159;\n"
+                                                    "const float TAU = 2.0 * PI;\n"
+                                                    "#line 5 0 // shader source\n"
+                                                    "void main() {}");
+
+  EXPECT_EQ(preprocessor->process(source, { { "USE_SHADOWS", "" } }, 330), "#version 120\n"
+                                                                           "#line 1 1 // " + common + "\n"
+                                                                           "const float PI = 3.14159;\n"
+                                                                           "const float TAU = 2.0 * PI;\n"
+                                                                           "#line 4 0 // shader source\n"
+                                                                           "float shadow() { return 1.0; }\n"
+                                                                           "#line 6 0 // shader source\n"
+                                                                           "void main() {}");
+
+  // a source without changes of lines does not get any
+  EXPECT_EQ(preprocessor->process("#version 330\nvoid main() {}"), "#version 330\nvoid main() {}");
+}
+
+TEST_F(ShaderPreprocessorTest, ExpandsIncludesInEveryUnresolvedBranch)
+{
+  const auto common = writeInclude("common.glsl", "const float PI = 3.14159;\n");
+  const auto modern = writeInclude("modern.glsl", include(common) + "\nout vec4 color;\n");
+  const auto legacy = writeInclude("legacy.glsl", include(common) + "\n#define color gl_FragColor\n");
+
+  const std::string source = "#if __VERSION__ >= 130\n" +
+                             include(modern) + "\n"
+                             "#else\n" +
+                             include(legacy) + "\n"
+                             "#endif\n" +
+                             include(common) + "\n" +
+                             include(common) + "\n"
+                             "void main() { color = vec4(PI); }";
+
+  osg::ref_ptr<osgHelper::ShaderPreprocessor> preprocessor = new osgHelper::ShaderPreprocessor(m_resourceManager);
+  preprocessor->setLineDirectivesEnabled(false);
+
+  // the GL compiler takes only one of the branches, so the later include is not skipped either
+  EXPECT_EQ(preprocessor->process(source), "#if __VERSION__ >= 130\n"
+                                           "const float PI = 3.14159;\n"
+                                           "out vec4 color;\n"
+                                           "#else\n"
+                                           "const float PI = 3.14159;\n"
+                                           "#define color gl_FragColor\n"
+                                           "#endif\n"
+                                           "const float PI = 3.14159;\n"
+                                           "void main() { color = vec4(PI); }");
+
+  // the expansion depends on all of the files
+  writeInclude("legacy.glsl", "#define color gl_FragData[0]\n");
+  preprocessor->invalidate(legacy);
+
+  EXPECT_EQ(preprocessor->process(source), "#if __VERSION__ >= 130\n"
+                                           "const float PI = 3.14159;\n"
+                                           "out vec4 color;\n"
+                                           "#else\n"
+                                           "#define color gl_FragData[0]\n"
+                                           "#endif\n"
+                                           "const float PI = 3.14159;\n"
+                                           "void main() { color = vec4(PI); }");
+}
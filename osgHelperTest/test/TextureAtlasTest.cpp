@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/GameException.h>
+#include <osgHelper/TextureAtlas.h>
+
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+osg::ref_ptr<osg::Image> createImage(int width, int height, unsigned char value)
+{
+  osg::ref_ptr<osg::Image> image = new osg::Image();
+  image->allocateImage(width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+
+  for (auto t = 0; t < height; t++)
+  {
+    for (auto s = 0; s < width; s++)
+    {
+      const auto pixel = image->data() + t * image->getRowStepInBytes() + s * 4;
+      pixel[0]         = value;
+      pixel[1]         = static_cast<unsigned char>(s);
+      pixel[2]         = static_cast<unsigned char>(t);
+      pixel[3]         = 255;
+    }
+  }
+
+  return image;
+}
+
+const unsigned char* getPixel(const osg::ref_ptr<osg::Image>& image, int s, int t)
+{
+  return image->data() + t * image->getRowStepInBytes() + s * 4;
+}
+
+bool overlap(const osgHelper::TextureAtlas::Region& a, const osgHelper::TextureAtlas::Region& b, int border)
+{
+  return (a.page == b.page) && (a.x - border < b.x + b.width + border) && (b.x - border < a.x + a.width + border) &&
+         (a.y - border < b.y + b.height + border) && (b.y - border < a.y + a.height + border);
+}
+
+}
+
+TEST(TextureAtlasTest, CopiesImagesWithBorders)
+{
+  osg::ref_ptr<osgHelper::TextureAtlas> atlas = new osgHelper::TextureAtlas(64, 1);
+
+  const auto a = atlas->insert(createImage(10, 6, 100));
+  const auto b = atlas->insert(createImage(7, 12, 200));
+
+  EXPECT_NE(a.id, b.id);
+  EXPECT_EQ(atlas->getNumPages(), 1U);
+  EXPECT_FALSE(overlap(a, b, 1));
+
+  EXPECT_EQ(a.width, 10);
+  EXPECT_EQ(a.height, 6);
+  EXPECT_FLOAT_EQ(a.uvMin.x(), a.x / 64.0f);
+  EXPECT_FLOAT_EQ(a.uvMin.y(), a.y / 64.0f);
+  EXPECT_FLOAT_EQ(a.uvMax.x(), (a.x + 10) / 64.0f);
+  EXPECT_FLOAT_EQ(a.uvMax.y(), (a.y + 6) / 64.0f);
+
+  const auto page = atlas->getPageImage(0);
+  ASSERT_TRUE(page.valid());
+  EXPECT_EQ(atlas->getPageTexture(0)->getImage(), page.get());
+  EXPECT_FALSE(atlas->getPageTexture(1).valid());
+
+  for (const auto& region : { a, b })
+  {
+    const auto value = (region.id == a.id) ? 100 : 200;
+
+    for (auto t = -1; t <= region.height; t++)
+    {
+      for (auto s = -1; s <= region.width; s++)
+      {
+        // the border repeats the edge pixels
+        const auto pixel = getPixel(page, region.x + s, region.y + t);
+        EXPECT_EQ(pixel[0], value);
+        EXPECT_EQ(pixel[1], std::min(std::max(s, 0), region.width - 1));
+        EXPECT_EQ(pixel[2], std::min(std::max(t, 0), region.height - 1));
+      }
+    }
+  }
+
+  osgHelper::TextureAtlas::Region region;
+  EXPECT_TRUE(atlas->getRegion(b.id, region));
+  EXPECT_EQ(region.x, b.x);
+  EXPECT_FALSE(atlas->getRegion(osgHelper::TextureAtlas::InvalidRegionId, region));
+}
+
+TEST(TextureAtlasTest, ReusesRemovedRegions)
+{
+  osg::ref_ptr<osgHelper::TextureAtlas> atlas = new osgHelper::TextureAtlas(64, 0);
+
+  std::vector<osgHelper::TextureAtlas::Region> regions;
+  for (auto i = 0; i < 16; i++)
+  {
+    regions.push_back(atlas->insert(createImage(16, 16, 1)));
+  }
+
+  EXPECT_EQ(atlas->getNumPages(), 1U);
+  EXPECT_FLOAT_EQ(atlas->getStatistics().efficiency, 1.0f);
+
+  // removing a 2x2 block of regions makes room for an image of that size
+  std::vector<osgHelper::TextureAtlas::Region> removed;
+  for (const auto& region : regions)
+  {
+    if ((region.x < 32) && (region.y < 32))
+    {
+      EXPECT_TRUE(atlas->remove(region.id));
+      removed.push_back(region);
+    }
+  }
+
+  ASSERT_EQ(removed.size(), 4U);
+  EXPECT_FALSE(atlas->remove(removed[0].id));
+
+  const auto large = atlas->insert(createImage(32, 32, 2));
+  EXPECT_EQ(large.page, 0U);
+  EXPECT_EQ(large.x, 0);
+  EXPECT_EQ(large.y, 0);
+  EXPECT_EQ(atlas->getNumPages(), 1U);
+
+  // a page without regions is reset completely
+  for (const auto& region : regions)
+  {
+    atlas->remove(region.id);
+  }
+
+  atlas->remove(large.id);
+
+  EXPECT_EQ(atlas->getStatistics().numRegions, 0U);
+  EXPECT_EQ(atlas->insert(createImage(64, 64, 3)).page, 0U);
+  EXPECT_EQ(atlas->getNumPages(), 1U);
+}
+
+TEST(TextureAtlasTest, PacksEfficiently)
+{
+  osg::ref_ptr<osgHelper::TextureAtlas> atlas = new osgHelper::TextureAtlas(256, 1);
+
+  std::srand(42);
+
+  // fills the first page until an image does not fit anymore
+  std::vector<osgHelper::TextureAtlas::Region> regions;
+  while (atlas->getNumPages() < 2)
+  {
+    regions.push_back(atlas->insert(createImage(8 + std::rand() % 24, 8 + std::rand() % 24, 1)));
+  }
+
+  for (std::size_t i = 0; i < regions.size(); i++)
+  {
+    EXPECT_GE(regions[i].x, 1);
+    EXPECT_GE(regions[i].y, 1);
+    EXPECT_LE(regions[i].x + regions[i].width, 255);
+    EXPECT_LE(regions[i].y + regions[i].height, 255);
+
+    for (auto j = i + 1; j < regions.size(); j++)
+    {
+      EXPECT_FALSE(overlap(regions[i], regions[j], 1)) << i << " " << j;
+    }
+  }
+
+  const auto& last       = regions.back();
+  const auto  statistics = atlas->getStatistics();
+
+  EXPECT_EQ(last.page, 1U);
+  EXPECT_EQ(statistics.numRegions, regions.size());
+  EXPECT_EQ(statistics.totalPixels, 2 * 256ULL * 256ULL);
+
+  const auto firstPageEfficiency =
+    static_cast<float>(statistics.usedPixels - last.width * last.height) / (256.0f * 256.0f);
+  EXPECT_GT(firstPageEfficiency, 0.7f);
+  EXPECT_FLOAT_EQ(statistics.efficiency, static_cast<float>(statistics.usedPixels) / statistics.totalPixels);
+}
+
+TEST(TextureAtlasTest, RejectsUnsupportedImages)
+{
+  osg::ref_ptr<osgHelper::TextureAtlas> atlas = new osgHelper::TextureAtlas(32, 1);
+
+  EXPECT_THROW(atlas->insert(createImage(31, 8, 1)), osgHelper::GameException);
+  EXPECT_THROW(atlas->insert(nullptr), osgHelper::GameException);
+
+  osg::ref_ptr<osg::Image> floatImage = new osg::Image();
+  floatImage->allocateImage(4, 4, 1, GL_RGBA, GL_FLOAT);
+  EXPECT_THROW(atlas->insert(floatImage), osgHelper::GameException);
+
+  EXPECT_EQ(atlas->getNumPages(), 0U);
+  EXPECT_THROW(osgHelper::TextureAtlas(8, 4), osgHelper::GameException);
+}
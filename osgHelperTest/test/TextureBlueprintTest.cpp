@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/TextureBlueprint.h>
+#include <osgHelper/TextureFactory.h>
+#include <osgHelper/ioc/InjectionContainer.h>
+#include <osgHelper/ioc/Injector.h>
+
+#include <set>
+#include <vector>
+
+namespace
+{
+
+osg::ref_ptr<osg::Image> createImage()
+{
+  osg::ref_ptr<osg::Image> image = new osg::Image();
+  image->allocateImage(4, 4, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+
+  return image;
+}
+
+}
+
+TEST(TextureBlueprintTest, SharesTexturesAndUniforms)
+{
+  const auto numBuilds = 1000;
+
+  osgHelper::ioc::InjectionContainer container;
+  osgHelper::ioc::Injector           injector(container);
+
+  osg::ref_ptr<osgHelper::TextureFactory> factory = new osgHelper::TextureFactory(injector);
+
+  const auto image = createImage();
+
+  // sharing is opt-in
+  EXPECT_FALSE(factory->getTextureCache().valid());
+  EXPECT_NE(factory->make()->image(image)->build(), factory->make()->image(image)->build());
+
+  factory->setTextureCache(new osgHelper::TextureCache());
+
+  std::vector<osg::ref_ptr<osg::StateSet>> stateSets;
+  std::set<osg::Texture2D*>                textures;
+  std::set<osg::StateAttribute*>           assignedTextures;
+  std::set<osg::Uniform*>                  uniforms;
+
+  for (auto i = 0; i < numBuilds; i++)
+  {
+    osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet();
+    stateSets.push_back(stateSet);
+
+    textures.insert(factory->make()->image(image)->texLayer(2)->assign(stateSet)->uniform(stateSet, "tex")->build());
+
+    assignedTextures.insert(stateSet->getTextureAttribute(2, osg::StateAttribute::TEXTURE));
+    uniforms.insert(stateSet->getUniform("tex"));
+  }
+
+  EXPECT_EQ(textures.size(), 1U);
+  EXPECT_EQ(assignedTextures, std::set<osg::StateAttribute*>(textures.begin(), textures.end()));
+  EXPECT_EQ(uniforms.size(), 1U);
+  EXPECT_NE(*uniforms.begin(), nullptr);
+
+  const auto statistics = factory->getTextureCache()->getStatistics();
+  EXPECT_EQ(statistics.numTextures, 1U);
+  EXPECT_EQ(statistics.numUniforms, 1U);
+  EXPECT_EQ(statistics.numTextureLookups, static_cast<unsigned long long>(numBuilds));
+  EXPECT_EQ(statistics.numTextureHits, static_cast<unsigned long long>(numBuilds - 1));
+  EXPECT_EQ(statistics.numUniformHits, static_cast<unsigned long long>(numBuilds - 1));
+}
+
+TEST(TextureBlueprintTest, SeparatesDifferentState)
+{
+  osg::ref_ptr<osgHelper::TextureCache> cache = new osgHelper::TextureCache();
+
+  const auto image      = createImage();
+  const auto otherImage = createImage();
+
+  const auto build = [&cache](const osg::ref_ptr<osg::Image>& img, osg::Texture::FilterMode filter, int texLayer)
+  {
+    osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet();
+
+    osg::ref_ptr<osgHelper::ITextureBlueprint> blueprint = new osgHelper::TextureBlueprint(cache);
+    return blueprint->image(img)->minFilter(filter)->texLayer(texLayer)->uniform(stateSet, "tex")->build();
+  };
+
+  const auto texture = build(image, osg::Texture::LINEAR, 0);
+  EXPECT_EQ(build(image, osg::Texture::LINEAR, 1), texture);
+  EXPECT_NE(build(image, osg::Texture::NEAREST, 0), texture);
+  EXPECT_NE(build(otherImage, osg::Texture::LINEAR, 0), texture);
+
+  const auto statistics = cache->getStatistics();
+  EXPECT_EQ(statistics.numTextures, 3U);
+  EXPECT_EQ(statistics.numUniforms, 2U);
+
+  // render targets without an image are never shared
+  osg::ref_ptr<osgHelper::ITextureBlueprint> renderTarget = new osgHelper::TextureBlueprint(cache);
+  EXPECT_NE(renderTarget->build(), renderTarget->build());
+  EXPECT_EQ(cache->getStatistics().numTextures, 3U);
+
+  cache->clear();
+  EXPECT_NE(build(image, osg::Texture::LINEAR, 0), texture);
+}
+
+TEST(TextureBlueprintTest, SeparatesProcessors)
+{
+  osg::ref_ptr<osgHelper::TextureCache>     cache     = new osgHelper::TextureCache();
+  osg::ref_ptr<osgHelper::TextureProcessor> processor = new osgHelper::TextureProcessor("", 1);
+  osg::ref_ptr<osgHelper::TextureProcessor> other     = new osgHelper::TextureProcessor("", 1);
+
+  const auto image = createImage();
+
+  const auto build = [&cache, &image](const osg::ref_ptr<osgHelper::TextureProcessor>& proc,
+                                      osgHelper::TextureProcessor::MipmapFilter filter)
+  {
+    osg::ref_ptr<osgHelper::ITextureBlueprint> blueprint = new osgHelper::TextureBlueprint(cache, proc);
+    return blueprint->image(image)->mipmaps(filter)->build();
+  };
+
+  const auto unprocessed = build(nullptr, osgHelper::TextureProcessor::MipmapFilter::Box);
+  const auto processed   = build(processor, osgHelper::TextureProcessor::MipmapFilter::Box);
+
+  EXPECT_NE(processed, unprocessed);
+  EXPECT_NE(build(other, osgHelper::TextureProcessor::MipmapFilter::Box), processed);
+  EXPECT_EQ(build(processor, osgHelper::TextureProcessor::MipmapFilter::Box), processed);
+
+  // without options the processor is not used, so it does not matter
+  EXPECT_EQ(build(processor, osgHelper::TextureProcessor::MipmapFilter::None), unprocessed);
+}
+
+TEST(TextureBlueprintTest, EvictsTextures)
+{
+  osg::ref_ptr<osgHelper::TextureCache> cache = new osgHelper::TextureCache(2);
+
+  const auto build = [&cache](const osg::ref_ptr<osg::Image>& img)
+  {
+    osg::ref_ptr<osgHelper::ITextureBlueprint> blueprint = new osgHelper::TextureBlueprint(cache);
+    return blueprint->image(img)->build();
+  };
+
+  const auto image = createImage();
+  const auto used  = build(image);
+
+  std::vector<osg::ref_ptr<osg::Image>> images;
+  for (auto i = 0; i < 10; i++)
+  {
+    images.push_back(createImage());
+    build(images.back());
+  }
+
+  // unused textures are evicted first
+  auto statistics = cache->getStatistics();
+  EXPECT_EQ(statistics.numTextures, 2U);
+  EXPECT_EQ(statistics.numTextureEvictions, 9U);
+  EXPECT_EQ(build(image), used);
+
+  // all used, the least recently used one is evicted
+  const auto last = build(images.back());
+  const auto next = build(createImage());
+  EXPECT_EQ(cache->getStatistics().numTextures, 2U);
+  EXPECT_EQ(build(images.back()), last);
+  EXPECT_NE(build(image), used);
+
+  cache->setMaxNumTextures(0);
+  EXPECT_EQ(cache->getMaxNumTextures(), 0U);
+  EXPECT_EQ(cache->getStatistics().numTextures, 0U);
+}
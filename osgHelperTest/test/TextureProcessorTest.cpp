@@ -0,0 +1,497 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/GameException.h>
+#include <osgHelper/TextureBlueprint.h>
+#include <osgHelper/TextureProcessor.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <vector>
+
+namespace
+{
+
+using Pixels = std::vector<unsigned char>;
+
+osg::ref_ptr<osg::Image> createImage(int width, int height, const std::function<void(int, int, unsigned char*)>& func)
+{
+  osg::ref_ptr<osg::Image> image = new osg::Image();
+  image->allocateImage(width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+
+  for (auto y = 0; y < height; y++)
+  {
+    for (auto x = 0; x < width; x++)
+    {
+      func(x, y, image->data() + y * image->getRowStepInBytes() + x * 4);
+    }
+  }
+
+  return image;
+}
+
+osg::ref_ptr<osg::Image> createNoiseImage(int width, int height, unsigned int seed)
+{
+  std::srand(seed);
+  return createImage(width, height, [](int, int, unsigned char* pixel)
+  {
+    for (auto c = 0; c < 4; c++)
+    {
+      pixel[c] = static_cast<unsigned char>(std::rand() % 256);
+    }
+  });
+}
+
+osg::ref_ptr<osg::Image> createGradientImage(int width, int height)
+{
+  return createImage(width, height, [width, height](int x, int y, unsigned char* pixel)
+  {
+    pixel[0] = static_cast<unsigned char>(x * 255 / (width - 1));
+    pixel[1] = static_cast<unsigned char>(y * 255 / (height - 1));
+    pixel[2] = 128;
+    pixel[3] = static_cast<unsigned char>((x + y) * 255 / (width + height - 2));
+  });
+}
+
+// straightforward 2x2 average, the reference for the box filter
+Pixels downsampleReference(const Pixels& src, int width, int height, int& dstWidth, int& dstHeight)
+{
+  dstWidth  = std::max(1, width / 2);
+  dstHeight = std::max(1, height / 2);
+
+  Pixels dst(static_cast<std::size_t>(dstWidth) * dstHeight * 4);
+  for (auto y = 0; y < dstHeight; y++)
+  {
+    for (auto x = 0; x < dstWidth; x++)
+    {
+      for (auto c = 0; c < 4; c++)
+      {
+        auto sum = 0;
+        for (auto dy = 0; dy < 2; dy++)
+        {
+          for (auto dx = 0; dx < 2; dx++)
+          {
+            const auto sx = std::min(2 * x + dx, width - 1);
+            const auto sy = std::min(2 * y + dy, height - 1);
+            sum += src[(sy * width + sx) * 4 + c];
+          }
+        }
+
+        dst[(y * dstWidth + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+      }
+    }
+  }
+
+  return dst;
+}
+
+Pixels getLevel(const osg::ref_ptr<osg::Image>& image, unsigned int level, int width, int height, int bytesPerPixel)
+{
+  const auto data = image->getMipmapData(level);
+  return Pixels(data, data + width * height * bytesPerPixel);
+}
+
+void decodeColors(const unsigned char* block, bool isBC3, unsigned char (*pixels)[4])
+{
+  const auto color0  = static_cast<std::uint16_t>(block[0] | (block[1] << 8));
+  const auto color1  = static_cast<std::uint16_t>(block[2] | (block[3] << 8));
+  const auto indices = static_cast<std::uint32_t>(block[4] | (block[5] << 8) | (block[6] << 16)) |
+                       (static_cast<std::uint32_t>(block[7]) << 24);
+
+  int palette[4][4];
+  for (auto i = 0; i < 2; i++)
+  {
+    const auto color = (i == 0) ? color0 : color1;
+    palette[i][0]    = (((color >> 11) & 31) * 255 + 15) / 31;
+    palette[i][1]    = (((color >> 5) & 63) * 255 + 31) / 63;
+    palette[i][2]    = ((color & 31) * 255 + 15) / 31;
+    palette[i][3]    = 255;
+  }
+
+  for (auto c = 0; c < 4; c++)
+  {
+    if (isBC3 || (color0 > color1))
+    {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+    else
+    {
+      palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+      palette[3][c] = 0;
+    }
+  }
+
+  for (auto i = 0; i < 16; i++)
+  {
+    for (auto c = 0; c < 4; c++)
+    {
+      pixels[i][c] = static_cast<unsigned char>(palette[(indices >> (2 * i)) & 3][c]);
+    }
+  }
+}
+
+void decodeAlphas(const unsigned char* block, unsigned char (*pixels)[4])
+{
+  const int alpha0 = block[0];
+  const int alpha1 = block[1];
+
+  int palette[8] = { alpha0, alpha1 };
+  for (auto i = 1; i < 7; i++)
+  {
+    palette[i + 1] = (alpha0 > alpha1) ? ((7 - i) * alpha0 + i * alpha1) / 7
+                                       : (i < 5) ? ((5 - i) * alpha0 + i * alpha1) / 5 : (i == 5) ? 0 : 255;
+  }
+
+  std::uint64_t indices = 0;
+  for (auto i = 0; i < 6; i++)
+  {
+    indices |= static_cast<std::uint64_t>(block[2 + i]) << (8 * i);
+  }
+
+  for (auto i = 0; i < 16; i++)
+  {
+    pixels[i][3] = static_cast<unsigned char>(palette[(indices >> (3 * i)) & 7]);
+  }
+}
+
+// reference decoder of BC1 and BC3 levels into RGBA pixels
+Pixels decodeLevel(const unsigned char* data, int width, int height, bool isBC3)
+{
+  Pixels pixels(static_cast<std::size_t>(width) * height * 4);
+
+  const auto numBlocksX = (width + 3) / 4;
+  const auto blockSize  = isBC3 ? 16 : 8;
+
+  for (auto blockY = 0; blockY < (height + 3) / 4; blockY++)
+  {
+    for (auto blockX = 0; blockX < numBlocksX; blockX++)
+    {
+      const auto block = data + (blockY * numBlocksX + blockX) * blockSize;
+
+      unsigned char decoded[16][4];
+      decodeColors(isBC3 ? block + 8 : block, isBC3, decoded);
+      if (isBC3)
+      {
+        decodeAlphas(block, decoded);
+      }
+
+      for (auto i = 0; i < 16; i++)
+      {
+        const auto x = blockX * 4 + i % 4;
+        const auto y = blockY * 4 + i / 4;
+        if ((x < width) && (y < height))
+        {
+          std::copy(decoded[i], decoded[i] + 4, pixels.begin() + (y * width + x) * 4);
+        }
+      }
+    }
+  }
+
+  return pixels;
+}
+
+void getErrors(const Pixels& a, const Pixels& b, int numComponents, int& maxError, double& meanError)
+{
+  maxError  = 0;
+  meanError = 0.0;
+
+  for (std::size_t i = 0; i < a.size(); i++)
+  {
+    if (static_cast<int>(i % 4) < numComponents)
+    {
+      const auto error = std::abs(a[i] - b[i]);
+      maxError         = std::max(maxError, error);
+      meanError += error;
+    }
+  }
+
+  meanError /= (a.size() / 4) * numComponents;
+}
+
+}
+
+TEST(TextureProcessorTest, BoxMipmapsMatchReferenceDownsampler)
+{
+  osg::ref_ptr<osgHelper::TextureProcessor> processor = new osgHelper::TextureProcessor("", 4);
+
+  // odd sizes repeat the last row or column
+  const auto image  = createNoiseImage(75, 18, 1);
+  const auto result = processor->process(*image, { osgHelper::TextureProcessor::MipmapFilter::Box,
+                                                   osgHelper::TextureProcessor::Compression::None });
+
+  ASSERT_EQ(result->getNumMipmapLevels(), 7U);
+  EXPECT_EQ(result->s(), 75);
+  EXPECT_EQ(result->t(), 18);
+  EXPECT_EQ(result->getPixelFormat(), static_cast<GLenum>(GL_RGBA));
+
+  auto width     = 75;
+  auto height    = 18;
+  auto reference = getLevel(result, 0, width, height, 4);
+  EXPECT_EQ(reference, Pixels(image->data(), image->data() + reference.size()));
+
+  for (auto level = 1U; level < result->getNumMipmapLevels(); level++)
+  {
+    reference = downsampleReference(reference, width, height, width, height);
+    EXPECT_EQ(getLevel(result, level, width, height, 4), reference) << "level " << level;
+  }
+
+  EXPECT_EQ(width, 1);
+  EXPECT_EQ(height, 1);
+}
+
+TEST(TextureProcessorTest, KaiserMipmapsPreserveSmoothImages)
+{
+  osg::ref_ptr<osgHelper::TextureProcessor> processor = new osgHelper::TextureProcessor("", 4);
+
+  const auto flat = createImage(64, 32, [](int, int, unsigned char* pixel)
+  {
+    pixel[0] = 10;
+    pixel[1] = 100;
+    pixel[2] = 200;
+    pixel[3] = 255;
+  });
+
+  const auto flatResult = processor->process(*flat, { osgHelper::TextureProcessor::MipmapFilter::Kaiser,
+                                                      osgHelper::TextureProcessor::Compression::None });
+
+  ASSERT_EQ(flatResult->getNumMipmapLevels(), 7U);
+  EXPECT_EQ(getLevel(flatResult, 6, 1, 1, 4), Pixels({ 10, 100, 200, 255 }));
+
+  // a linear ramp is reproduced by both filters away from the clamped edges
+  const auto ramp = createImage(128, 8, [](int x, int, unsigned char* pixel)
+  {
+    pixel[0] = static_cast<unsigned char>(x * 2);
+    pixel[1] = pixel[2] = pixel[3] = 255;
+  });
+
+  const auto kaiser = processor->process(*ramp, { osgHelper::TextureProcessor::MipmapFilter::Kaiser,
+                                                  osgHelper::TextureProcessor::Compression::None });
+
+  int        width  = 0;
+  int        height = 0;
+  const auto box    = downsampleReference(getLevel(kaiser, 0, 128, 8, 4), 128, 8, width, height);
+  const auto level  = getLevel(kaiser, 1, width, height, 4);
+
+  for (auto x = 2; x < width - 2; x++)
+  {
+    EXPECT_NEAR(level[x * 4], box[x * 4], 1) << x;
+  }
+}
+
+TEST(TextureProcessorTest, CompressesBlocksAccurately)
+{
+  osg::ref_ptr<osgHelper::TextureProcessor> processor = new osgHelper::TextureProcessor("", 4);
+
+  const auto image     = createGradientImage(66, 38);
+  const auto reference = getLevel(image, 0, 66, 38, 4);
+
+  const auto bc1 = processor->process(*image, { osgHelper::TextureProcessor::MipmapFilter::None,
+                                                osgHelper::TextureProcessor::Compression::BC1 });
+  const auto bc3 = processor->process(*image, { osgHelper::TextureProcessor::MipmapFilter::Box,
+                                                osgHelper::TextureProcessor::Compression::BC3 });
+
+  EXPECT_EQ(bc1->getPixelFormat(), static_cast<GLenum>(GL_COMPRESSED_RGB_S3TC_DXT1_EXT));
+  EXPECT_EQ(bc1->getNumMipmapLevels(), 1U);
+  EXPECT_EQ(bc3->getPixelFormat(), static_cast<GLenum>(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT));
+  EXPECT_EQ(bc3->getNumMipmapLevels(), 7U);
+
+  // the colors of a block are interpolated along a line, the two-dimensional gradient can not be matched exactly
+  int    maxError  = 0;
+  double meanError = 0.0;
+
+  getErrors(decodeLevel(bc1->data(), 66, 38, false), reference, 3, maxError, meanError);
+  EXPECT_LE(maxError, 12);
+  EXPECT_LT(meanError, 3.5);
+
+  getErrors(decodeLevel(bc3->data(), 66, 38, true), reference, 4, maxError, meanError);
+  EXPECT_LE(maxError, 12);
+  EXPECT_LT(meanError, 3.0);
+
+  // the second level is 33x19 in 9x5 blocks of 16 bytes
+  const auto offsets = bc3->getMipmapLevels();
+  EXPECT_EQ(offsets[0], 17U * 10U * 16U);
+  EXPECT_EQ(offsets[1] - offsets[0], 9U * 5U * 16U);
+
+  // two colors per block are encoded exactly
+  const auto checker = createImage(8, 8, [](int x, int y, unsigned char* pixel)
+  {
+    const auto isRed = ((x + y) % 2) == 0;
+    pixel[0]         = isRed ? 255 : 0;
+    pixel[1]         = 0;
+    pixel[2]         = isRed ? 0 : 255;
+    pixel[3]         = isRed ? 255 : 0;
+  });
+
+  const auto checkerBC3 = processor->process(*checker, { osgHelper::TextureProcessor::MipmapFilter::None,
+                                                         osgHelper::TextureProcessor::Compression::BC3 });
+
+  EXPECT_EQ(decodeLevel(checkerBC3->data(), 8, 8, true), getLevel(checker, 0, 8, 8, 4));
+}
+
+TEST(TextureProcessorTest, CachesResultsOnDisk)
+{
+  const auto directory = (std::filesystem::temp_directory_path() / "osgHelperTest_textureCache").string();
+  std::filesystem::remove_all(directory);
+
+  const osgHelper::TextureProcessor::Options options{ osgHelper::TextureProcessor::MipmapFilter::Box,
+                                                      osgHelper::TextureProcessor::Compression::BC1 };
+
+  const auto image    = createNoiseImage(40, 24, 2);
+  const auto dataSize = (10U * 6U + 5U * 3U + 3U * 2U + 2U * 1U + 1U * 1U + 1U) * 8U;
+
+  osg::ref_ptr<osgHelper::TextureProcessor> processor = new osgHelper::TextureProcessor(directory, 2);
+  const auto processed                                = processor->process(*image, options);
+
+  osg::ref_ptr<osgHelper::TextureProcessor> other = new osgHelper::TextureProcessor(directory, 2);
+  const auto cached                               = other->process(*image, options);
+
+  EXPECT_EQ(other->getStatistics().numProcessed, 0U);
+  EXPECT_EQ(other->getStatistics().numCacheHits, 1U);
+  EXPECT_EQ(cached->getPixelFormat(), processed->getPixelFormat());
+  EXPECT_EQ(cached->getMipmapLevels(), processed->getMipmapLevels());
+  EXPECT_EQ(Pixels(cached->data(), cached->data() + dataSize), Pixels(processed->data(), processed->data() + dataSize));
+
+  // other options and other pixels are separate entries, the pixels are hashed again once the image is dirtied
+  other->process(*image, { osgHelper::TextureProcessor::MipmapFilter::Box,
+                           osgHelper::TextureProcessor::Compression::BC3 });
+  image->data()[0]++;
+  image->dirty();
+  other->process(*image, options);
+
+  EXPECT_EQ(other->getStatistics().numProcessed, 2U);
+
+  other->clearCache();
+  processor->process(*image, options);
+
+  EXPECT_EQ(processor->getStatistics().numProcessed, 2U);
+  EXPECT_EQ(processor->getStatistics().numCacheHits, 0U);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(TextureProcessorTest, RejectsCorruptCacheEntries)
+{
+  const auto directory = (std::filesystem::temp_directory_path() / "osgHelperTest_textureCacheCorrupt").string();
+  std::filesystem::remove_all(directory);
+
+  const osgHelper::TextureProcessor::Options options{ osgHelper::TextureProcessor::MipmapFilter::Box,
+                                                      osgHelper::TextureProcessor::Compression::None };
+
+  const auto image = createNoiseImage(16, 16, 4);
+
+  osg::ref_ptr<osgHelper::TextureProcessor> processor = new osgHelper::TextureProcessor(directory, 1);
+  processor->process(*image, options);
+
+  // the data size of the header, huge sizes must not be allocated
+  for (const auto& entry : std::filesystem::directory_iterator(directory))
+  {
+    std::fstream stream(entry.path(), std::ios::binary | std::ios::in | std::ios::out);
+    const std::uint64_t dataSize = 1ULL << 60;
+    stream.seekp(40);
+    stream.write(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
+  }
+
+  osg::ref_ptr<osgHelper::TextureProcessor> other = new osgHelper::TextureProcessor(directory, 1);
+  const auto result                               = other->process(*image, options);
+
+  ASSERT_TRUE(result.valid());
+  EXPECT_EQ(result->getNumMipmapLevels(), 5U);
+  EXPECT_EQ(other->getStatistics().numProcessed, 1U);
+  EXPECT_EQ(other->getStatistics().numCacheHits, 0U);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(TextureProcessorTest, ReturnsResultsThatCanNotBeCached)
+{
+  const auto directory = (std::filesystem::temp_directory_path() / "osgHelperTest_textureCacheRemoved").string();
+
+  osg::ref_ptr<osgHelper::TextureProcessor> processor = new osgHelper::TextureProcessor(directory, 1);
+  std::filesystem::remove_all(directory);
+
+  const auto image = createNoiseImage(16, 16, 3);
+
+  osg::ref_ptr<osg::Image> result;
+  EXPECT_NO_THROW(result = processor->process(*image, { osgHelper::TextureProcessor::MipmapFilter::Box,
+                                                        osgHelper::TextureProcessor::Compression::None }));
+  ASSERT_TRUE(result.valid());
+  EXPECT_EQ(result->getNumMipmapLevels(), 5U);
+  EXPECT_EQ(processor->getStatistics().numProcessed, 1U);
+}
+
+TEST(TextureProcessorTest, RejectsUnsupportedImages)
+{
+  osg::ref_ptr<osgHelper::TextureProcessor> processor = new osgHelper::TextureProcessor("", 1);
+
+  osg::ref_ptr<osg::Image> floatImage = new osg::Image();
+  floatImage->allocateImage(4, 4, 1, GL_RGBA, GL_FLOAT);
+
+  EXPECT_THROW(processor->process(*floatImage, {}), osgHelper::GameException);
+  EXPECT_THROW(processor->process(osg::Image(), {}), osgHelper::GameException);
+}
+
+TEST(TextureProcessorTest, BlueprintUsesProcessor)
+{
+  osg::ref_ptr<osgHelper::TextureProcessor> processor = new osgHelper::TextureProcessor("", 2);
+
+  const auto image = createGradientImage(64, 64);
+
+  osg::ref_ptr<osgHelper::ITextureBlueprint> blueprint = new osgHelper::TextureBlueprint(nullptr, processor);
+
+  const auto texture = blueprint->image(image)
+                         ->mipmaps(osgHelper::TextureProcessor::MipmapFilter::Box)
+                         ->compression(osgHelper::TextureProcessor::Compression::BC1)
+                         ->build();
+
+  ASSERT_NE(texture->getImage(), nullptr);
+  EXPECT_NE(texture->getImage(), image.get());
+  EXPECT_EQ(texture->getImage()->getNumMipmapLevels(), 7U);
+  EXPECT_EQ(texture->getImage()->getPixelFormat(), static_cast<GLenum>(GL_COMPRESSED_RGB_S3TC_DXT1_EXT));
+  EXPECT_FALSE(texture->getUseHardwareMipMapGeneration());
+
+  // compressed without mipmaps, the driver still generates them
+  EXPECT_TRUE(osg::ref_ptr<osgHelper::ITextureBlueprint>(new osgHelper::TextureBlueprint(nullptr, processor))
+                ->image(image)
+                ->compression(osgHelper::TextureProcessor::Compression::BC1)
+                ->build()
+                ->getUseHardwareMipMapGeneration());
+
+  // without options or without a processor the image is passed through
+  EXPECT_EQ(osg::ref_ptr<osgHelper::ITextureBlueprint>(new osgHelper::TextureBlueprint(nullptr, processor))
+              ->image(image)
+              ->build()
+              ->getImage(),
+            image.get());
+  EXPECT_EQ(osg::ref_ptr<osgHelper::ITextureBlueprint>(new osgHelper::TextureBlueprint())
+              ->image(image)
+              ->mipmaps(osgHelper::TextureProcessor::MipmapFilter::Box)
+              ->build()
+              ->getImage(),
+            image.get());
+}
+
+TEST(TextureProcessorTest, ResultsDoNotDependOnThreadCount)
+{
+  const auto image = createNoiseImage(256, 256, 3);
+
+  osg::ref_ptr<osgHelper::TextureProcessor> singleThreaded = new osgHelper::TextureProcessor("", 1);
+  osg::ref_ptr<osgHelper::TextureProcessor> multiThreaded  = new osgHelper::TextureProcessor("", 4);
+
+  for (const auto filter : { osgHelper::TextureProcessor::MipmapFilter::Box,
+                             osgHelper::TextureProcessor::MipmapFilter::Kaiser })
+  {
+    const osgHelper::TextureProcessor::Options options{ filter, osgHelper::TextureProcessor::Compression::BC3 };
+
+    const auto singleResult = singleThreaded->process(*image, options);
+    const auto multiResult  = multiThreaded->process(*image, options);
+
+    // the bands are independent, the thread count does not change the result
+    const auto dataSize = multiResult->getMipmapLevels().back() + 16;
+    EXPECT_EQ(Pixels(singleResult->data(), singleResult->data() + dataSize),
+              Pixels(multiResult->data(), multiResult->data() + dataSize));
+  }
+}
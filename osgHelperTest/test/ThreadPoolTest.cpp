@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <osgHelper/ThreadPool.h>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+TEST(ThreadPoolTest, RunsQueuedTasksOnDestruction)
+{
+  const auto numTasks = 100;
+
+  std::atomic<int>               numRun(0);
+  std::vector<std::future<void>> futures;
+
+  {
+    osgHelper::ThreadPool pool(2);
+
+    for (auto i = 0; i < numTasks; i++)
+    {
+      auto promise = std::make_shared<std::promise<void>>();
+      futures.push_back(promise->get_future());
+
+      pool.enqueue([promise, &numRun]()
+      {
+        numRun++;
+        promise->set_value();
+      }, i % 3);
+    }
+  }
+
+  EXPECT_EQ(numRun, numTasks);
+
+  for (auto& future : futures)
+  {
+    EXPECT_NO_THROW(future.get());
+  }
+}